@@ -0,0 +1,207 @@
+// Copyright (c) 2025 Environmental Systems Research Institute, Inc.
+// SPDX-License-Identifier: Apache-2.0
+
+#include <src/critical_path_tool.hpp>
+
+#include <lwyi/critical_path.hpp>
+#include <lwyi/scan_profile.hpp>
+#include <lwyi/target_graph.hpp>
+#include <lwyi/target_weights.hpp>
+#include <message/message.hpp>
+#include <target_model/target.hpp>
+#include <target_model/target_model.hpp>
+#include <util/arg_parser.hpp>
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <expected>
+#include <format>
+#include <numeric>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace
+{
+constexpr std::string_view usage_string = R"(Usage:
+  critical-path [options]
+
+Possible options:
+  -h, --help                Print this help message.
+  --weight WEIGHT           What a target costs to build, either 'sources' for
+                            the number of its sources or 'bytes' for their
+                            size. Default is 'sources'.
+  --timing FILE             Use the milliseconds each target took from FILE
+                            instead, a scan profile like the
+                            lwyi_profile.json every check writes to the
+                            build directory, of the form
+                            {"version": 1, "targets": {"name": milliseconds,
+                            ...}}. Targets that are not in FILE take no time.
+  --limit COUNT             Only list the COUNT targets with the least slack.)";
+
+struct Options
+{
+  bool help{false};
+  std::string_view weight{"sources"};
+  std::string_view timing_filename;
+  uint32_t limit{0};
+};
+
+constexpr auto parser = util::arg_parser<Options>()
+                          .arg("-h", "--help", &Options::help)
+                          .arg("--weight", &Options::weight)
+                          .arg("--timing", &Options::timing_filename)
+                          .arg("--limit", &Options::limit);
+
+// The weight of every target of the graph, where the targets outside of the model weigh nothing
+std::expected<std::vector<uint64_t>, std::string> load_weights(
+  const target_model::Target_model& target_model,
+  const lwyi::Target_graph& graph,
+  const Options& options)
+{
+  if (!options.timing_filename.empty())
+  {
+    auto timing = lwyi::Scan_profile::load(options.timing_filename);
+    if (!timing)
+    {
+      return std::unexpected(timing.error());
+    }
+    return lwyi::target_weights(target_model, graph, *timing);
+  }
+  if (options.weight == "sources")
+  {
+    return lwyi::target_weights(target_model, graph, lwyi::Target_weight::sources);
+  }
+  if (options.weight == "bytes")
+  {
+    return lwyi::target_weights(target_model, graph, lwyi::Target_weight::source_bytes);
+  }
+  return std::unexpected(std::format("Unknown weight {}.", options.weight));
+}
+
+std::string component_name(const lwyi::Target_graph& graph,
+                           const lwyi::Strongly_connected_components& components,
+                           uint32_t component)
+{
+  std::vector<std::string_view> names;
+  for (const auto member : components.members(component))
+  {
+    names.push_back(graph.target(member).name);
+  }
+  std::ranges::sort(names);
+  std::string name;
+  for (const auto member_name : names)
+  {
+    name += name.empty() ? "" : ", ";
+    name += member_name;
+  }
+  return name;
+}
+} // namespace
+
+int critical_path_tool(const target_model::Target_model& target_model,
+                       const std::vector<target_model::Target>& selected_targets,
+                       const std::vector<std::string_view>& args)
+{
+  assert(!args.empty() && args.front() == "critical-path");
+
+  auto result = parser.parse(args.begin() + 1, args.end());
+
+  if (!result.has_value())
+  {
+    message::error_block(result.error(), std::string{usage_string});
+    return 1;
+  }
+
+  const auto& options = result.value();
+
+  if (options.help)
+  {
+    message::print(usage_string);
+    return 1;
+  }
+
+  const target_model::Target_model pruned_target_model = [&]()
+  {
+    if (selected_targets.empty())
+    {
+      return target_model;
+    }
+
+    return target_model.create_pruned(selected_targets);
+  }();
+
+  const lwyi::Target_graph graph(pruned_target_model);
+  const auto weights = load_weights(pruned_target_model, graph, options);
+  if (!weights)
+  {
+    message::error_block(weights.error(), std::string{usage_string});
+    return 1;
+  }
+  const std::string_view unit = !options.timing_filename.empty() ? " ms"
+                                : options.weight == "bytes"      ? " bytes"
+                                                                 : " sources";
+
+  // the targets of a cycle are built together
+  const lwyi::Strongly_connected_components components(graph.dependencies());
+  std::vector<uint64_t> component_weights(components.size());
+  for (uint32_t v = 0; v < graph.size(); ++v)
+  {
+    component_weights[components.component(v)] += (*weights)[v];
+  }
+  const lwyi::Critical_path critical_path(components.condensation(), component_weights);
+
+  message::heading("Critical path");
+  for (const auto component : critical_path.path())
+  {
+    message::print("  {} ({}{}, starts at {})",
+                   component_name(graph, components, component),
+                   component_weights[component],
+                   unit,
+                   critical_path.earliest_start(component));
+  }
+  message::blank_line();
+  message::print("Length: {}{}", critical_path.length(), unit);
+  message::print("Total: {}{}", critical_path.total_weight(), unit);
+  if (critical_path.length() != 0)
+  {
+    message::print("Average parallelism: {:.1f}",
+                   static_cast<double>(critical_path.total_weight()) /
+                     static_cast<double>(critical_path.length()));
+  }
+  message::print("Peak parallelism: {}", critical_path.peak_parallelism());
+
+  // the targets with the least slack are the first to gain from cutting their dependencies
+  std::vector<uint32_t> targets(graph.size());
+  std::ranges::iota(targets, uint32_t{0});
+  const auto slack = [&](uint32_t v)
+  {
+    return critical_path.slack(components.component(v));
+  };
+  std::ranges::sort(targets,
+                    [&](uint32_t lhs, uint32_t rhs)
+                    {
+                      const auto lhs_slack = slack(lhs);
+                      const auto rhs_slack = slack(rhs);
+                      if (lhs_slack != rhs_slack)
+                      {
+                        return lhs_slack < rhs_slack;
+                      }
+                      return graph.target(lhs) < graph.target(rhs);
+                    });
+  if (options.limit != 0 && options.limit < targets.size())
+  {
+    targets.resize(options.limit);
+  }
+
+  message::blank_line();
+  message::heading("Slack");
+  for (const auto v : targets)
+  {
+    message::print("  {}{}  {}", slack(v), unit, graph.target(v).name);
+  }
+
+  return 0;
+}
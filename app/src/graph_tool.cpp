@@ -3,25 +3,30 @@
 
 #include <src/graph_tool.hpp>
 
-#include <lwyi/strongly_connected_dependencies.hpp>
+#include <lwyi/graph_export.hpp>
+#include <lwyi/reachability.hpp>
+#include <lwyi/target_graph.hpp>
 #include <message/message.hpp>
 #include <target_model/target.hpp>
-#include <target_model/target_data.hpp>
 #include <target_model/target_model.hpp>
 #include <util/arg_parser.hpp>
+#include <util/buffered_writer.hpp>
+#include <util/parallel.hpp>
+#include <util/parallel_transformer.hpp>
+#include <util/system_resources.hpp>
 
+#include <algorithm>
+#include <array>
 #include <cassert>
-#include <cstdio>
+#include <cstddef>
+#include <cstdint>
 #include <expected>
 #include <filesystem>
 #include <format>
-#include <functional>
-#include <memory>
-#include <optional>
-#include <print>
-#include <set>
+#include <limits>
 #include <string>
 #include <string_view>
+#include <tuple>
 #include <utility>
 #include <vector>
 
@@ -32,29 +37,250 @@ constexpr std::string_view usage_string = R"(Usage:
 
 Possible options:
   -h, --help                Print this help message.
-  -o, --output FILE         Path to the output graphviz dot file to create. An
-                            additional file for each strongly connected
-                            component will also be created based on this name.)";
+  -o, --output FILE         Path to the output file to create. For the dot
+                            format, an additional file for each strongly
+                            connected component will also be created based on
+                            this name.
+  --format FORMAT           The format of the output, one of 'dot', 'json',
+                            'graphml' or 'edgelist-binary'. Default is 'dot'.
+                            The other formats contain every dependency with its
+                            kind, interface or private, and the strongly
+                            connected component of every target, and do not
+                            support the options below.
+  --condensed               Only create the graph of the strongly connected
+                            components, without the file for each of them.
+  --reduce                  Leave out the dependencies between the strongly
+                            connected components that are implied by longer
+                            paths (transitive reduction).
+  --removed-edges FILE      With --reduce, write the dependencies that are left
+                            out to FILE as another graphviz dot file.)";
 
 struct Options
 {
   bool help{false};
   std::string_view output_filename;
+  std::string_view format{"dot"};
+  bool condensed{false};
+  bool reduce{false};
+  std::string_view removed_edges_filename;
 };
 
 constexpr auto parser = util::arg_parser<Options>()
                           .arg("-h", "--help", &Options::help)
-                          .arg("-o", "--output", &Options::output_filename);
+                          .arg("-o", "--output", &Options::output_filename)
+                          .arg("--format", &Options::format)
+                          .arg("--condensed", &Options::condensed)
+                          .arg("--reduce", &Options::reduce)
+                          .arg("--removed-edges", &Options::removed_edges_filename);
 
 std::string usage(std::string_view name)
 {
   return std::format(usage_string, name);
 }
 
-std::unique_ptr<FILE, int (*)(FILE*)> open_file(const std::filesystem::path& path,
-                                                const char* mode)
+constexpr uint32_t no_cluster = std::numeric_limits<uint32_t>::max();
+
+// The strongly connected components of the dependencies, with the non-trivial ones numbered as
+// clusters in the order they are found
+struct Clustered_graph
+{
+  explicit Clustered_graph(const target_model::Target_model& target_model)
+  : graph(target_model),
+    components(graph.dependencies()),
+    cluster_of_component(components.size(), no_cluster),
+    labels(components.size())
+  {
+    for (uint32_t component = 0; component < components.size(); ++component)
+    {
+      const auto members = components.members(component);
+      if (members.size() < 2)
+      {
+        labels[component] = graph.target(members.front()).name;
+        continue;
+      }
+      cluster_of_component[component] = static_cast<uint32_t>(clusters.size());
+      labels[component] = std::to_string(clusters.size());
+      auto& cluster = clusters.emplace_back(members.begin(), members.end());
+      std::ranges::sort(cluster,
+                        [&](uint32_t lhs, uint32_t rhs)
+                        {
+                          return graph.target(lhs) < graph.target(rhs);
+                        });
+    }
+  }
+
+  lwyi::Target_graph graph;
+  lwyi::Strongly_connected_components components;
+  std::vector<uint32_t> cluster_of_component;
+  // the targets of every cluster sorted by name
+  std::vector<std::vector<uint32_t>> clusters;
+  // the cluster number or the name of the target of every component
+  std::vector<std::string> labels;
+};
+
+using Edges = std::vector<std::pair<uint32_t, uint32_t>>;
+
+void sort_by_label(Edges& edges, const Clustered_graph& clustered)
+{
+  const auto& labels = clustered.labels;
+  std::ranges::sort(edges,
+                    [&](const auto& lhs, const auto& rhs)
+                    {
+                      return std::tie(labels[lhs.first], labels[lhs.second]) <
+                             std::tie(labels[rhs.first], labels[rhs.second]);
+                    });
+}
+
+// Appends the edges of the later components
+Edges concatenate(Edges lhs, const Edges& rhs)
+{
+  lhs.insert(lhs.end(), rhs.begin(), rhs.end());
+  return lhs;
+}
+
+// The edges of the DAG between the components sorted by label. Unless condensed, a component with
+// edges between its own targets also has an edge to itself.
+Edges component_edges(util::Parallel_transformer& pool,
+                      const Clustered_graph& clustered,
+                      const lwyi::Digraph& dag,
+                      bool condensed)
+{
+  const auto& components = clustered.components;
+  Edges edges;
+  edges.reserve(dag.edge_count());
+  edges = util::parallel_reduce(
+    pool,
+    components.size(),
+    std::move(edges),
+    [&](size_t index)
+    {
+      const auto component = static_cast<uint32_t>(index);
+      Edges edges_of_component;
+      if (!condensed)
+      {
+        const auto members = components.members(component);
+        const auto has_loop = 1 < members.size() ||
+                              std::ranges::contains(clustered.graph.dependencies().successors(
+                                                      members.front()),
+                                                    members.front());
+        if (has_loop)
+        {
+          edges_of_component.emplace_back(component, component);
+        }
+      }
+      for (const auto successor : dag.successors(component))
+      {
+        edges_of_component.emplace_back(component, successor);
+      }
+      return edges_of_component;
+    },
+    concatenate);
+  sort_by_label(edges, clustered);
+  return edges;
+}
+
+// The edges of the condensation that the transitive reduction left out, sorted by label
+Edges removed_edges(util::Parallel_transformer& pool,
+                    const Clustered_graph& clustered,
+                    const lwyi::Digraph& reduced)
+{
+  const auto& condensation = clustered.components.condensation();
+  Edges edges;
+  edges.reserve(condensation.edge_count() - reduced.edge_count());
+  edges = util::parallel_reduce(
+    pool,
+    condensation.vertex_count(),
+    std::move(edges),
+    [&](size_t index)
+    {
+      const auto component = static_cast<uint32_t>(index);
+      Edges edges_of_component;
+      // the successors that are left are in the same order
+      auto kept = reduced.successors(component);
+      for (const auto successor : condensation.successors(component))
+      {
+        if (!kept.empty() && kept.front() == successor)
+        {
+          kept = kept.subspan(1);
+        }
+        else
+        {
+          edges_of_component.emplace_back(component, successor);
+        }
+      }
+      return edges_of_component;
+    },
+    concatenate);
+  sort_by_label(edges, clustered);
+  return edges;
+}
+
+bool write_graph(const std::filesystem::path& graph_path,
+                 std::string_view name,
+                 const Clustered_graph& clustered,
+                 const Edges& edges)
+{
+  util::Buffered_writer writer(graph_path);
+  if (!writer.is_open())
+  {
+    return false;
+  }
+
+  writer.print("digraph {} {{\n", name);
+
+  // nodes for the clusters
+  for (size_t i = 0; i < clustered.clusters.size(); ++i)
+  {
+    writer.print("  {} [shape=box label=\"", i);
+    bool first = true;
+    for (const auto member : clustered.clusters[i])
+    {
+      if (first)
+      {
+        first = false;
+        writer.print("{}", clustered.graph.target(member).name);
+      }
+      else
+      {
+        writer.print("\\n{}", clustered.graph.target(member).name);
+      }
+    }
+    writer.print("\"]\n");
+  }
+
+  for (const auto& [from, to] : edges)
+  {
+    writer.print("  {} -> {};\n", clustered.labels[from], clustered.labels[to]);
+  }
+  writer.print("}}\n");
+  return writer.close();
+}
+
+bool write_cluster_graph(const std::filesystem::path& cluster_path,
+                         const Clustered_graph& clustered,
+                         size_t cluster)
 {
-  return {fopen(path.string().c_str(), mode), fclose};
+  util::Buffered_writer writer(cluster_path);
+  if (!writer.is_open())
+  {
+    return false;
+  }
+
+  const auto& graph = clustered.graph;
+  const auto component = clustered.components.component(clustered.clusters[cluster].front());
+  writer.print("digraph {} {{\n", cluster);
+  for (const auto member : clustered.clusters[cluster])
+  {
+    for (const auto dependency : graph.dependencies().successors(member))
+    {
+      if (clustered.components.component(dependency) == component)
+      {
+        writer.print("  {} -> {};\n", graph.target(member).name, graph.target(dependency).name);
+      }
+    }
+  }
+  writer.print("}}\n");
+  return writer.close();
 }
 } // namespace
 
@@ -86,6 +312,29 @@ int graph_tool(const target_model::Target_model& target_model,
     return 1;
   }
 
+  constexpr std::array export_formats{
+    std::string_view("json"), std::string_view("graphml"), std::string_view("edgelist-binary")};
+  const auto is_export = std::ranges::contains(export_formats, options.format);
+  if (!is_export && options.format != "dot")
+  {
+    message::error_block(std::format("Unknown format {}.", options.format), usage("graph"));
+    return 1;
+  }
+
+  if (is_export && (options.condensed || options.reduce))
+  {
+    message::error_block(std::format("The {} format does not support --condensed or --reduce.",
+                                     options.format),
+                         usage("graph"));
+    return 1;
+  }
+
+  if (!options.removed_edges_filename.empty() && !options.reduce)
+  {
+    message::error_block("--removed-edges requires --reduce.", usage("graph"));
+    return 1;
+  }
+
   const auto output_path = std::filesystem::path(options.output_filename);
   const auto path = output_path.parent_path();
   const auto stem = output_path.stem();
@@ -101,101 +350,74 @@ int graph_tool(const target_model::Target_model& target_model,
     return target_model.create_pruned(selected_targets);
   }();
 
-  const auto components = lwyi::compute_strongly_connected_dependencies(pruned_target_model);
-
-  auto map_to_component = [&components](const target_model::Target& target) -> std::string
+  if (is_export)
   {
-    for (size_t i = 0; i < components.size(); ++i)
+    const lwyi::Target_graph graph(pruned_target_model);
+    const lwyi::Strongly_connected_components components(graph.dependencies());
+    const lwyi::Graph_export graph_export(pruned_target_model, graph, components);
+    const auto written = options.format == "json"      ? graph_export.write_json(output_path)
+                         : options.format == "graphml" ? graph_export.write_graphml(output_path)
+                                                       : graph_export.write_edge_list(output_path);
+    if (!written)
     {
-      const auto& comp = components[i];
-      if (0 < comp.count(target))
-      {
-        return std::to_string(i);
-      }
+      message::error("Failed to write file {}", output_path.string());
+      return 1;
     }
+    return 0;
+  }
 
-    return target.name;
-  };
-
-  std::set<std::pair<std::string, std::string>> edges;
-  pruned_target_model.for_each_target(
-    [&](const target_model::Target& target, const target_model::Target_data& target_data)
-    {
-      const auto component = map_to_component(target);
-      for (const auto& dep : target_data.dependencies)
-      {
-        edges.insert({component, map_to_component(dep)});
-      }
-    });
+  util::Parallel_transformer pool(util::default_thread_count());
+  const Clustered_graph clustered(pruned_target_model);
+  const auto reduced = options.reduce
+                         ? lwyi::transitive_reduction(clustered.components.condensation())
+                         : lwyi::Digraph();
+  const auto& dag = options.reduce ? reduced : clustered.components.condensation();
 
   // full graph with non-trivial strongly connected components clumped into a single node
+  const auto graph_path = path / (stem.string() + extension.string());
+  if (!write_graph(graph_path,
+                   "dependencies",
+                   clustered,
+                   component_edges(pool, clustered, dag, options.condensed)))
   {
-    const auto graph_path = path / (stem.string() + extension.string());
-    auto file = open_file(graph_path.string().c_str(), "w");
-    if (!file)
-    {
-      message::error("Failed to open file {}", graph_path.string());
-      return 1;
-    }
-
-    std::print(file.get(), "digraph dependencies {{\n");
+    message::error("Failed to write file {}", graph_path.string());
+    return 1;
+  }
 
-    // nodes for the clusters
-    for (size_t i = 0; i < components.size(); ++i)
+  if (!options.removed_edges_filename.empty())
+  {
+    const auto removed_path = std::filesystem::path(options.removed_edges_filename);
+    if (!write_graph(removed_path, "removed", clustered, removed_edges(pool, clustered, reduced)))
     {
-      const auto& comp = components[i];
-      std::print(file.get(), "  {} [shape=box label=\"", i);
-      bool first = true;
-      for (const auto& target : comp)
-      {
-        if (first)
-        {
-          first = false;
-          std::print(file.get(), "{}", target.name);
-        }
-        else
-        {
-          std::print(file.get(), "\\n{}", target.name);
-        }
-      }
-      std::print(file.get(), "\"]\n");
+      message::error("Failed to write file {}", removed_path.string());
+      return 1;
     }
+  }
 
-    for (const auto& edge : edges)
-    {
-      std::print(file.get(), "  {} -> {};\n", edge.first, edge.second);
-    }
-    std::print(file.get(), "}}\n");
+  if (options.condensed)
+  {
+    return 0;
   }
 
   // individual graphs for each strongly connected component
-  for (size_t i = 0; i < components.size(); ++i)
+  const auto cluster_path = [&](size_t cluster)
   {
-    const auto& component = components[i];
-    const auto component_path =
-      path / (stem.string() + "_scc_" + std::to_string(i) + extension.string());
-    auto file = open_file(component_path.string().c_str(), "w");
-    if (!file)
-    {
-      message::error("Failed to open file {}", component_path.string());
-      return 1;
-    }
-
-    std::print(file.get(), "digraph {} {{\n", i);
-    for (const auto& target : component)
-    {
-      if (auto target_data = pruned_target_model.get_target_data(target))
-      {
-        for (const auto& dep : target_data->get().dependencies)
-        {
-          if (0 < component.count(dep))
-          {
-            std::print(file.get(), "  {} -> {};\n", target.name, dep.name);
-          }
-        }
-      }
-    }
-    std::print(file.get(), "}}\n");
+    return path / (stem.string() + "_scc_" + std::to_string(cluster) + extension.string());
+  };
+  std::vector<char> written(clustered.clusters.size());
+  util::parallel_for(pool,
+                     clustered.clusters.size(),
+                     [&](size_t cluster)
+                     {
+                       written[cluster] =
+                         write_cluster_graph(cluster_path(cluster), clustered, cluster) ? 1 : 0;
+                     });
+  const auto failed = std::ranges::find(written, 0);
+  if (failed != written.end())
+  {
+    message::error("Failed to write file {}",
+                   cluster_path(static_cast<size_t>(failed - written.begin())).string());
+    return 1;
   }
 
   return 0;
@@ -0,0 +1,191 @@
+// Copyright (c) 2025 Environmental Systems Research Institute, Inc.
+// SPDX-License-Identifier: Apache-2.0
+
+#include <src/impact_tool.hpp>
+
+#include <lwyi/reachability.hpp>
+#include <lwyi/session.hpp>
+#include <lwyi/target_graph.hpp>
+#include <message/message.hpp>
+#include <target_model/target.hpp>
+#include <target_model/target_data.hpp>
+#include <target_model/target_model.hpp>
+#include <util/arg_parser.hpp>
+
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <expected>
+#include <filesystem>
+#include <format>
+#include <ranges>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace
+{
+constexpr std::string_view usage_string = R"(Usage:
+  impact [options]
+
+Print every target that depends on the changed targets, directly or through
+other targets, and the changed targets themselves, one per line.
+
+Possible options:
+  -h, --help                Print this help message.
+  --changed-targets TARGETS Comma separated list of the changed targets.
+  --changed-files FILE      Read the modified files from FILE, one path per
+                            line. Relative paths are relative to the root of
+                            the repository, like the output of
+                            git diff --name-only. A file is changed in the
+                            targets that have it as a source or header, or
+                            otherwise in the target whose interface includes
+                            it. A file that no target owns is an error, since
+                            the targets it affects are unknown.)";
+
+struct Options
+{
+  bool help{false};
+  std::string_view changed_targets;
+  std::string_view changed_files;
+};
+
+constexpr auto parser = util::arg_parser<Options>()
+                          .arg("-h", "--help", &Options::help)
+                          .arg("--changed-targets", &Options::changed_targets)
+                          .arg("--changed-files", &Options::changed_files);
+
+// The targets that own the files, or the files without an owner
+std::expected<std::vector<target_model::Target>, std::string> owners_of(
+  const target_model::Target_model& target_model,
+  const std::vector<std::filesystem::path>& files)
+{
+  std::unordered_map<std::filesystem::path, std::vector<target_model::Target>> owners;
+  target_model.for_each_target(
+    [&](const target_model::Target& target, const target_model::Target_data& target_data)
+    {
+      for (const auto& source : target_data.sources)
+      {
+        owners[source].push_back(target);
+      }
+      for (const auto& header : target_data.headers)
+      {
+        owners[header].push_back(target);
+      }
+    });
+
+  std::vector<target_model::Target> targets;
+  std::string unowned;
+  for (const auto& file : files)
+  {
+    if (const auto it = owners.find(file); it != owners.end())
+    {
+      targets.insert(targets.end(), it->second.begin(), it->second.end());
+    }
+    else if (auto target = target_model.map_header_to_target(file))
+    {
+      targets.push_back(std::move(*target));
+    }
+    else
+    {
+      unowned += std::format("{}{}", unowned.empty() ? "" : ", ", file.string());
+    }
+  }
+  if (!unowned.empty())
+  {
+    return std::unexpected(std::format("No target owns {}", unowned));
+  }
+  return targets;
+}
+} // namespace
+
+int impact_tool(const std::filesystem::path& binary_dir,
+                const target_model::Target_model& target_model,
+                const std::vector<target_model::Target>& /*selected_targets*/,
+                const std::vector<std::string_view>& args)
+{
+  assert(!args.empty() && args.front() == "impact");
+
+  auto result = parser.parse(args.begin() + 1, args.end());
+
+  if (!result.has_value())
+  {
+    message::error_block(result.error(), std::string{usage_string});
+    return 1;
+  }
+
+  const auto& options = result.value();
+
+  if (options.help)
+  {
+    message::print(usage_string);
+    return 1;
+  }
+
+  if (options.changed_targets.empty() && options.changed_files.empty())
+  {
+    message::error_block("Changed targets or files are required.", std::string{usage_string});
+    return 1;
+  }
+
+  std::vector<target_model::Target> changed;
+  for (const auto item : std::views::split(options.changed_targets, ','))
+  {
+    if (!item.empty())
+    {
+      changed.push_back({std::string(item.begin(), item.end())});
+    }
+  }
+  if (!options.changed_files.empty())
+  {
+    const auto working_dir = std::filesystem::current_path();
+    const auto files = lwyi::read_changed_files(
+      working_dir / options.changed_files, working_dir / binary_dir, working_dir);
+    if (!files)
+    {
+      message::error(files.error());
+      return 1;
+    }
+    const auto owners = owners_of(target_model, *files);
+    if (!owners)
+    {
+      message::error(owners.error());
+      return 1;
+    }
+    changed.insert(changed.end(), owners->begin(), owners->end());
+  }
+
+  // the dependents are the targets reached over the reversed dependencies
+  const lwyi::Target_graph graph(target_model);
+  const auto dependents = graph.dependencies().reversed();
+  std::vector<uint32_t> starts;
+  for (const auto& target : changed)
+  {
+    const auto id = graph.find(target);
+    if (!id)
+    {
+      message::error("Unknown target {}", target.name);
+      return 1;
+    }
+    starts.push_back(*id);
+  }
+  const auto impacted = lwyi::reached_from(dependents, starts);
+
+  std::vector<std::string_view> names;
+  for (uint32_t v = 0; v < graph.size(); ++v)
+  {
+    if ((impacted[v / 64] >> (v % 64) & 1U) != 0)
+    {
+      names.push_back(graph.target(v).name);
+    }
+  }
+  std::ranges::sort(names);
+  for (const auto name : names)
+  {
+    message::print(name);
+  }
+
+  return 0;
+}
@@ -3,10 +3,13 @@
 
 #include <cli/parse_arguments.hpp>
 #include <message/message.hpp>
+#include <scanner/scan.hpp>
 #include <src/run_lwyi.hpp>
+#include <src/serve.hpp>
 
 #include <expected>
 #include <string>
+#include <string_view>
 
 std::expected<int, std::string> print_error(const std::string& error)
 {
@@ -16,10 +19,21 @@ std::expected<int, std::string> print_error(const std::string& error)
 
 int main(int argc, const char* argv[])
 {
+  // a process started by --process-isolation
+  // NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+  if (argc == 2 && std::string_view(argv[1]) == scanner::scan_process_argument)
+  {
+    return scanner::run_scan_process();
+  }
+
   auto options = cli::parse_arguments(argc, argv);
   if (options.has_value())
   {
     message::configure(options->color_output, options->message_level);
+    if (!options->connect.empty())
+    {
+      return run_client(options->connect, argc, argv).or_else(print_error).value_or(1);
+    }
     return run_lwyi(*options).or_else(print_error).value_or(1);
   }
 
@@ -0,0 +1,177 @@
+// Copyright (c) 2025 Environmental Systems Research Institute, Inc.
+// SPDX-License-Identifier: Apache-2.0
+
+#include <src/merge_results_tool.hpp>
+
+#include <lwyi/result_file.hpp>
+#include <lwyi/scan_profile.hpp>
+#include <lwyi/session.hpp>
+#include <message/message.hpp>
+#include <src/report_target_result.hpp>
+#include <target_model/target.hpp>
+#include <util/arg_parser.hpp>
+
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <format>
+#include <set>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace
+{
+constexpr std::string_view usage_string = R"(Usage:
+  {0} [options]
+
+Possible options:
+  -h, --help                Print this help message.
+  -i, --input FILES...      The files written by --results of every shard.
+  --profile FILE            Write the duration of every checked target to FILE,
+                            to balance the shards of later runs with --profile.)";
+
+struct Options
+{
+  bool help{false};
+  std::vector<std::string_view> inputs;
+  std::string_view profile;
+};
+
+constexpr auto parser = util::arg_parser<Options>()
+                          .arg("-h", "--help", &Options::help)
+                          .arg("-i", "--input", &Options::inputs)
+                          .arg("--profile", &Options::profile);
+
+std::string usage(std::string_view name)
+{
+  return std::format(usage_string, name);
+}
+} // namespace
+
+int merge_results_tool(const std::vector<std::string_view>& args)
+{
+  assert(!args.empty() && args.front() == "merge-results");
+
+  auto parsed = parser.parse(args.begin() + 1, args.end());
+  if (!parsed.has_value())
+  {
+    message::error_block(parsed.error(), usage("merge-results"));
+    return 1;
+  }
+
+  const auto& options = parsed.value();
+
+  if (options.help)
+  {
+    message::print(usage("merge-results"));
+    return 1;
+  }
+
+  if (options.inputs.empty())
+  {
+    message::error_block("No result files given", usage("merge-results"));
+    return 1;
+  }
+
+  std::vector<lwyi::Shard_result> shard_results;
+  for (auto input : options.inputs)
+  {
+    auto shard_result = lwyi::read_result_file(input);
+    if (!shard_result.has_value())
+    {
+      message::error("{}", shard_result.error());
+      return 1;
+    }
+    shard_results.push_back(std::move(*shard_result));
+  }
+
+  // report in the order of the shards, independent of the order of the files
+  std::ranges::stable_sort(shard_results,
+                           [](const lwyi::Shard_result& lhs, const lwyi::Shard_result& rhs)
+                           { return lhs.shard.index < rhs.shard.index; });
+
+  bool complete = true;
+  const auto shard_count = shard_results.front().shard.count;
+  std::set<uint32_t> merged_shards;
+  for (const auto& shard_result : shard_results)
+  {
+    if (shard_result.shard.count != shard_count)
+    {
+      message::error("Cannot merge shard {}/{} with shards of {}",
+                     shard_result.shard.index,
+                     shard_result.shard.count,
+                     shard_count);
+      return 1;
+    }
+    if (!merged_shards.insert(shard_result.shard.index).second)
+    {
+      message::warning("Ignoring duplicate results of shard {}/{}",
+                       shard_result.shard.index,
+                       shard_count);
+    }
+  }
+  for (uint32_t index = 1; index <= shard_count; ++index)
+  {
+    if (!merged_shards.contains(index))
+    {
+      message::error("Missing results of shard {}/{}", index, shard_count);
+      complete = false;
+    }
+  }
+
+  message::heading("Merging results of {} shard{}",
+                   merged_shards.size(),
+                   merged_shards.size() == 1 ? "" : "s");
+  message::blank_line();
+
+  lwyi::Check_result merged;
+  std::set<target_model::Target> checked_targets;
+  uint32_t previous_index = 0;
+  for (auto& shard_result : shard_results)
+  {
+    if (shard_result.shard.index == previous_index)
+    {
+      continue;
+    }
+    previous_index = shard_result.shard.index;
+
+    for (auto& target_result : shard_result.result.targets)
+    {
+      if (!checked_targets.insert(target_result.target).second)
+      {
+        message::warning("{} was checked by more than one shard", target_result.target.name);
+        continue;
+      }
+      merged.targets.push_back(std::move(target_result));
+    }
+  }
+
+  // the report reads the same as an unsharded check of all targets, whichever shard checked them
+  std::ranges::sort(merged.targets,
+                    [](const lwyi::Target_result& lhs, const lwyi::Target_result& rhs)
+                    { return lhs.target < rhs.target; });
+  for (const auto& target_result : merged.targets)
+  {
+    if (&target_result != &merged.targets.front())
+    {
+      message::blank_line();
+    }
+    message::heading("Target: {}", target_result.target.name);
+    report_target_result(target_result);
+  }
+
+  if (!options.profile.empty())
+  {
+    lwyi::Scan_profile profile;
+    profile.record(merged);
+    if (auto saved = profile.save(options.profile); !saved.has_value())
+    {
+      message::error("Failed to save scan profile: {}", saved.error());
+      return 1;
+    }
+  }
+
+  return (complete && merged.success()) ? 0 : 1;
+}
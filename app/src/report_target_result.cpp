@@ -1,23 +1,19 @@
 // Copyright (c) 2025 Environmental Systems Research Institute, Inc.
 // SPDX-License-Identifier: Apache-2.0
 
-#include <src/run_lwyi_on_target.hpp>
+#include <src/report_target_result.hpp>
 
 #include <lwyi/check_target.hpp>
 #include <lwyi/dependency_visibility.hpp>
+#include <lwyi/session.hpp>
 #include <message/message.hpp>
 #include <scanner/include.hpp>
-#include <scanner/scan.hpp>
 #include <target_model/target.hpp>
-#include <target_model/target_data.hpp>
 
-#include <filesystem>
 #include <format>
 #include <ranges>
 #include <string>
 #include <string_view>
-#include <unordered_set>
-#include <vector>
 
 namespace
 {
@@ -57,56 +53,37 @@ std::string_view describe_included_visibility(lwyi::Dependency_visibility visibi
 }
 } // namespace
 
-bool run_lwyi_on_target(const target_model::Target_model& target_model,
-                        const std::filesystem::path& binary_dir,
-                        const target_model::Target& target,
-                        const target_model::Target_data& target_data,
-                        unsigned int num_threads)
+void report_target_result(const lwyi::Target_result& result)
 {
-  static scanner::Scanner scanner(num_threads);
-  if (target_data.sources.empty() && target_data.verify_interface_header_sets_sources.empty())
+  switch (result.status)
   {
-    message::note("No sources to scan. Skipping target.");
-    return true;
+    case lwyi::Target_result::Status::no_sources:
+      message::note("No sources to scan. Skipping target.");
+      return;
+    case lwyi::Target_result::Status::unknown_target:
+      message::error("No target named {} found", result.target.name);
+      return;
+    case lwyi::Target_result::Status::scan_failed:
+      message::error_block(
+        std::format("Failed to scan direct includes for {}", result.target.name),
+        result.scan_error);
+      return;
+    case lwyi::Target_result::Status::checked:
+      break;
   }
 
-  auto eincludes = scanner.scan(binary_dir, target_data);
-  if (!eincludes.has_value())
-  {
-    message::error_block(std::format("Failed to scan direct includes for {}", target.name),
-                         eincludes.error());
-    return false;
-  }
-
-  auto errors = lwyi::check_target(target_model, target, target_data, *eincludes);
-
-  // TODO: consider enabling the following with a command line option
-#if 0
-  // special case: ignore linked PUBLIC but included INTERFACE errors
-  errors.erase(std::remove_if(errors.begin(),
-                              errors.end(),
-                              [](const lwyi::LWYI_error& error)
-                              {
-                                return error.linked_visibility ==
-                                         lwyi::Dependency_visibility::public_scope &&
-                                       error.included_visibility ==
-                                         lwyi::Dependency_visibility::interface_scope;
-                              }),
-               errors.end());
-#endif
-
-  if (errors.empty())
+  if (result.errors.empty())
   {
     message::status("ok",
                     "All included dependencies are linked correctly.",
                     message::Style::success);
-    return true;
+    return;
   }
 
-  for (const auto& error : errors)
+  for (const auto& error : result.errors)
   {
     message::error("{} {} but it is {}.",
-                   target.name,
+                   result.target.name,
                    describe_linked_visibility(error.linked_visibility, error.target.name),
                    describe_included_visibility(error.included_visibility));
 
@@ -119,6 +96,4 @@ bool run_lwyi_on_target(const target_model::Target_model& target_model,
       }
     }
   }
-
-  return false;
 }
@@ -0,0 +1,11 @@
+// Copyright (c) 2025 Environmental Systems Research Institute, Inc.
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+
+namespace lwyi
+{
+struct Target_result;
+} // namespace lwyi
+
+void report_target_result(const lwyi::Target_result& result);
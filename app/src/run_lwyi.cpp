@@ -4,126 +4,458 @@
 #include <src/run_lwyi.hpp>
 
 #include <cli/command_options.hpp>
+#include <lwyi/result_file.hpp>
+#include <lwyi/scan_profile.hpp>
+#include <lwyi/session.hpp>
+#include <lwyi/shard.hpp>
 #include <message/message.hpp>
-#include <src/run_lwyi_on_target.hpp>
+#include <scanner/distributed_scan.hpp>
+#include <src/merge_results_tool.hpp>
+#include <src/report_target_result.hpp>
 #include <src/run_tool.hpp>
+#include <src/serve.hpp>
 #include <target_model/target.hpp>
+#include <target_model/target_data.hpp>
 #include <target_model/target_model.hpp>
-#include <target_model/target_model_loader.hpp>
+#include <util/system_resources.hpp>
 
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
 #include <expected>
 #include <filesystem>
 #include <format>
-#include <functional>
-#include <memory>
 #include <optional>
 #include <string>
 #include <string_view>
-#include <thread>
+#include <utility>
 #include <vector>
 
-namespace target_model
+namespace
 {
-struct Target_data;
-} // namespace target_model
+std::filesystem::path to_normal_path(const std::filesystem::path& working_dir,
+                                     const std::filesystem::path& path)
+{
+  return (working_dir / path).lexically_normal().generic_string();
+}
 
-std::expected<int, std::string> run_lwyi(const cli::Command_options& options)
+std::expected<std::vector<std::filesystem::path>, std::string> collect_changed_files(
+  const cli::Command_options& options,
+  const std::filesystem::path& working_dir,
+  const std::filesystem::path& binary_dir)
 {
-  auto working_dir = std::filesystem::current_path();
-  auto binary_dir = working_dir;
-  if (!options.binary_dir.empty())
+  std::vector<std::filesystem::path> changed_files;
+  for (auto source : options.sources)
   {
-    binary_dir = options.binary_dir;
-    if (!std::filesystem::is_directory(binary_dir))
-    {
-      return std::unexpected(
-        std::format("error: {} is not a directory", binary_dir.string()));
-    }
+    changed_files.push_back(to_normal_path(working_dir, source));
   }
 
-  const auto info_file = binary_dir / "link_what_you_include_info.json";
-  message::heading("Build System");
-  if (!std::filesystem::is_regular_file(info_file))
+  if (!options.changed_files.empty())
   {
-    return std::unexpected(std::format("error: {} is not a file", info_file.string()));
+    auto listed = lwyi::read_changed_files(
+      working_dir / options.changed_files, working_dir / binary_dir, working_dir);
+    if (!listed.has_value())
+    {
+      return std::unexpected(std::format("error: {}", listed.error()));
+    }
+    changed_files.insert(changed_files.end(), listed->begin(), listed->end());
   }
 
-  message::info("Loading metadata from {}", info_file.string());
+  return changed_files;
+}
 
-  auto loader = target_model::Target_model_loader::create();
-  const auto load_result = loader->load_json(info_file);
-  if (!load_result.has_value())
+// Warn about the changed files that no recorded source read and no target has as a source,
+// which usually means they were not resolved to the right paths
+void warn_unknown_changed_files(const lwyi::Session& session,
+                                const std::vector<std::filesystem::path>& changed_files)
+{
+  auto known_files = session.recorded_files();
+  session.target_model().for_each_target(
+    [&](const target_model::Target& /*target*/, const target_model::Target_data& target_data)
+    {
+      known_files.insert(target_data.sources.begin(), target_data.sources.end());
+      known_files.insert(target_data.headers.begin(), target_data.headers.end());
+    });
+  for (const auto& file : changed_files)
   {
-    return std::unexpected(
-      std::format("error: failed to load {}: {}", info_file.string(), load_result.error()));
+    if (!known_files.contains(file))
+    {
+      message::warning("Modified file {} is not used by any source or target", file.string());
+    }
   }
-  const auto target_model = loader->make_target_model();
+}
 
+std::vector<target_model::Target> get_selected_targets(const cli::Command_options& options)
+{
   std::vector<target_model::Target> selected_targets;
   selected_targets.reserve(options.targets.size());
   for (auto v : options.targets)
   {
     selected_targets.push_back({std::string(v)});
   }
+  return selected_targets;
+}
 
-  if (!options.tool_command.empty())
+std::expected<std::vector<target_model::Target>, std::string> select_shard(
+  const lwyi::Session& session,
+  const std::filesystem::path& working_dir,
+  const cli::Command_options& options,
+  const std::vector<target_model::Target>& selected_targets)
+{
+  const auto shard = lwyi::parse_shard(options.shard);
+  if (!shard.has_value())
   {
-    return run_tool(target_model, selected_targets, options.tool_command);
+    return std::unexpected(std::format("error: {}", shard.error()));
   }
 
-  const auto num_threads = (0U < options.num_threads) ? options.num_threads
-                                                      : std::thread::hardware_concurrency();
-  message::info("Scanning with {} thread{}", num_threads, num_threads == 1 ? "" : "s");
-  message::blank_line();
+  // the profile of the build directory differs between machines, only an explicit profile
+  // gives every shard the same split
+  lwyi::Scan_profile profile;
+  if (!options.profile.empty())
+  {
+    auto loaded = lwyi::Scan_profile::load(working_dir / options.profile);
+    if (!loaded.has_value())
+    {
+      return std::unexpected(std::format("error: {}", loaded.error()));
+    }
+    profile = std::move(*loaded);
+  }
 
-  bool success = true;
-  bool first_target = true;
-  if (selected_targets.empty())
+  auto shard_targets =
+    lwyi::select_shard(session.target_model(), selected_targets, profile, *shard);
+  message::info("Shard {}/{} checks {} target{}",
+                shard->index,
+                shard->count,
+                shard_targets.size(),
+                shard_targets.size() == 1 ? "" : "s");
+  return shard_targets;
+}
+
+// Let the workers preprocess the sources, so the check only has to classify their includes
+std::expected<void, std::string> scan_on_workers(lwyi::Session& session,
+                                                 const cli::Command_options& options,
+                                                 const std::vector<target_model::Target>& targets)
+{
+  // a worker fails a source after the timeout, so a batch should be answered soon after
+  scanner::Coordinator_timeouts timeouts;
+  if (options.tu_timeout != 0)
   {
-    target_model.for_each_target(
-      [&](const target_model::Target& target, const target_model::Target_data& target_data)
-      {
-        if (!first_target)
-        {
-          message::blank_line();
-        }
-        first_target = false;
+    timeouts.batch = std::chrono::seconds(options.tu_timeout) + std::chrono::minutes(1);
+  }
+  auto coordinator = scanner::Scan_coordinator::listen(options.coordinator, timeouts);
+  if (!coordinator.has_value())
+  {
+    return std::unexpected(coordinator.error());
+  }
+
+  message::info("Waiting for workers on {}", coordinator->address());
+  const auto start = std::chrono::steady_clock::now();
+  auto scanned = session.scan_on_workers(targets, *coordinator);
+  if (!scanned.has_value())
+  {
+    return std::unexpected(scanned.error());
+  }
+
+  const auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
+    std::chrono::steady_clock::now() - start);
+  message::info("Workers preprocessed {} source{} in {} ms",
+                *scanned,
+                *scanned == 1 ? "" : "s",
+                elapsed.count());
+  return {};
+}
+
+std::expected<int, std::string> run_worker(std::string_view address,
+                                           size_t thread_count,
+                                           std::chrono::milliseconds tu_timeout)
+{
+  message::info("Preprocessing sources for {} with {} thread{}",
+                address,
+                thread_count,
+                thread_count == 1 ? "" : "s");
+  auto scanned = scanner::run_scan_worker(address, thread_count, tu_timeout);
+  if (!scanned.has_value())
+  {
+    return std::unexpected(scanned.error());
+  }
+
+  message::status("ok",
+                  std::format("Preprocessed {} source{}", *scanned, *scanned == 1 ? "" : "s"),
+                  message::Style::success);
+  return 0;
+}
+
+// Remember how long each target took, to balance the shards of later runs
+void update_profile(const lwyi::Session& session, const lwyi::Check_result& result)
+{
+  if (result.targets.empty())
+  {
+    return;
+  }
+
+  const auto path = session.binary_dir() / "lwyi_profile.json";
+  lwyi::Scan_profile profile;
+  if (std::filesystem::exists(path))
+  {
+    auto loaded = lwyi::Scan_profile::load(path);
+    if (!loaded.has_value())
+    {
+      message::warning("Replacing scan profile: {}", loaded.error());
+    }
+    else
+    {
+      profile = std::move(*loaded);
+    }
+  }
 
-        message::heading("Target: {}", target.name);
+  profile.record(result);
+  if (auto saved = profile.save(path); !saved.has_value())
+  {
+    message::warning("Failed to save scan profile: {}", saved.error());
+  }
+}
 
-        success &=
-          run_lwyi_on_target(target_model, binary_dir, target, target_data, num_threads);
-      });
+// The explicit limit, else most of the limit of the cgroup. The rest is left for the target
+// model, the page cache and memory the allocator has not given back yet.
+uint64_t memory_limit(const cli::Command_options& options)
+{
+  constexpr uint64_t mebibyte = 1024U * 1024U;
+  if (options.memory_limit > 0)
+  {
+    return uint64_t{options.memory_limit} * mebibyte;
   }
-  else
+  const auto cgroup_limit = util::cgroup_memory_limit();
+  return cgroup_limit ? *cgroup_limit / 10U * 9U : 0U;
+}
+
+// Record the result and turn it into the exit code
+std::expected<int, std::string> finish_check(const lwyi::Session& session,
+                                             const std::filesystem::path& working_dir,
+                                             const cli::Command_options& options,
+                                             const lwyi::Check_result& result)
+{
+  update_profile(session, result);
+
+  if (!options.results.empty())
   {
-    for (const auto& target : selected_targets)
+    lwyi::Shard_result shard_result{lwyi::Shard{}, result};
+    if (!options.shard.empty())
     {
-      if (!first_target)
+      shard_result.shard = *lwyi::parse_shard(options.shard);
+    }
+
+    if (auto written = lwyi::write_result_file(working_dir / options.results, shard_result);
+        !written.has_value())
+    {
+      return std::unexpected(std::format("error: {}", written.error()));
+    }
+  }
+
+  return result.success() ? 0 : 1;
+}
+
+void announce_metadata(const std::filesystem::path& binary_dir)
+{
+  message::heading("Build System");
+  message::info("Loading metadata from {}",
+                (binary_dir / "link_what_you_include_info.json").string());
+}
+} // namespace
+
+std::expected<lwyi::Session, std::string> open_session(const std::filesystem::path& binary_dir,
+                                                       size_t thread_count)
+{
+  announce_metadata(binary_dir);
+  return lwyi::Session::open(binary_dir, thread_count);
+}
+
+std::expected<int, std::string> check_targets(lwyi::Session& session,
+                                              const std::filesystem::path& working_dir,
+                                              const cli::Command_options& options)
+{
+  auto selected_targets = get_selected_targets(options);
+
+  session.force_rescan(options.rescan);
+  session.use_process_isolation(options.process_isolation);
+  session.set_fail_fast(options.fail_fast);
+  session.set_tu_timeout(std::chrono::seconds(options.tu_timeout));
+  const auto memory_limit_bytes = memory_limit(options);
+  session.set_memory_limit(memory_limit_bytes);
+
+  const auto changed_files = collect_changed_files(options, working_dir, session.binary_dir());
+  if (!changed_files.has_value())
+  {
+    return std::unexpected(changed_files.error());
+  }
+
+  if (!changed_files->empty())
+  {
+    auto affected_targets = session.affected_targets(*changed_files);
+    if (!affected_targets.has_value())
+    {
+      message::warning("No recorded include graphs found in {}. Checking all selected targets.",
+                       session.binary_dir().string());
+    }
+    else
+    {
+      warn_unknown_changed_files(session, *changed_files);
+      if (!selected_targets.empty())
       {
-        message::blank_line();
+        std::erase_if(*affected_targets,
+                      [&](const target_model::Target& target)
+                      {
+                        return !std::ranges::contains(selected_targets, target);
+                      });
       }
-      first_target = false;
-
-      message::heading("Target: {}", target.name);
 
-      auto otarget_data = target_model.get_target_data(target);
-      if (!otarget_data.has_value())
+      message::info("{} modified file{} affect{} {} target{}",
+                    changed_files->size(),
+                    changed_files->size() == 1 ? "" : "s",
+                    changed_files->size() == 1 ? "s" : "",
+                    affected_targets->size(),
+                    affected_targets->size() == 1 ? "" : "s");
+      if (affected_targets->empty())
       {
-        message::error("No target named {} found", target.name);
-        success = false;
-        break;
+        message::status("ok", "No targets need to be checked.", message::Style::success);
+        return finish_check(session, working_dir, options, {});
       }
 
-      success &=
-        run_lwyi_on_target(target_model, binary_dir, target, *otarget_data, num_threads);
+      selected_targets = std::move(*affected_targets);
     }
   }
 
-  if (!success)
+  if (!options.shard.empty())
   {
-    return 1;
+    auto shard_targets = select_shard(session, working_dir, options, selected_targets);
+    if (!shard_targets.has_value())
+    {
+      return std::unexpected(shard_targets.error());
+    }
+    if (shard_targets->empty())
+    {
+      message::status("ok", "No targets in this shard.", message::Style::success);
+      return finish_check(session, working_dir, options, {});
+    }
+    selected_targets = std::move(*shard_targets);
   }
 
-  return 0;
+  if (!options.coordinator.empty())
+  {
+    if (auto scanned = scan_on_workers(session, options, selected_targets); !scanned)
+    {
+      return std::unexpected(scanned.error());
+    }
+  }
+
+  const auto num_threads = session.thread_count();
+  message::info("Scanning with {} thread{}", num_threads, num_threads == 1 ? "" : "s");
+  if (memory_limit_bytes > 0)
+  {
+    message::info("Holding back sources above {} MiB of memory",
+                  memory_limit_bytes / (1024U * 1024U));
+  }
+  message::blank_line();
+
+  bool first_target = true;
+  lwyi::Check_callbacks callbacks;
+  callbacks.target_started = [&](const target_model::Target& target)
+  {
+    if (!first_target)
+    {
+      message::blank_line();
+    }
+    first_target = false;
+
+    message::heading("Target: {}", target.name);
+  };
+  // the reports are rendered on the checking threads and printed in the order of the targets
+  callbacks.render_report = [](const lwyi::Target_result& target_result)
+  {
+    message::Capture capture;
+    report_target_result(target_result);
+    return capture.take();
+  };
+  callbacks.target_reported = [](const lwyi::Target_result& /*target_result*/,
+                                 const std::string& report)
+  {
+    message::write(report);
+  };
+
+  const auto result = session.check(selected_targets, callbacks);
+  if (result.stopped)
+  {
+    message::blank_line();
+    message::warning("Stopped at the first failed target.");
+  }
+
+  return finish_check(session, working_dir, options, result);
+}
+
+std::expected<int, std::string> run_lwyi(const cli::Command_options& options)
+{
+  auto working_dir = std::filesystem::current_path();
+  auto binary_dir = working_dir;
+  if (!options.binary_dir.empty())
+  {
+    binary_dir = options.binary_dir;
+    if (!std::filesystem::is_directory(binary_dir))
+    {
+      return std::unexpected(
+        std::format("error: {} is not a directory", binary_dir.string()));
+    }
+  }
+
+  const auto num_threads = (0U < options.num_threads) ? options.num_threads
+                                                      : util::default_thread_count();
+
+  if (!options.serve.empty())
+  {
+    return run_server(binary_dir, num_threads, options);
+  }
+
+  // workers only need the sources, not the build directory
+  if (!options.worker.empty())
+  {
+    return run_worker(options.worker, num_threads, std::chrono::seconds(options.tu_timeout));
+  }
+
+  // merging only needs the result files, not the build directory
+  if (!options.tool_command.empty() && options.tool_command.front() == "merge-results")
+  {
+    return merge_results_tool(options.tool_command);
+  }
+
+  // tools only use the target model, not the compilation database or the scanner
+  if (!options.tool_command.empty())
+  {
+    announce_metadata(binary_dir);
+    const auto target_model = lwyi::load_target_model(binary_dir, num_threads);
+    if (!target_model.has_value())
+    {
+      return std::unexpected(target_model.error());
+    }
+    return run_tool(
+      binary_dir, *target_model, get_selected_targets(options), options.tool_command);
+  }
+
+  auto session = open_session(binary_dir, num_threads);
+  if (!session.has_value())
+  {
+    return std::unexpected(session.error());
+  }
+
+  if (auto loaded = session->load_include_graphs(); !loaded.has_value())
+  {
+    message::warning("Ignoring recorded include graphs: {}", loaded.error());
+  }
+
+  auto result = check_targets(*session, working_dir, options);
+
+  if (auto saved = session->save_include_graphs(); !saved.has_value())
+  {
+    message::warning("Failed to save include graphs: {}", saved.error());
+  }
+
+  return result;
 }
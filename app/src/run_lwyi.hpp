@@ -1,12 +1,30 @@
 // Copyright (c) 2025 Environmental Systems Research Institute, Inc.
 // SPDX-License-Identifier: Apache-2.0
 
+#pragma once
+
+#include <cstddef>
 #include <expected>
+#include <filesystem>
 #include <string>
 
 namespace cli
 {
 struct Command_options;
-}
+} // namespace cli
+
+namespace lwyi
+{
+class Session;
+} // namespace lwyi
+
+std::expected<lwyi::Session, std::string> open_session(const std::filesystem::path& binary_dir,
+                                                       size_t thread_count);
+
+// Check the targets selected by the options. Relative paths in the options are relative to
+// the working directory.
+std::expected<int, std::string> check_targets(lwyi::Session& session,
+                                              const std::filesystem::path& working_dir,
+                                              const cli::Command_options& options);
 
 std::expected<int, std::string> run_lwyi(const cli::Command_options& options);
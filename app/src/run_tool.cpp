@@ -4,10 +4,13 @@
 #include <src/run_tool.hpp>
 
 #include <message/message.hpp>
+#include <src/critical_path_tool.hpp>
 #include <src/graph_tool.hpp>
+#include <src/impact_tool.hpp>
 #include <src/tidy_tool.hpp>
 
 #include <cassert>
+#include <filesystem>
 #include <string_view>
 #include <vector>
 
@@ -16,10 +19,16 @@ namespace
 constexpr std::string_view usage_string = R"(tools:
   list                      Print this help message.
   tidy                      Check that the dependency graph is a DAG.
-  graph                     Generate a graphviz dot graph of the dependencies.)";
+  graph                     Generate a graphviz dot graph of the dependencies.
+  critical-path             Find the longest chain of dependencies to build and
+                            the slack of every target.
+  impact                    List the targets affected by changed targets or
+                            files.
+  merge-results             Combine the results of the shards of a check.)";
 }
 
-int run_tool(const target_model::Target_model& target_model,
+int run_tool(const std::filesystem::path& binary_dir,
+             const target_model::Target_model& target_model,
              const std::vector<target_model::Target>& selected_targets,
              const std::vector<std::string_view>& args)
 {
@@ -36,6 +45,16 @@ int run_tool(const target_model::Target_model& target_model,
     return graph_tool(target_model, selected_targets, args);
   }
 
+  if (args[0] == "critical-path")
+  {
+    return critical_path_tool(target_model, selected_targets, args);
+  }
+
+  if (args[0] == "impact")
+  {
+    return impact_tool(binary_dir, target_model, selected_targets, args);
+  }
+
   if (args[0] == "tidy")
   {
     return tidy_tool(target_model, selected_targets, args);
@@ -3,6 +3,7 @@
 
 #pragma once
 
+#include <filesystem>
 #include <string_view>
 #include <vector>
 
@@ -12,6 +13,8 @@ struct Target;
 class Target_model;
 } // namespace target_model
 
-int run_tool(const target_model::Target_model& target_model,
+// The binary directory is where the tools look for the sources, e.g. to resolve changed files
+int run_tool(const std::filesystem::path& binary_dir,
+             const target_model::Target_model& target_model,
              const std::vector<target_model::Target>& selected_targets,
              const std::vector<std::string_view>& args);
@@ -0,0 +1,524 @@
+// Copyright (c) 2025 Environmental Systems Research Institute, Inc.
+// SPDX-License-Identifier: Apache-2.0
+
+#include <src/serve.hpp>
+
+#include <cli/command_options.hpp>
+#include <cli/parse_arguments.hpp>
+#include <lwyi/session.hpp>
+#include <message/message.hpp>
+#include <src/run_lwyi.hpp>
+#include <target_model/target.hpp>
+#include <target_model/target_data.hpp>
+#include <target_model/target_model.hpp>
+#include <util/socket.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cerrno>
+#include <charconv>
+#include <chrono>
+#include <csignal>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <expected>
+#include <filesystem>
+#include <format>
+#include <iostream>
+#include <optional>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+#ifndef _WIN32
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
+
+#ifdef __linux__
+#include <poll.h>
+#include <sys/inotify.h>
+#endif
+
+// A request is a single frame (see util::write_frame) of null terminated strings: the protocol
+// header, the working directory of the client, "1" if the client writes to a terminal, and the
+// command line arguments. The response is the output of the check, a null character, and the
+// exit code, after which the server closes the connection.
+
+namespace
+{
+#ifndef _WIN32
+constexpr std::string_view protocol_header = "lwyi serve 2";
+
+using util::File_descriptor;
+#endif
+
+#ifdef __linux__
+// a client that does not send its request in time must not block the server
+constexpr std::chrono::seconds request_timeout{10};
+constexpr uint32_t max_request_size = 1U << 20U;
+
+volatile std::sig_atomic_t g_stop = 0; // NOLINT(cppcoreguidelines-avoid-non-const-global-variables)
+
+extern "C" void handle_stop_signal(int /*signal*/)
+{
+  g_stop = 1;
+}
+
+// Watches directories for modified files with inotify. Only directories are watched, so a file
+// is covered once any file in its directory is watched.
+class Directory_watcher
+{
+public:
+  static std::expected<Directory_watcher, std::string> create()
+  {
+    File_descriptor fd(inotify_init1(IN_NONBLOCK | IN_CLOEXEC));
+    if (fd.get() < 0)
+    {
+      return std::unexpected(
+        std::format("error: failed to initialize inotify: {}", std::strerror(errno)));
+    }
+    Directory_watcher watcher;
+    watcher.fd_ = std::move(fd);
+    return watcher;
+  }
+
+  int fd() const
+  {
+    return fd_.get();
+  }
+
+  void watch_directory_of(const std::filesystem::path& file)
+  {
+    watch(file.parent_path());
+  }
+
+  void watch(const std::filesystem::path& directory)
+  {
+    if (directory.empty() || !watched_.insert(directory).second)
+    {
+      return;
+    }
+
+    constexpr uint32_t mask =
+      IN_CLOSE_WRITE | IN_MOVED_TO | IN_MOVED_FROM | IN_CREATE | IN_DELETE | IN_ONLYDIR;
+    const int wd = inotify_add_watch(fd_.get(), directory.c_str(), mask);
+    if (wd < 0)
+    {
+      message::debug("Not watching {}: {}", directory.string(), std::strerror(errno));
+      return;
+    }
+    directories_[wd] = directory;
+  }
+
+  // The files changed since the last call, or nothing if events were lost and everything must be
+  // considered changed
+  std::optional<std::vector<std::filesystem::path>> read_changes()
+  {
+    std::vector<std::filesystem::path> changes;
+    bool overflow = false;
+
+    alignas(inotify_event) std::array<char, 16384> buffer{};
+    while (true)
+    {
+      const auto count = ::read(fd_.get(), buffer.data(), buffer.size());
+      if (count <= 0)
+      {
+        break;
+      }
+
+      for (size_t offset = 0; offset < static_cast<size_t>(count);)
+      {
+        inotify_event event{};
+        std::memcpy(&event, buffer.data() + offset, sizeof(event));
+        const char* name = buffer.data() + offset + sizeof(event);
+        offset += sizeof(event) + event.len;
+
+        if ((event.mask & IN_Q_OVERFLOW) != 0)
+        {
+          overflow = true;
+          continue;
+        }
+        if ((event.mask & IN_IGNORED) != 0)
+        {
+          if (auto it = directories_.find(event.wd); it != directories_.end())
+          {
+            watched_.erase(it->second);
+            directories_.erase(it);
+          }
+          continue;
+        }
+        if (event.len == 0)
+        {
+          continue;
+        }
+        if (auto it = directories_.find(event.wd); it != directories_.end())
+        {
+          changes.push_back((it->second / name).generic_string());
+        }
+      }
+    }
+
+    if (overflow)
+    {
+      return std::nullopt;
+    }
+    return changes;
+  }
+
+private:
+  Directory_watcher() = default;
+
+  File_descriptor fd_;
+  std::unordered_map<int, std::filesystem::path> directories_;
+  std::unordered_set<std::filesystem::path> watched_;
+};
+
+class Server
+{
+public:
+  Server(lwyi::Session session, Directory_watcher watcher)
+  : binary_dir_(session.binary_dir()),
+    session_(std::move(session)),
+    watcher_(std::move(watcher))
+  {
+    if (auto loaded = session_.load_include_graphs(); !loaded.has_value())
+    {
+      message::warning("Ignoring recorded include graphs: {}", loaded.error());
+    }
+
+    watcher_.watch(binary_dir_);
+    watch_target_model_();
+    watch_recorded_files_();
+  }
+
+  int watcher_fd() const
+  {
+    return watcher_.fd();
+  }
+
+  void save()
+  {
+    if (auto saved = session_.save_include_graphs(); !saved.has_value())
+    {
+      message::warning("Failed to save include graphs: {}", saved.error());
+    }
+  }
+
+  // Apply the file changes observed since the last request
+  void update()
+  {
+    auto changes = watcher_.read_changes();
+    if (!changes)
+    {
+      message::warning("File change events were lost. Discarding all caches.");
+      const auto files = session_.recorded_files();
+      changes.emplace(files.begin(), files.end());
+      changes->push_back(binary_dir_ / "compile_commands.json");
+      changes->push_back(info_file_());
+    }
+    if (changes->empty())
+    {
+      return;
+    }
+
+    message::info("{} file{} changed", changes->size(), changes->size() == 1 ? "" : "s");
+    session_.rescan(*changes);
+
+    if (std::ranges::contains(*changes, info_file_()))
+    {
+      message::info("Reloading metadata from {}", info_file_().string());
+      if (auto reloaded = session_.reload_model(); reloaded.has_value())
+      {
+        watch_target_model_();
+      }
+      else
+      {
+        message::warning("Keeping the previous target model: {}", reloaded.error());
+      }
+    }
+  }
+
+  // Handle the request of a client and return the response
+  std::string handle(std::string_view request, const cli::Command_options& server_options)
+  {
+    std::vector<std::string> fields;
+    for (size_t first = 0; first < request.size();)
+    {
+      const auto last = std::min(request.find('\0', first), request.size());
+      fields.emplace_back(request.substr(first, last - first));
+      first = last + 1;
+    }
+
+    if (fields.size() < 3 || fields[0] != protocol_header)
+    {
+      return std::format("error: unexpected request\n{}1", '\0');
+    }
+
+    const std::filesystem::path working_dir = fields[1];
+    const bool client_terminal = fields[2] == "1";
+
+    std::vector<const char*> argv{"lwyi"};
+    for (size_t i = 3; i < fields.size(); ++i)
+    {
+      argv.push_back(fields[i].c_str());
+    }
+
+    std::ostringstream output;
+    auto* const stdout_buffer = std::cout.rdbuf(output.rdbuf());
+    const auto exit_code = check_(working_dir, client_terminal, argv);
+    std::cout.rdbuf(stdout_buffer);
+    message::configure(server_options.color_output, server_options.message_level);
+
+    // the check may have read files outside of the directories of the targets, or the first
+    // check of a build directory all of them
+    watch_recorded_files_();
+
+    return std::format("{}{}{}", output.str(), '\0', exit_code);
+  }
+
+private:
+  std::filesystem::path info_file_() const
+  {
+    return (binary_dir_ / "link_what_you_include_info.json").lexically_normal().generic_string();
+  }
+
+  void watch_target_model_()
+  {
+    session_.target_model().for_each_target(
+      [&](const target_model::Target& /*target*/, const target_model::Target_data& target_data)
+      {
+        for (const auto* files : {&target_data.sources,
+                                  &target_data.headers,
+                                  &target_data.interface_headers,
+                                  &target_data.verify_interface_header_sets_sources})
+        {
+          for (const auto& file : *files)
+          {
+            watcher_.watch_directory_of(file);
+          }
+        }
+        for (const auto& directory : target_data.interface_include_directories)
+        {
+          watcher_.watch(directory);
+        }
+      });
+  }
+
+  void watch_recorded_files_()
+  {
+    for (const auto& file : session_.recorded_files())
+    {
+      watcher_.watch_directory_of(file);
+    }
+  }
+
+  int check_(const std::filesystem::path& working_dir,
+             bool client_terminal,
+             const std::vector<const char*>& argv)
+  {
+    auto options = cli::parse_arguments(static_cast<int>(argv.size()), argv.data());
+    if (!options)
+    {
+      message::print(options.error(), message::Style::error);
+      return 1;
+    }
+
+    auto color_output = options->color_output;
+    if (color_output == message::Color_output::automatic)
+    {
+      color_output =
+        client_terminal ? message::Color_output::always : message::Color_output::never;
+    }
+    message::configure(color_output, options->message_level);
+
+    if (!options->tool_command.empty() || !options->serve.empty() ||
+        !options->coordinator.empty() || !options->worker.empty())
+    {
+      message::print("error: only checks can be run by the server", message::Style::error);
+      return 1;
+    }
+    if (!options->binary_dir.empty() &&
+        std::filesystem::weakly_canonical(working_dir / options->binary_dir) !=
+          std::filesystem::weakly_canonical(binary_dir_))
+    {
+      message::print(std::format("error: the server checks {}", binary_dir_.string()),
+                     message::Style::error);
+      return 1;
+    }
+
+    auto result = check_targets(session_, working_dir, *options);
+    if (!result)
+    {
+      message::print(result.error(), message::Style::error);
+      return 1;
+    }
+    return *result;
+  }
+
+  std::filesystem::path binary_dir_;
+  lwyi::Session session_;
+  Directory_watcher watcher_;
+};
+
+#endif
+} // namespace
+
+std::expected<int, std::string> run_server(const std::filesystem::path& binary_dir,
+                                           size_t thread_count,
+                                           const cli::Command_options& options)
+{
+#ifdef __linux__
+  const std::filesystem::path socket_path{options.serve};
+
+  auto session =
+    open_session(std::filesystem::absolute(binary_dir).lexically_normal(), thread_count);
+  if (!session.has_value())
+  {
+    return std::unexpected(session.error());
+  }
+
+  auto watcher = Directory_watcher::create();
+  if (!watcher.has_value())
+  {
+    return std::unexpected(watcher.error());
+  }
+
+  auto listen_fd = util::listen_on(options.serve);
+  if (!listen_fd.has_value())
+  {
+    return std::unexpected(listen_fd.error());
+  }
+
+  struct sigaction action{};
+  action.sa_handler = handle_stop_signal;
+  sigemptyset(&action.sa_mask);
+  sigaction(SIGINT, &action, nullptr);
+  sigaction(SIGTERM, &action, nullptr);
+  std::signal(SIGPIPE, SIG_IGN); // NOLINT(cert-err33-c)
+
+  Server server(std::move(*session), std::move(*watcher));
+
+  message::info("Listening on {}", socket_path.string());
+
+  while (g_stop == 0)
+  {
+    std::array<pollfd, 2> fds{pollfd{listen_fd->get(), POLLIN, 0},
+                              pollfd{server.watcher_fd(), POLLIN, 0}};
+    if (::poll(fds.data(), fds.size(), -1) < 0)
+    {
+      if (errno == EINTR)
+      {
+        continue;
+      }
+      return std::unexpected(std::format("error: poll failed: {}", std::strerror(errno)));
+    }
+
+    if ((fds[1].revents & POLLIN) != 0)
+    {
+      server.update();
+    }
+
+    if ((fds[0].revents & POLLIN) != 0)
+    {
+      File_descriptor client(::accept4(listen_fd->get(), nullptr, nullptr, SOCK_CLOEXEC));
+      if (client.get() < 0)
+      {
+        continue;
+      }
+
+      const auto start = std::chrono::steady_clock::now();
+      auto request = util::read_frame(client.get(), request_timeout, max_request_size);
+      if (!request)
+      {
+        message::warning("Dropped a client that did not send a valid request in time");
+        continue;
+      }
+
+      // the request may have been sent right after a file was saved
+      server.update();
+      const auto response = server.handle(*request, options);
+      util::write_all(client.get(), response);
+
+      const auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now() - start);
+      message::info("Handled request in {} ms", elapsed.count());
+    }
+  }
+
+  message::info("Shutting down");
+  server.save();
+  if (std::filesystem::is_socket(socket_path))
+  {
+    std::filesystem::remove(socket_path);
+  }
+  return 0;
+#else
+  static_cast<void>(binary_dir);
+  static_cast<void>(thread_count);
+  static_cast<void>(options);
+  return std::unexpected("error: --serve is only supported on Linux");
+#endif
+}
+
+std::expected<int, std::string> run_client(std::string_view socket_path,
+                                           int argc,
+                                           const char* const* argv)
+{
+#ifndef _WIN32
+  auto fd = util::connect_to(socket_path);
+  if (!fd.has_value())
+  {
+    return std::unexpected(fd.error());
+  }
+
+  std::string request;
+  const auto append = [&](std::string_view field)
+  {
+    request.append(field);
+    request.push_back('\0');
+  };
+  append(protocol_header);
+  append(std::filesystem::current_path().generic_string());
+  append(::isatty(STDOUT_FILENO) ? "1" : "0");
+  for (int i = 1; i < argc; ++i)
+  {
+    append(argv[i]); // NOLINT(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+  }
+
+  if (!util::write_frame(fd->get(), request))
+  {
+    return std::unexpected(std::format("error: failed to send the request to {}", socket_path));
+  }
+
+  const auto response = util::read_all(fd->get());
+  const auto separator = response ? response->rfind('\0') : std::string::npos;
+  if (separator == std::string::npos)
+  {
+    return std::unexpected(std::format("error: no response from {}", socket_path));
+  }
+
+  const std::string_view exit_code_text = std::string_view(*response).substr(separator + 1);
+  int exit_code = 0;
+  const auto [end, error] = std::from_chars(
+    exit_code_text.data(), exit_code_text.data() + exit_code_text.size(), exit_code);
+  if (error != std::errc{} || end != exit_code_text.data() + exit_code_text.size())
+  {
+    return std::unexpected(std::format("error: unexpected response from {}", socket_path));
+  }
+
+  std::cout << std::string_view(*response).substr(0, separator) << std::flush;
+  return exit_code;
+#else
+  static_cast<void>(socket_path);
+  static_cast<void>(argc);
+  static_cast<void>(argv);
+  return std::unexpected("error: --connect is not supported on Windows");
+#endif
+}
@@ -0,0 +1,28 @@
+// Copyright (c) 2025 Environmental Systems Research Institute, Inc.
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+
+#include <cstddef>
+#include <expected>
+#include <filesystem>
+#include <string>
+#include <string_view>
+
+namespace cli
+{
+struct Command_options;
+} // namespace cli
+
+// Keep the target model, the compilation database and the scanner caches of the build directory
+// loaded, and check targets on behalf of clients connecting to the Unix socket given by the
+// --serve option. Files are watched to invalidate the caches.
+std::expected<int, std::string> run_server(const std::filesystem::path& binary_dir,
+                                           size_t thread_count,
+                                           const cli::Command_options& options);
+
+// Send the command line to the server listening on the socket, print the output and return the
+// exit code of the check.
+std::expected<int, std::string> run_client(std::string_view socket_path,
+                                           int argc,
+                                           const char* const* argv);
@@ -11,7 +11,10 @@
 #include <cstddef>
 #include <expected>
 #include <filesystem>
+#include <ranges>
+#include <string>
 #include <string_view>
+#include <utility>
 #include <vector>
 
 namespace target_model
@@ -26,17 +29,26 @@ constexpr std::string_view usage_string = R"(Usage:
 
 Possible options:
   -h, --help                Print this help message.
-  -c, --config FILE         Path to config file.)";
+  -c, --config FILE         Path to config file.
+  --transitive              Also report forbidden dependencies that are reached
+                            through other targets.
+  --what-if EDITS           Report what tidy would find after editing the
+                            dependencies, given as a comma separated list of
+                            add:TARGET->DEPENDENCY and remove:TARGET->DEPENDENCY.)";
 
 struct Options
 {
   bool help{false};
   std::string_view config_filename;
+  bool transitive{false};
+  std::string_view what_if;
 };
 
 constexpr auto parser = util::arg_parser<Options>()
                           .arg("-h", "--help", &Options::help)
-                          .arg("-c", "--config", &Options::config_filename);
+                          .arg("-c", "--config", &Options::config_filename)
+                          .arg("--transitive", &Options::transitive)
+                          .arg("--what-if", &Options::what_if);
 } // namespace
 
 int tidy_tool(const target_model::Target_model& target_model,
@@ -73,7 +85,32 @@ int tidy_tool(const target_model::Target_model& target_model,
     return 1;
   }
 
-  auto diagnostics = tidy::tidy(config.value(), target_model);
+  if (options.transitive)
+  {
+    config->transitive = true;
+  }
+
+  std::vector<tidy::Dag_diagnostic> diagnostics;
+  if (options.what_if.empty())
+  {
+    diagnostics = tidy::tidy(config.value(), target_model);
+  }
+  else
+  {
+    auto edits = tidy::parse_dependency_edits(options.what_if);
+    if (!edits.has_value())
+    {
+      message::error_block(edits.error(), std::string{usage_string});
+      return 1;
+    }
+    auto what_if = tidy::tidy_what_if(config.value(), target_model, *edits);
+    if (!what_if.has_value())
+    {
+      message::error(what_if.error());
+      return 1;
+    }
+    diagnostics = std::move(*what_if);
+  }
 
   auto describe_targets = [](const std::vector<target_model::Target>& targets)
   {
@@ -123,10 +160,25 @@ int tidy_tool(const target_model::Target_model& target_model,
       break;
       case tidy::Dag_diagnostic_type::forbidden_dependency:
       {
-        assert(diagnostic.targets.size() == 2);
-        message::error("{} is forbidden to depend on {}",
-                       diagnostic.targets[0].name,
-                       diagnostic.targets[1].name);
+        assert(2 <= diagnostic.targets.size());
+        if (diagnostic.targets.size() == 2)
+        {
+          message::error("{} is forbidden to depend on {}",
+                         diagnostic.targets[0].name,
+                         diagnostic.targets[1].name);
+        }
+        else
+        {
+          std::string path = diagnostic.targets.front().name;
+          for (const auto& target : diagnostic.targets | std::views::drop(1))
+          {
+            path += " -> " + target.name;
+          }
+          message::error("{} is forbidden to depend on {} through {}",
+                         diagnostic.targets.front().name,
+                         diagnostic.targets.back().name,
+                         path);
+        }
         error = true;
       }
       break;
@@ -15,6 +15,20 @@ struct Command_options
 {
   std::string_view binary_dir;
   std::vector<std::string_view> targets;
+  std::vector<std::string_view> sources;
+  std::string_view changed_files;
+  bool rescan;
+  bool process_isolation;
+  bool fail_fast;
+  uint32_t tu_timeout;
+  uint32_t memory_limit;
+  std::string_view shard;
+  std::string_view results;
+  std::string_view profile;
+  std::string_view serve;
+  std::string_view connect;
+  std::string_view coordinator;
+  std::string_view worker;
   std::vector<std::string_view> tool_command;
   message::Color_output color_output;
   message::Message_level message_level;
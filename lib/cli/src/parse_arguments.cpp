@@ -38,7 +38,50 @@ Possible options:
                             the current directory.
   -t, --targets TARGETS...  Limit analysis to the given targets.
   -j, --parallel COUNT      Number of threads used to process source files.
-                            Default depends on system.
+                            Default is the number of CPUs, limited by the CPU
+                            quota of the cgroup.
+  --sources FILES...        Only check the targets affected by the given
+                            modified files. Uses the include graphs recorded
+                            by a previous run to find the affected sources.
+  --changed-files FILE      Like --sources but the modified files are read
+                            from FILE, one path per line. Relative paths are
+                            relative to the root of the git repository of the
+                            sources, like the output of git diff --name-only.
+  --rescan                  Preprocess every source again instead of reusing
+                            the include graphs recorded by a previous run.
+  --process-isolation       Preprocess in child processes. A source that
+                            crashes the preprocessor is reported and its
+                            process restarted. Not supported on Windows.
+  --fail-fast               Stop at the first target that fails.
+  --tu-timeout SECONDS      Fail a source that takes longer to preprocess.
+  --memory-limit MIB        Preprocess fewer sources at once while the memory
+                            used gets close to MIB mebibytes. Default is most
+                            of the memory limit of the cgroup, if any.
+
+  --shard K/N               Only check the K-th of N parts of the targets. The
+                            parts are balanced by the number of sources of the
+                            targets, or by their durations in the --profile.
+  --results FILE            Write the results to FILE to be combined with
+                            --tool merge-results.
+  --profile FILE            Balance --shard by the target durations in FILE, as
+                            written to lwyi_profile.json in the build directory
+                            or by --tool merge-results --profile FILE.
+
+  --serve SOCKET            Keep the build directory loaded and check targets
+                            for clients connecting to the Unix socket SOCKET.
+                            Modified files are detected by watching their
+                            directories.
+  --connect SOCKET          Let the server listening on SOCKET run the check.
+                            The other options are passed to the server.
+
+  --coordinator ADDRESS     Let the workers connecting to ADDRESS preprocess
+                            the sources, then check the targets. ADDRESS is
+                            HOST:PORT or the path of a Unix socket. When no
+                            worker is connected for a minute, the remaining
+                            sources are preprocessed locally.
+  --worker ADDRESS          Preprocess sources for the coordinator listening on
+                            ADDRESS until it has no more. The worker needs the
+                            sources at the same paths as the coordinator.
 
   --tool TOOL [OPTIONS...]  Run a tool. All subsequent arguments are passed to
                             the tool. This is undocumented and serves as a place
@@ -54,6 +97,19 @@ struct Options
   uint32_t num_threads{0};
   std::vector<std::string_view> targets;
   std::vector<std::string_view> sources;
+  std::string_view changed_files;
+  bool rescan{false};
+  bool process_isolation{false};
+  bool fail_fast{false};
+  uint32_t tu_timeout{0};
+  uint32_t memory_limit{0};
+  std::string_view shard;
+  std::string_view results;
+  std::string_view profile;
+  std::string_view serve;
+  std::string_view connect;
+  std::string_view coordinator;
+  std::string_view worker;
   std::vector<std::string_view> tool_command;
 };
 
@@ -65,6 +121,20 @@ constexpr auto parser = util::arg_parser<Options>()
                           .arg("-d", "--binary_dir", &Options::binary_dir)
                           .arg("-t", "--targets", &Options::targets)
                           .arg("-j", "--parallel", &Options::num_threads)
+                          .arg("--sources", &Options::sources)
+                          .arg("--changed-files", &Options::changed_files)
+                          .arg("--rescan", &Options::rescan)
+                          .arg("--process-isolation", &Options::process_isolation)
+                          .arg("--fail-fast", &Options::fail_fast)
+                          .arg("--tu-timeout", &Options::tu_timeout)
+                          .arg("--memory-limit", &Options::memory_limit)
+                          .arg("--shard", &Options::shard)
+                          .arg("--results", &Options::results)
+                          .arg("--profile", &Options::profile)
+                          .arg("--serve", &Options::serve)
+                          .arg("--connect", &Options::connect)
+                          .arg("--coordinator", &Options::coordinator)
+                          .arg("--worker", &Options::worker)
                           .terminal_arg("--tool", &Options::tool_command);
 
 std::string usage(std::string_view name)
@@ -147,6 +217,20 @@ std::expected<Command_options, std::string> parse_arguments(int argc, const char
 
   return Command_options{options.binary_dir,
                          std::move(options.targets),
+                         std::move(options.sources),
+                         options.changed_files,
+                         options.rescan,
+                         options.process_isolation,
+                         options.fail_fast,
+                         options.tu_timeout,
+                         options.memory_limit,
+                         options.shard,
+                         options.results,
+                         options.profile,
+                         options.serve,
+                         options.connect,
+                         options.coordinator,
+                         options.worker,
                          std::move(options.tool_command),
                          color_output,
                          get_message_level(options),
@@ -421,3 +421,206 @@ TEST_CASE("cli: parse_arguments for debug", "[lwyi]")
   CHECK(options.message_level == message::Message_level::debug);
   CHECK(options.binary_dir == "some/dir");
 }
+
+TEST_CASE("cli: parse_arguments for changed sources", "[lwyi]")
+{
+  SECTION("--sources")
+  {
+    std::vector<const char*> args{"exe_name", "--sources", "a.hpp", "b.cpp", "-d", "some/dir"};
+    INFO(to_string(args));
+
+    const auto argc = static_cast<int>(args.size());
+    const auto argv = args.data();
+    auto result = cli::parse_arguments(argc, argv);
+    REQUIRE(result.has_value());
+
+    const auto& options = result.value();
+    CHECK(options.binary_dir == "some/dir");
+    REQUIRE(options.sources.size() == 2U);
+    CHECK(options.sources[0] == "a.hpp");
+    CHECK(options.sources[1] == "b.cpp");
+    CHECK(options.changed_files.empty());
+  }
+  SECTION("--changed-files")
+  {
+    std::vector<const char*> args{"exe_name", "--changed-files", "changes.txt"};
+    INFO(to_string(args));
+
+    const auto argc = static_cast<int>(args.size());
+    const auto argv = args.data();
+    auto result = cli::parse_arguments(argc, argv);
+    REQUIRE(result.has_value());
+
+    const auto& options = result.value();
+    CHECK(options.sources.empty());
+    CHECK(options.changed_files == "changes.txt");
+    CHECK(!options.rescan);
+  }
+  SECTION("--rescan")
+  {
+    std::vector<const char*> args{"exe_name", "--rescan", "-d", "some/dir"};
+    INFO(to_string(args));
+
+    const auto argc = static_cast<int>(args.size());
+    const auto argv = args.data();
+    auto result = cli::parse_arguments(argc, argv);
+    REQUIRE(result.has_value());
+
+    const auto& options = result.value();
+    CHECK(options.rescan);
+    CHECK(!options.process_isolation);
+    CHECK(options.binary_dir == "some/dir");
+  }
+  SECTION("--process-isolation")
+  {
+    std::vector<const char*> args{"exe_name", "--process-isolation", "-j", "4"};
+    INFO(to_string(args));
+
+    const auto argc = static_cast<int>(args.size());
+    const auto argv = args.data();
+    auto result = cli::parse_arguments(argc, argv);
+    REQUIRE(result.has_value());
+
+    const auto& options = result.value();
+    CHECK(options.process_isolation);
+    CHECK(options.num_threads == 4U);
+    CHECK(!options.fail_fast);
+    CHECK(options.tu_timeout == 0U);
+    CHECK(options.memory_limit == 0U);
+  }
+  SECTION("--fail-fast --tu-timeout")
+  {
+    std::vector<const char*> args{"exe_name", "--fail-fast", "--tu-timeout", "60"};
+    INFO(to_string(args));
+
+    const auto argc = static_cast<int>(args.size());
+    const auto argv = args.data();
+    auto result = cli::parse_arguments(argc, argv);
+    REQUIRE(result.has_value());
+
+    const auto& options = result.value();
+    CHECK(options.fail_fast);
+    CHECK(options.tu_timeout == 60U);
+  }
+  SECTION("--memory-limit")
+  {
+    std::vector<const char*> args{"exe_name", "--memory-limit", "4096"};
+    INFO(to_string(args));
+
+    const auto argc = static_cast<int>(args.size());
+    const auto argv = args.data();
+    auto result = cli::parse_arguments(argc, argv);
+    REQUIRE(result.has_value());
+
+    const auto& options = result.value();
+    CHECK(options.memory_limit == 4096U);
+  }
+}
+
+TEST_CASE("cli: parse_arguments for sharding", "[lwyi]")
+{
+  SECTION("no sharding")
+  {
+    std::vector<const char*> args{"exe_name", "-d", "some/dir"};
+    INFO(to_string(args));
+
+    const auto argc = static_cast<int>(args.size());
+    const auto argv = args.data();
+    auto result = cli::parse_arguments(argc, argv);
+    REQUIRE(result.has_value());
+
+    const auto& options = result.value();
+    CHECK(options.shard.empty());
+    CHECK(options.results.empty());
+    CHECK(options.profile.empty());
+  }
+  SECTION("--shard")
+  {
+    std::vector<const char*> args{"exe_name",
+                                  "--shard",
+                                  "2/4",
+                                  "--profile",
+                                  "profile.json",
+                                  "--results",
+                                  "shard2.json"};
+    INFO(to_string(args));
+
+    const auto argc = static_cast<int>(args.size());
+    const auto argv = args.data();
+    auto result = cli::parse_arguments(argc, argv);
+    REQUIRE(result.has_value());
+
+    const auto& options = result.value();
+    CHECK(options.shard == "2/4");
+    CHECK(options.results == "shard2.json");
+    CHECK(options.profile == "profile.json");
+  }
+}
+
+TEST_CASE("cli: parse_arguments for the server", "[lwyi]")
+{
+  SECTION("--serve")
+  {
+    std::vector<const char*> args{"exe_name", "--serve", "/tmp/lwyi.sock", "-d", "some/dir"};
+    INFO(to_string(args));
+
+    const auto argc = static_cast<int>(args.size());
+    const auto argv = args.data();
+    auto result = cli::parse_arguments(argc, argv);
+    REQUIRE(result.has_value());
+
+    const auto& options = result.value();
+    CHECK(options.serve == "/tmp/lwyi.sock");
+    CHECK(options.connect.empty());
+    CHECK(options.binary_dir == "some/dir");
+  }
+  SECTION("--connect")
+  {
+    std::vector<const char*> args{"exe_name", "--connect", "/tmp/lwyi.sock", "-t", "a"};
+    INFO(to_string(args));
+
+    const auto argc = static_cast<int>(args.size());
+    const auto argv = args.data();
+    auto result = cli::parse_arguments(argc, argv);
+    REQUIRE(result.has_value());
+
+    const auto& options = result.value();
+    CHECK(options.serve.empty());
+    CHECK(options.connect == "/tmp/lwyi.sock");
+    REQUIRE(options.targets.size() == 1U);
+    CHECK(options.targets[0] == "a");
+  }
+}
+
+TEST_CASE("cli: parse_arguments for distributed scans", "[lwyi]")
+{
+  SECTION("--coordinator")
+  {
+    std::vector<const char*> args{"exe_name", "--coordinator", "0.0.0.0:7700", "-d", "some/dir"};
+    INFO(to_string(args));
+
+    const auto argc = static_cast<int>(args.size());
+    const auto argv = args.data();
+    auto result = cli::parse_arguments(argc, argv);
+    REQUIRE(result.has_value());
+
+    const auto& options = result.value();
+    CHECK(options.coordinator == "0.0.0.0:7700");
+    CHECK(options.worker.empty());
+  }
+  SECTION("--worker")
+  {
+    std::vector<const char*> args{"exe_name", "--worker", "build-host:7700", "-j", "8"};
+    INFO(to_string(args));
+
+    const auto argc = static_cast<int>(args.size());
+    const auto argv = args.data();
+    auto result = cli::parse_arguments(argc, argv);
+    REQUIRE(result.has_value());
+
+    const auto& options = result.value();
+    CHECK(options.coordinator.empty());
+    CHECK(options.worker == "build-host:7700");
+    CHECK(options.num_threads == 8U);
+  }
+}
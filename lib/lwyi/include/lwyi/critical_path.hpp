@@ -0,0 +1,50 @@
+// Copyright (c) 2025 Environmental Systems Research Institute, Inc.
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace lwyi
+{
+class Digraph;
+
+// The schedule of building the vertices of a DAG whose edges lead from a vertex to the lower
+// vertices it depends on, like the condensation of Strongly_connected_components. Every vertex
+// takes its weight to build once its dependencies are built, and starts as early as possible
+// with unlimited parallelism.
+class Critical_path
+{
+public:
+  Critical_path(const Digraph& dag, std::span<const uint64_t> weights);
+
+  // The weight of the longest path, which is the time the whole build takes
+  uint64_t length() const;
+
+  // The sum of all weights, which is the time the build takes without parallelism
+  uint64_t total_weight() const;
+
+  // A longest path, from the vertex built first to the one built last
+  std::span<const uint32_t> path() const;
+
+  uint64_t earliest_start(uint32_t vertex) const;
+
+  // How much later the vertex could be finished without making the build take longer
+  uint64_t slack(uint32_t vertex) const;
+
+  // The most vertices built at the same time. More parallelism is of no use.
+  size_t peak_parallelism() const;
+
+private:
+  std::vector<uint64_t> finish_;
+  std::vector<uint64_t> slack_;
+  std::vector<uint64_t> weights_;
+  std::vector<uint32_t> path_;
+  uint64_t length_{0};
+  uint64_t total_weight_{0};
+  size_t peak_parallelism_{0};
+};
+} // namespace lwyi
@@ -0,0 +1,105 @@
+// Copyright (c) 2025 Environmental Systems Research Institute, Inc.
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <filesystem>
+#include <vector>
+
+namespace target_model
+{
+struct Target_data;
+class Target_model;
+} // namespace target_model
+
+namespace lwyi
+{
+class Strongly_connected_components;
+class Target_graph;
+
+// The layout of the file written by Graph_export::write_edge_list. It is a single binary file in
+// native byte order made of 8 byte aligned sections that follow the header in this order:
+//   string offsets  uint64_t[target_count + 1], offsets of the target names into the string blob
+//   string blob     char[string_bytes], the target names without terminators
+//   targets         Target_entry[target_count]
+//   edges           Edge_entry[edge_count], sorted by the target they start from
+// All sections are flat arrays so the file can be mapped and read without parsing.
+namespace edge_list
+{
+constexpr std::array<char, 8> magic = {'L', 'W', 'Y', 'I', 'G', 'R', 'P', '1'};
+constexpr uint32_t version = 1U;
+
+struct Header
+{
+  std::array<char, 8> magic{};
+  uint32_t version{0U};
+  uint32_t target_count{0U};
+  uint64_t string_bytes{0U};
+  uint64_t edge_count{0U};
+};
+static_assert(sizeof(Header) == 32);
+
+constexpr uint32_t external_flag = 1U;
+
+struct Target_entry
+{
+  uint32_t scc{0U};
+  // external_flag when the target is not part of the model
+  uint32_t flags{0U};
+};
+static_assert(sizeof(Target_entry) == 8);
+
+enum class Edge_kind : uint32_t
+{
+  private_dependency = 0U,
+  interface_dependency = 1U,
+};
+
+struct Edge_entry
+{
+  uint32_t from{0U};
+  uint32_t to{0U};
+  Edge_kind kind{Edge_kind::private_dependency};
+};
+static_assert(sizeof(Edge_entry) == 12);
+
+// The size of a section including the padding that aligns the next one
+constexpr uint64_t aligned(uint64_t size)
+{
+  return (size + 7U) & ~uint64_t{7U};
+}
+} // namespace edge_list
+
+// Writers of the dependency graph for other tools, streamed from the graph without sorting.
+// Every target has the id of its strongly connected component and every dependency is either an
+// interface dependency, when the target also has it in its interface dependencies, or a private
+// one. They return false when the file could not be written.
+class Graph_export
+{
+public:
+  Graph_export(const target_model::Target_model& target_model,
+               const Target_graph& graph,
+               const Strongly_connected_components& components);
+
+  // {"targets": [{"name": ..., "scc": ..., "external": ..., "dependencies": [{"target": ...,
+  // "kind": "interface" or "private"}, ...]}, ...]} where a dependency refers to the index of
+  // its target in the array
+  bool write_json(const std::filesystem::path& path) const;
+
+  bool write_graphml(const std::filesystem::path& path) const;
+
+  // A binary edge list in the layout of edge_list, which can be mapped into memory and read
+  // without parsing
+  bool write_edge_list(const std::filesystem::path& path) const;
+
+private:
+  bool is_interface(uint32_t from, uint32_t to) const;
+
+  const Target_graph& graph_;
+  const Strongly_connected_components& components_;
+  // the data of the targets of the model, which come before the external ones in the graph
+  std::vector<const target_model::Target_data*> target_data_;
+};
+} // namespace lwyi
@@ -0,0 +1,66 @@
+// Copyright (c) 2025 Environmental Systems Research Institute, Inc.
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace lwyi
+{
+class Digraph;
+
+// Strongly connected components that are kept up to date while edges are added to and removed
+// from the graph. The components are kept in topological order. Adding an edge only visits the
+// components between its ends in that order, merging them when the edge closes a cycle and
+// reordering them otherwise (Pearce and Kelly). Removing an edge only searches the component
+// it is part of again, which may split it.
+class Incremental_components
+{
+public:
+  explicit Incremental_components(const Digraph& graph);
+
+  // Nothing changes when the edge is already part of the graph
+  void add_edge(uint32_t from, uint32_t to);
+
+  // Nothing changes when the edge is not part of the graph
+  void remove_edge(uint32_t from, uint32_t to);
+
+  // The number of components
+  size_t size() const;
+
+  // The id of the component of the vertex. Ids are not reused, so they are not dense after
+  // components were merged.
+  uint32_t component(uint32_t vertex) const;
+
+  std::span<const uint32_t> members(uint32_t component) const;
+
+  // The components in reverse topological order, so a component never depends on a later one
+  std::span<const uint32_t> order() const;
+
+private:
+  // The components reached from the component through the edges without leaving the range of
+  // positions, marked in marks
+  std::vector<uint32_t> search(uint32_t component,
+                               const std::vector<std::vector<uint32_t>>& edges,
+                               std::vector<uint32_t>& marks,
+                               uint32_t first_position,
+                               uint32_t last_position);
+
+  void update_positions(size_t first);
+
+  std::vector<std::vector<uint32_t>> successors_;
+  std::vector<std::vector<uint32_t>> predecessors_;
+  std::vector<uint32_t> component_of_;
+  std::vector<std::vector<uint32_t>> members_;
+  // the live components in reverse topological order, and the position of each of them
+  std::vector<uint32_t> order_;
+  std::vector<uint32_t> position_;
+  // the searches of a change mark the components with the number of the change
+  std::vector<uint32_t> forward_marks_;
+  std::vector<uint32_t> backward_marks_;
+  uint32_t change_{0};
+};
+} // namespace lwyi
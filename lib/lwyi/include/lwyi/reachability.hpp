@@ -0,0 +1,44 @@
+// Copyright (c) 2025 Environmental Systems Research Institute, Inc.
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace lwyi
+{
+class Digraph;
+
+// The vertices reachable from every vertex of a DAG whose edges always lead to a lower vertex,
+// like the condensation of Strongly_connected_components. Every vertex has a bitset of the
+// vertices it reaches, which is the union of the bitsets of its successors.
+class Reachability
+{
+public:
+  explicit Reachability(const Digraph& dag);
+
+  // Whether there is a path of at least one edge from one vertex to the other
+  bool reaches(uint32_t from, uint32_t to) const;
+
+  // The bitset of the vertices reached from the vertex
+  std::span<const uint64_t> reached(uint32_t from) const;
+
+private:
+  size_t words_per_vertex_{0};
+  std::vector<uint64_t> reached_;
+};
+
+// The vertices on a shortest path from one vertex to the other, both included, or nothing when
+// the other vertex cannot be reached
+std::vector<uint32_t> shortest_path(const Digraph& graph, uint32_t from, uint32_t to);
+
+// The vertices reached from any of the start vertices, the start vertices included, as a bitset
+std::vector<uint64_t> reached_from(const Digraph& graph, std::span<const uint32_t> starts);
+
+// The DAG without the edges that are implied by a longer path, for a DAG whose edges always lead
+// to a lower vertex. The successors that are left keep their order.
+Digraph transitive_reduction(const Digraph& dag);
+} // namespace lwyi
@@ -0,0 +1,25 @@
+// Copyright (c) 2025 Environmental Systems Research Institute, Inc.
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+
+#include <lwyi/session.hpp>
+#include <lwyi/shard.hpp>
+
+#include <expected>
+#include <filesystem>
+#include <string>
+
+namespace lwyi
+{
+// The result of checking one shard, as written by every CI machine and merged afterwards
+struct Shard_result
+{
+  Shard shard;
+  Check_result result;
+};
+
+std::expected<void, std::string> write_result_file(const std::filesystem::path& path,
+                                                   const Shard_result& shard_result);
+std::expected<Shard_result, std::string> read_result_file(const std::filesystem::path& path);
+} // namespace lwyi
@@ -0,0 +1,36 @@
+// Copyright (c) 2025 Environmental Systems Research Institute, Inc.
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+
+#include <target_model/target.hpp>
+
+#include <chrono>
+#include <expected>
+#include <filesystem>
+#include <map>
+#include <optional>
+#include <string>
+
+namespace lwyi
+{
+struct Check_result;
+
+// The time it took to check each target, as measured by previous runs
+class Scan_profile
+{
+public:
+  static std::expected<Scan_profile, std::string> load(const std::filesystem::path& path);
+  std::expected<void, std::string> save(const std::filesystem::path& path) const;
+
+  // Update the durations of the checked targets
+  void record(const Check_result& result);
+
+  std::optional<std::chrono::milliseconds> duration(const target_model::Target& target) const;
+
+  bool empty() const;
+
+private:
+  std::map<target_model::Target, std::chrono::milliseconds> durations_;
+};
+} // namespace lwyi
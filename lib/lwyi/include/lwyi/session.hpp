@@ -0,0 +1,165 @@
+// Copyright (c) 2025 Environmental Systems Research Institute, Inc.
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+
+#include <lwyi/check_target.hpp>
+#include <target_model/target.hpp>
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <expected>
+#include <filesystem>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <set>
+#include <string>
+#include <vector>
+
+namespace scanner
+{
+class Scan_coordinator;
+} // namespace scanner
+
+namespace target_model
+{
+class Target_model;
+} // namespace target_model
+
+namespace lwyi
+{
+struct Target_result
+{
+  enum class Status : uint8_t
+  {
+    checked,
+    no_sources,
+    unknown_target,
+    scan_failed,
+  };
+
+  target_model::Target target;
+  Status status{Status::checked};
+  std::string scan_error;
+  std::vector<LWYI_error> errors;
+  std::chrono::milliseconds duration{0};
+
+  bool success() const;
+};
+
+struct Check_result
+{
+  std::vector<Target_result> targets;
+  // the check stopped at the first failed target, see Session::set_fail_fast
+  bool stopped{false};
+
+  bool success() const;
+};
+
+// Load the target model exported to the build directory, without anything a check needs. The
+// targets are converted on thread_count threads.
+std::expected<target_model::Target_model, std::string> load_target_model(
+  const std::filesystem::path& binary_dir,
+  size_t thread_count);
+
+// Read a list of changed files, one path per line. Relative paths are resolved like the output
+// of git diff --name-only, against the root of the repository of the sources the build directory
+// was configured for, or of the working directory when it is not a CMake build directory.
+std::expected<std::vector<std::filesystem::path>, std::string> read_changed_files(
+  const std::filesystem::path& list_path,
+  const std::filesystem::path& binary_dir,
+  const std::filesystem::path& working_dir);
+
+// Called around every target of a check, e.g. to report progress. Apart from render_report,
+// they are called in the order of the targets by the thread running the check.
+struct Check_callbacks
+{
+  std::function<void(const target_model::Target&)> target_started;
+  std::function<void(const Target_result&)> target_finished;
+  // Called on the checking threads in no particular order, to render the report of a target
+  // while others are still checked. The report is passed to target_reported.
+  std::function<std::string(const Target_result&)> render_report;
+  std::function<void(const Target_result&, const std::string& report)> target_reported;
+};
+
+// A build directory with its target model, scanner caches and thread pool. A session can check
+// any number of targets and keeps the results of scanning translation units between checks.
+class Session
+{
+public:
+  // Load the target model exported to the build directory
+  static std::expected<Session, std::string> open(const std::filesystem::path& binary_dir,
+                                                  size_t thread_count);
+
+  ~Session();
+  Session(const Session&) = delete;
+  Session(Session&& other) noexcept;
+  Session& operator=(const Session&) = delete;
+  Session& operator=(Session&& other) noexcept;
+
+  const std::filesystem::path& binary_dir() const;
+  const target_model::Target_model& target_model() const;
+  size_t thread_count() const;
+
+  // Load the target model from the build directory again. The previous model is kept when the
+  // new one fails to load.
+  std::expected<void, std::string> reload_model();
+
+  // The include graphs recorded for the build directory by a previous session. Missing graphs
+  // are not an error.
+  std::expected<void, std::string> load_include_graphs();
+  std::expected<void, std::string> save_include_graphs() const;
+
+  // Preprocess every translation unit again instead of reusing recorded include graphs
+  void force_rescan(bool rescan);
+
+  // Preprocess in child processes, so a translation unit that crashes the preprocessor only
+  // fails its own target
+  void use_process_isolation(bool isolate);
+
+  // Stop at the first target that fails, and stop preprocessing its remaining translation units
+  void set_fail_fast(bool fail_fast);
+
+  // Give up on translation units that take longer to preprocess, failing their target. Zero
+  // means no limit.
+  void set_tu_timeout(std::chrono::milliseconds tu_timeout);
+
+  // Preprocess fewer translation units at once while the memory used gets close to the limit
+  // in bytes. Zero means no limit.
+  void set_memory_limit(uint64_t memory_limit);
+
+  // Forget the scan results that depend on the modified files. The translation units that read
+  // them are preprocessed again by the next check.
+  void rescan(const std::vector<std::filesystem::path>& changed_files);
+
+  // Every file read by the translation units with a recorded include graph
+  std::set<std::filesystem::path> recorded_files() const;
+
+  // The targets with a translation unit that read any of the files, or nothing when no include
+  // graphs were recorded yet
+  std::optional<std::vector<target_model::Target>> affected_targets(
+    const std::vector<std::filesystem::path>& changed_files) const;
+
+  // Preprocess the translation units of the targets, or of every target when none are given,
+  // on the workers of the coordinator. The following check reuses the recorded include graphs.
+  // Returns the number of translation units preprocessed by the workers.
+  std::expected<size_t, std::string> scan_on_workers(
+    const std::vector<target_model::Target>& targets,
+    scanner::Scan_coordinator& coordinator);
+
+  // Check the targets, or every target when none are given. The targets are checked in
+  // parallel while the next ones are scanned. The check stops at the first target that is not
+  // part of the model.
+  Check_result check(const std::vector<target_model::Target>& targets,
+                     const Check_callbacks& callbacks = {});
+
+private:
+  struct Impl;
+
+  explicit Session(std::unique_ptr<Impl> impl);
+
+  std::unique_ptr<Impl> impl_;
+};
+} // namespace lwyi
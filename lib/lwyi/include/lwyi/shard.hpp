@@ -0,0 +1,44 @@
+// Copyright (c) 2025 Environmental Systems Research Institute, Inc.
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+
+#include <target_model/target.hpp>
+
+#include <cstdint>
+#include <expected>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace target_model
+{
+class Target_model;
+} // namespace target_model
+
+namespace lwyi
+{
+class Scan_profile;
+
+// One of count parts of a check, numbered from 1
+struct Shard
+{
+  uint32_t index{1};
+  uint32_t count{1};
+
+  auto operator<=>(const Shard&) const = default;
+};
+
+// Parse "K/N" with 1 <= K <= N
+std::expected<Shard, std::string> parse_shard(std::string_view text);
+
+// The targets checked by the shard, out of the given targets or every target in the model when
+// none are given. Targets are assigned to the least loaded shard, most expensive first, so every
+// shard takes about the same time. The cost of a target is its duration in the profile. Targets
+// that are not profiled are estimated from their number of translation units. The split only
+// depends on the targets and the profile, so every shard of a CI job computes the same one.
+std::vector<target_model::Target> select_shard(const target_model::Target_model& target_model,
+                                               const std::vector<target_model::Target>& targets,
+                                               const Scan_profile& profile,
+                                               Shard shard);
+} // namespace lwyi
@@ -0,0 +1,89 @@
+// Copyright (c) 2025 Environmental Systems Research Institute, Inc.
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+
+#include <target_model/target.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace target_model
+{
+class Target_model;
+} // namespace target_model
+
+namespace lwyi
+{
+// A directed graph of the vertices 0 to vertex_count - 1, with the successors of every vertex
+// stored next to each other
+class Digraph
+{
+public:
+  Digraph() = default;
+
+  // The successors of vertex v are successors[offsets[v]] to successors[offsets[v + 1] - 1]
+  Digraph(std::vector<uint32_t> offsets, std::vector<uint32_t> successors);
+
+  // The successors are in the order of the edges
+  Digraph(size_t vertex_count, std::span<const std::pair<uint32_t, uint32_t>> edges);
+
+  size_t vertex_count() const;
+  size_t edge_count() const;
+  std::span<const uint32_t> successors(uint32_t vertex) const;
+
+  // The graph with every edge turned around
+  Digraph reversed() const;
+
+private:
+  std::vector<uint32_t> offsets_{0};
+  std::vector<uint32_t> successors_;
+};
+
+// The dependencies of the targets of a model by target id. The targets of the model come first
+// in their order, followed by the dependencies that are not part of the model.
+class Target_graph
+{
+public:
+  explicit Target_graph(const target_model::Target_model& target_model);
+
+  size_t size() const;
+  const target_model::Target& target(uint32_t id) const;
+  std::optional<uint32_t> find(const target_model::Target& target) const;
+
+  const Digraph& dependencies() const;
+
+private:
+  std::vector<target_model::Target> targets_;
+  std::unordered_map<target_model::Target, uint32_t> ids_;
+  Digraph dependencies_;
+};
+
+// The strongly connected components of a graph, found with Tarjan's algorithm without
+// recursion. The components are numbered in reverse topological order, so the edges of the
+// condensation always lead to a component with a lower number.
+class Strongly_connected_components
+{
+public:
+  explicit Strongly_connected_components(const Digraph& graph);
+
+  size_t size() const;
+  uint32_t component(uint32_t vertex) const;
+  std::span<const uint32_t> members(uint32_t component) const;
+
+  // The graph of the components, with an edge between two components when any of their
+  // members are connected. There are no duplicate edges and no loops.
+  const Digraph& condensation() const;
+
+private:
+  std::vector<uint32_t> component_of_;
+  std::vector<uint32_t> member_offsets_{0};
+  std::vector<uint32_t> members_;
+  Digraph condensation_;
+};
+} // namespace lwyi
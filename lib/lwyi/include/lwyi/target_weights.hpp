@@ -0,0 +1,39 @@
+// Copyright (c) 2025 Environmental Systems Research Institute, Inc.
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+namespace target_model
+{
+class Target_model;
+} // namespace target_model
+
+namespace lwyi
+{
+class Scan_profile;
+class Target_graph;
+
+// What a target of the model costs to build when there is no measurement
+enum class Target_weight
+{
+  // the number of its sources
+  sources,
+  // the size of its sources in bytes, where a source that cannot be read has none
+  source_bytes,
+};
+
+// The weight of every target of the graph by id, where the targets outside of the model weigh
+// nothing
+std::vector<uint64_t> target_weights(const target_model::Target_model& target_model,
+                                     const Target_graph& graph,
+                                     Target_weight weight);
+
+// The milliseconds every target of the graph took in the profile. The targets that are not in
+// the profile or not part of the model take no time.
+std::vector<uint64_t> target_weights(const target_model::Target_model& target_model,
+                                     const Target_graph& graph,
+                                     const Scan_profile& profile);
+} // namespace lwyi
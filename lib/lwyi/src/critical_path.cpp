@@ -0,0 +1,129 @@
+// Copyright (c) 2025 Environmental Systems Research Institute, Inc.
+// SPDX-License-Identifier: Apache-2.0
+
+#include <lwyi/critical_path.hpp>
+
+#include <lwyi/target_graph.hpp>
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <utility>
+#include <vector>
+
+namespace lwyi
+{
+Critical_path::Critical_path(const Digraph& dag, std::span<const uint64_t> weights)
+: finish_(dag.vertex_count()),
+  slack_(dag.vertex_count()),
+  weights_(weights.begin(), weights.end())
+{
+  assert(weights.size() == dag.vertex_count());
+  const auto vertex_count = static_cast<uint32_t>(dag.vertex_count());
+
+  // the dependencies come first, so they are finished already
+  for (uint32_t v = 0; v < vertex_count; ++v)
+  {
+    uint64_t start = 0;
+    for (const auto w : dag.successors(v))
+    {
+      assert(w < v);
+      start = std::max(start, finish_[w]);
+    }
+    finish_[v] = start + weights_[v];
+    length_ = std::max(length_, finish_[v]);
+    total_weight_ += weights_[v];
+  }
+
+  // the longest time from the finish of every vertex to the end of the build, complete once all
+  // the vertices that depend on it are visited
+  std::vector<uint64_t> tail(vertex_count);
+  for (uint32_t v = vertex_count; v-- > 0;)
+  {
+    slack_[v] = length_ - finish_[v] - tail[v];
+    for (const auto w : dag.successors(v))
+    {
+      tail[w] = std::max(tail[w], tail[v] + weights_[v]);
+    }
+  }
+
+  // follow the dependency that finishes last back from the vertex that finishes last
+  const auto last = std::ranges::find(finish_, length_);
+  if (last != finish_.end())
+  {
+    auto v = static_cast<uint32_t>(last - finish_.begin());
+    while (true)
+    {
+      path_.push_back(v);
+      const auto successors = dag.successors(v);
+      if (earliest_start(v) == 0 || successors.empty())
+      {
+        break;
+      }
+      v = *std::ranges::max_element(successors,
+                                    [&](uint32_t lhs, uint32_t rhs)
+                                    {
+                                      return finish_[lhs] < finish_[rhs];
+                                    });
+    }
+    std::ranges::reverse(path_);
+  }
+
+  // sweep over the starts and finishes, with the finishes first when they are at the same time
+  std::vector<std::pair<uint64_t, bool>> events;
+  events.reserve(2 * vertex_count);
+  for (uint32_t v = 0; v < vertex_count; ++v)
+  {
+    if (weights_[v] != 0)
+    {
+      events.emplace_back(earliest_start(v), true);
+      events.emplace_back(finish_[v], false);
+    }
+  }
+  std::ranges::sort(events);
+  size_t building = 0;
+  for (const auto& [time, starts] : events)
+  {
+    if (starts)
+    {
+      peak_parallelism_ = std::max(peak_parallelism_, ++building);
+    }
+    else
+    {
+      --building;
+    }
+  }
+}
+
+uint64_t Critical_path::length() const
+{
+  return length_;
+}
+
+uint64_t Critical_path::total_weight() const
+{
+  return total_weight_;
+}
+
+std::span<const uint32_t> Critical_path::path() const
+{
+  return path_;
+}
+
+uint64_t Critical_path::earliest_start(uint32_t vertex) const
+{
+  return finish_[vertex] - weights_[vertex];
+}
+
+uint64_t Critical_path::slack(uint32_t vertex) const
+{
+  return slack_[vertex];
+}
+
+size_t Critical_path::peak_parallelism() const
+{
+  return peak_parallelism_;
+}
+} // namespace lwyi
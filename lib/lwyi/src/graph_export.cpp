@@ -0,0 +1,213 @@
+// Copyright (c) 2025 Environmental Systems Research Institute, Inc.
+// SPDX-License-Identifier: Apache-2.0
+
+#include <lwyi/graph_export.hpp>
+
+#include <lwyi/target_graph.hpp>
+#include <target_model/target.hpp>
+#include <target_model/target_data.hpp>
+#include <target_model/target_model.hpp>
+#include <util/buffered_writer.hpp>
+#include <util/utils.hpp>
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace lwyi
+{
+namespace
+{
+void write_padding(util::Buffered_writer& writer, uint64_t size)
+{
+  constexpr std::array<char, 8> padding{};
+  writer.write(std::string_view(padding.data(), edge_list::aligned(size) - size));
+}
+
+std::string_view kind_name(bool interface)
+{
+  return interface ? "interface" : "private";
+}
+
+std::string xml_escape(std::string_view text)
+{
+  std::string escaped;
+  escaped.reserve(text.size());
+  for (const char c : text)
+  {
+    switch (c)
+    {
+      case '&':
+        escaped += "&amp;";
+        break;
+      case '<':
+        escaped += "&lt;";
+        break;
+      case '>':
+        escaped += "&gt;";
+        break;
+      case '"':
+        escaped += "&quot;";
+        break;
+      default:
+        escaped += c;
+    }
+  }
+  return escaped;
+}
+} // namespace
+
+Graph_export::Graph_export(const target_model::Target_model& target_model,
+                           const Target_graph& graph,
+                           const Strongly_connected_components& components)
+: graph_(graph),
+  components_(components)
+{
+  // the targets of the model have the first ids in the same order
+  target_model.for_each_target(
+    [&](const target_model::Target& /*target*/, const target_model::Target_data& target_data)
+    { target_data_.push_back(&target_data); });
+}
+
+bool Graph_export::write_json(const std::filesystem::path& path) const
+{
+  util::Buffered_writer writer(path);
+  if (!writer.is_open())
+  {
+    return false;
+  }
+
+  writer.print("{{\"targets\": [");
+  const char* separator = "\n";
+  for (uint32_t v = 0; v < graph_.size(); ++v)
+  {
+    writer.print("{}{{\"name\": {}, \"scc\": {}, \"external\": {}, \"dependencies\": [",
+                 separator,
+                 util::json_quote(graph_.target(v).name),
+                 components_.component(v),
+                 target_data_.size() <= v);
+    const char* dependency_separator = "";
+    for (const auto w : graph_.dependencies().successors(v))
+    {
+      writer.print("{}{{\"target\": {}, \"kind\": \"{}\"}}",
+                   dependency_separator,
+                   w,
+                   kind_name(is_interface(v, w)));
+      dependency_separator = ", ";
+    }
+    writer.print("]}}");
+    separator = ",\n";
+  }
+  writer.print("\n]}}\n");
+  return writer.close();
+}
+
+bool Graph_export::write_graphml(const std::filesystem::path& path) const
+{
+  util::Buffered_writer writer(path);
+  if (!writer.is_open())
+  {
+    return false;
+  }
+
+  writer.print(R"(<?xml version="1.0" encoding="UTF-8"?>
+<graphml xmlns="http://graphml.graphdrawing.org/xmlns">
+  <key id="name" for="node" attr.name="name" attr.type="string"/>
+  <key id="scc" for="node" attr.name="scc" attr.type="int"/>
+  <key id="external" for="node" attr.name="external" attr.type="boolean"/>
+  <key id="kind" for="edge" attr.name="kind" attr.type="string"/>
+  <graph id="dependencies" edgedefault="directed">
+)");
+  for (uint32_t v = 0; v < graph_.size(); ++v)
+  {
+    writer.print("    <node id=\"n{}\"><data key=\"name\">{}</data><data key=\"scc\">{}</data>"
+                 "<data key=\"external\">{}</data></node>\n",
+                 v,
+                 xml_escape(graph_.target(v).name),
+                 components_.component(v),
+                 target_data_.size() <= v);
+  }
+  for (uint32_t v = 0; v < graph_.size(); ++v)
+  {
+    for (const auto w : graph_.dependencies().successors(v))
+    {
+      writer.print("    <edge source=\"n{}\" target=\"n{}\"><data key=\"kind\">{}</data></edge>\n",
+                   v,
+                   w,
+                   kind_name(is_interface(v, w)));
+    }
+  }
+  writer.print("  </graph>\n</graphml>\n");
+  return writer.close();
+}
+
+bool Graph_export::write_edge_list(const std::filesystem::path& path) const
+{
+  util::Buffered_writer writer(path, "wb");
+  if (!writer.is_open())
+  {
+    return false;
+  }
+
+  const auto target_count = static_cast<uint32_t>(graph_.size());
+  uint64_t string_bytes = 0U;
+  for (uint32_t v = 0; v < target_count; ++v)
+  {
+    string_bytes += graph_.target(v).name.size();
+  }
+
+  edge_list::Header header;
+  header.magic = edge_list::magic;
+  header.version = edge_list::version;
+  header.target_count = target_count;
+  header.string_bytes = string_bytes;
+  header.edge_count = graph_.dependencies().edge_count();
+  writer.write_value(header);
+
+  uint64_t offset = 0U;
+  writer.write_value(offset);
+  for (uint32_t v = 0; v < target_count; ++v)
+  {
+    offset += graph_.target(v).name.size();
+    writer.write_value(offset);
+  }
+
+  for (uint32_t v = 0; v < target_count; ++v)
+  {
+    writer.write(graph_.target(v).name);
+  }
+  write_padding(writer, string_bytes);
+
+  for (uint32_t v = 0; v < target_count; ++v)
+  {
+    writer.write_value(
+      edge_list::Target_entry{.scc = components_.component(v),
+                              .flags = target_data_.size() <= v ? edge_list::external_flag : 0U});
+  }
+
+  for (uint32_t v = 0; v < target_count; ++v)
+  {
+    for (const auto w : graph_.dependencies().successors(v))
+    {
+      using enum edge_list::Edge_kind;
+      writer.write_value(edge_list::Edge_entry{
+        .from = v,
+        .to = w,
+        .kind = is_interface(v, w) ? interface_dependency : private_dependency});
+    }
+  }
+  write_padding(writer, header.edge_count * sizeof(edge_list::Edge_entry));
+
+  return writer.close();
+}
+
+bool Graph_export::is_interface(uint32_t from, uint32_t to) const
+{
+  return from < target_data_.size() &&
+         target_data_[from]->interface_dependencies.contains(graph_.target(to));
+}
+} // namespace lwyi
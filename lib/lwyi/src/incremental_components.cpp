@@ -0,0 +1,287 @@
+// Copyright (c) 2025 Environmental Systems Research Institute, Inc.
+// SPDX-License-Identifier: Apache-2.0
+
+#include <lwyi/incremental_components.hpp>
+
+#include <lwyi/target_graph.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <numeric>
+#include <span>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace lwyi
+{
+namespace
+{
+constexpr uint32_t no_component = std::numeric_limits<uint32_t>::max();
+} // namespace
+
+Incremental_components::Incremental_components(const Digraph& graph)
+: successors_(graph.vertex_count()),
+  predecessors_(graph.vertex_count()),
+  component_of_(graph.vertex_count())
+{
+  for (uint32_t v = 0; v < graph.vertex_count(); ++v)
+  {
+    for (const auto w : graph.successors(v))
+    {
+      successors_[v].push_back(w);
+      predecessors_[w].push_back(v);
+    }
+  }
+
+  // the components are numbered in reverse topological order already
+  const Strongly_connected_components components(graph);
+  members_.resize(components.size());
+  for (uint32_t component = 0; component < components.size(); ++component)
+  {
+    const auto members = components.members(component);
+    members_[component].assign(members.begin(), members.end());
+    for (const auto member : members)
+    {
+      component_of_[member] = component;
+    }
+  }
+  order_.resize(components.size());
+  std::ranges::iota(order_, uint32_t{0});
+  position_ = order_;
+  forward_marks_.resize(components.size());
+  backward_marks_.resize(components.size());
+}
+
+void Incremental_components::add_edge(uint32_t from, uint32_t to)
+{
+  if (std::ranges::contains(successors_[from], to))
+  {
+    return;
+  }
+  successors_[from].push_back(to);
+  predecessors_[to].push_back(from);
+
+  const auto from_component = component_of_[from];
+  const auto to_component = component_of_[to];
+  const auto lower = position_[from_component];
+  const auto upper = position_[to_component];
+  if (from_component == to_component || upper < lower)
+  {
+    // the order is still topological
+    return;
+  }
+
+  // Only the components between the ends can be on a path from the new edge back to its start.
+  // Those reached from the edge must come before those that reach it.
+  ++change_;
+  auto forward = search(to_component, successors_, forward_marks_, lower, upper);
+  auto backward = search(from_component, predecessors_, backward_marks_, lower, upper);
+
+  std::vector<uint32_t> positions;
+  for (const auto component : forward)
+  {
+    positions.push_back(position_[component]);
+  }
+  for (const auto component : backward)
+  {
+    if (forward_marks_[component] != change_)
+    {
+      positions.push_back(position_[component]);
+    }
+  }
+  std::ranges::sort(positions);
+  const auto by_position = [&](uint32_t lhs, uint32_t rhs)
+  {
+    return position_[lhs] < position_[rhs];
+  };
+  std::ranges::sort(forward, by_position);
+  std::ranges::sort(backward, by_position);
+
+  // Those reached from the edge take the lowest positions and those that reach it the highest,
+  // so none of them moves past a component that is not affected. With a cycle, the components
+  // that are both become a single one in between, and the positions left over are removed.
+  std::vector<uint32_t> reached;
+  std::vector<uint32_t> reaching;
+  const bool cycle = forward_marks_[from_component] == change_;
+  for (const auto component : forward)
+  {
+    if (!cycle || backward_marks_[component] != change_)
+    {
+      reached.push_back(component);
+    }
+    else if (component != from_component)
+    {
+      for (const auto member : members_[component])
+      {
+        component_of_[member] = from_component;
+      }
+      auto& merged = members_[from_component];
+      merged.insert(merged.end(), members_[component].begin(), members_[component].end());
+      members_[component].clear();
+    }
+  }
+  for (const auto component : backward)
+  {
+    if (!cycle || forward_marks_[component] != change_)
+    {
+      reaching.push_back(component);
+    }
+  }
+
+  for (const auto position : positions)
+  {
+    order_[position] = no_component;
+  }
+  const auto place = [&](uint32_t component, uint32_t position)
+  {
+    order_[position] = component;
+    position_[component] = position;
+  };
+  for (size_t i = 0; i < reached.size(); ++i)
+  {
+    place(reached[i], positions[i]);
+  }
+  const auto first_reaching = positions.size() - reaching.size();
+  for (size_t i = 0; i < reaching.size(); ++i)
+  {
+    place(reaching[i], positions[first_reaching + i]);
+  }
+  if (cycle)
+  {
+    place(from_component, positions[reached.size()]);
+    if (reached.size() + 1 < first_reaching)
+    {
+      std::erase(order_, no_component);
+      update_positions(positions[reached.size() + 1]);
+    }
+  }
+}
+
+void Incremental_components::remove_edge(uint32_t from, uint32_t to)
+{
+  auto& successors = successors_[from];
+  const auto successor = std::ranges::find(successors, to);
+  if (successor == successors.end())
+  {
+    return;
+  }
+  successors.erase(successor);
+  auto& predecessors = predecessors_[to];
+  predecessors.erase(std::ranges::find(predecessors, from));
+
+  const auto component = component_of_[from];
+  if (component != component_of_[to])
+  {
+    return;
+  }
+
+  // search the edges inside of the component again
+  const auto old_members = members_[component];
+  std::unordered_map<uint32_t, uint32_t> local_ids;
+  for (uint32_t i = 0; i < old_members.size(); ++i)
+  {
+    local_ids.emplace(old_members[i], i);
+  }
+  std::vector<std::pair<uint32_t, uint32_t>> edges;
+  for (uint32_t i = 0; i < old_members.size(); ++i)
+  {
+    for (const auto w : successors_[old_members[i]])
+    {
+      if (component_of_[w] == component)
+      {
+        edges.emplace_back(i, local_ids.at(w));
+      }
+    }
+  }
+  const Strongly_connected_components split(Digraph(old_members.size(), edges));
+  if (split.size() == 1)
+  {
+    return;
+  }
+
+  // the parts take the place of the component in the order, the first one keeps its id
+  std::vector<uint32_t> ids(split.size());
+  for (uint32_t part = 0; part < split.size(); ++part)
+  {
+    ids[part] = part == 0 ? component : static_cast<uint32_t>(members_.size());
+    if (part != 0)
+    {
+      members_.emplace_back();
+    }
+    auto& members = members_[ids[part]];
+    members.clear();
+    for (const auto local_id : split.members(part))
+    {
+      members.push_back(old_members[local_id]);
+      component_of_[old_members[local_id]] = ids[part];
+    }
+  }
+  position_.resize(members_.size());
+  forward_marks_.resize(members_.size());
+  backward_marks_.resize(members_.size());
+
+  const auto position = position_[component];
+  order_.erase(order_.begin() + position);
+  order_.insert(order_.begin() + position, ids.begin(), ids.end());
+  update_positions(position);
+}
+
+size_t Incremental_components::size() const
+{
+  return order_.size();
+}
+
+uint32_t Incremental_components::component(uint32_t vertex) const
+{
+  return component_of_[vertex];
+}
+
+std::span<const uint32_t> Incremental_components::members(uint32_t component) const
+{
+  return members_[component];
+}
+
+std::span<const uint32_t> Incremental_components::order() const
+{
+  return order_;
+}
+
+std::vector<uint32_t> Incremental_components::search(
+  uint32_t component,
+  const std::vector<std::vector<uint32_t>>& edges,
+  std::vector<uint32_t>& marks,
+  uint32_t first_position,
+  uint32_t last_position)
+{
+  std::vector<uint32_t> found{component};
+  marks[component] = change_;
+  for (size_t next = 0; next < found.size(); ++next)
+  {
+    for (const auto member : members_[found[next]])
+    {
+      for (const auto w : edges[member])
+      {
+        const auto reached = component_of_[w];
+        const auto position = position_[reached];
+        if (marks[reached] != change_ && first_position <= position && position <= last_position)
+        {
+          marks[reached] = change_;
+          found.push_back(reached);
+        }
+      }
+    }
+  }
+  return found;
+}
+
+void Incremental_components::update_positions(size_t first)
+{
+  for (size_t i = first; i < order_.size(); ++i)
+  {
+    position_[order_[i]] = static_cast<uint32_t>(i);
+  }
+}
+} // namespace lwyi
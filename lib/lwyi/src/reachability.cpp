@@ -0,0 +1,169 @@
+// Copyright (c) 2025 Environmental Systems Research Institute, Inc.
+// SPDX-License-Identifier: Apache-2.0
+
+#include <lwyi/reachability.hpp>
+
+#include <lwyi/target_graph.hpp>
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <span>
+#include <utility>
+#include <vector>
+
+namespace lwyi
+{
+namespace
+{
+constexpr uint32_t no_vertex = std::numeric_limits<uint32_t>::max();
+} // namespace
+
+Reachability::Reachability(const Digraph& dag)
+: words_per_vertex_((dag.vertex_count() + 63) / 64),
+  reached_(dag.vertex_count() * words_per_vertex_)
+{
+  // the successors come first, so their bitsets are complete
+  for (uint32_t v = 0; v < dag.vertex_count(); ++v)
+  {
+    auto* row = reached_.data() + v * words_per_vertex_;
+    for (const auto w : dag.successors(v))
+    {
+      assert(w < v);
+      const auto* successor_row = reached_.data() + w * words_per_vertex_;
+      // only the words up to the successor can have bits set
+      const auto word_count = w / 64 + 1;
+      for (size_t i = 0; i < word_count; ++i)
+      {
+        row[i] |= successor_row[i];
+      }
+      row[w / 64] |= uint64_t{1} << (w % 64);
+    }
+  }
+}
+
+bool Reachability::reaches(uint32_t from, uint32_t to) const
+{
+  return (reached(from)[to / 64] >> (to % 64) & 1U) != 0;
+}
+
+std::span<const uint64_t> Reachability::reached(uint32_t from) const
+{
+  return std::span(reached_).subspan(from * words_per_vertex_, words_per_vertex_);
+}
+
+std::vector<uint32_t> shortest_path(const Digraph& graph, uint32_t from, uint32_t to)
+{
+  // breadth-first search, remembering where every vertex was reached from
+  std::vector<uint32_t> parent(graph.vertex_count(), no_vertex);
+  std::vector<uint32_t> queue{from};
+  parent[from] = from;
+  for (size_t next = 0; next < queue.size(); ++next)
+  {
+    const auto v = queue[next];
+    for (const auto w : graph.successors(v))
+    {
+      if (w == to)
+      {
+        std::vector<uint32_t> path{to};
+        for (auto u = v; u != from; u = parent[u])
+        {
+          path.push_back(u);
+        }
+        path.push_back(from);
+        std::ranges::reverse(path);
+        return path;
+      }
+      if (parent[w] == no_vertex)
+      {
+        parent[w] = v;
+        queue.push_back(w);
+      }
+    }
+  }
+  return {};
+}
+
+std::vector<uint64_t> reached_from(const Digraph& graph, std::span<const uint32_t> starts)
+{
+  std::vector<uint64_t> reached((graph.vertex_count() + 63) / 64);
+  const auto visit = [&](uint32_t v)
+  {
+    auto& word = reached[v / 64];
+    const auto bit = uint64_t{1} << (v % 64);
+    const bool visited = (word & bit) != 0;
+    word |= bit;
+    return !visited;
+  };
+
+  std::vector<uint32_t> queue;
+  for (const auto start : starts)
+  {
+    if (visit(start))
+    {
+      queue.push_back(start);
+    }
+  }
+  for (size_t next = 0; next < queue.size(); ++next)
+  {
+    for (const auto w : graph.successors(queue[next]))
+    {
+      if (visit(w))
+      {
+        queue.push_back(w);
+      }
+    }
+  }
+  return reached;
+}
+
+Digraph transitive_reduction(const Digraph& dag)
+{
+  const Reachability reachability(dag);
+  std::vector<uint64_t> implied((dag.vertex_count() + 63) / 64);
+  std::vector<uint32_t> by_number;
+  std::vector<uint32_t> offsets{0};
+  std::vector<uint32_t> successors;
+  offsets.reserve(dag.vertex_count() + 1);
+  for (uint32_t v = 0; v < dag.vertex_count(); ++v)
+  {
+    const auto direct = dag.successors(v);
+    if (direct.empty())
+    {
+      offsets.push_back(static_cast<uint32_t>(successors.size()));
+      continue;
+    }
+
+    // A successor can only be reached through one with a higher number, so those come first.
+    // Once all are visited, a successor is implied exactly when it was implied on its turn.
+    by_number.assign(direct.begin(), direct.end());
+    std::ranges::sort(by_number, std::greater{});
+    const auto word_count = by_number.front() / 64 + 1;
+    std::fill_n(implied.begin(), word_count, uint64_t{0});
+    for (const auto w : by_number)
+    {
+      if ((implied[w / 64] >> (w % 64) & 1U) != 0)
+      {
+        continue;
+      }
+      const auto reached = reachability.reached(w);
+      for (size_t i = 0; i < w / 64 + 1; ++i)
+      {
+        implied[i] |= reached[i];
+      }
+    }
+    for (const auto w : direct)
+    {
+      if ((implied[w / 64] >> (w % 64) & 1U) == 0)
+      {
+        successors.push_back(w);
+      }
+    }
+    offsets.push_back(static_cast<uint32_t>(successors.size()));
+  }
+  return {std::move(offsets), std::move(successors)};
+}
+} // namespace lwyi
@@ -0,0 +1,454 @@
+// Copyright (c) 2025 Environmental Systems Research Institute, Inc.
+// SPDX-License-Identifier: Apache-2.0
+
+#include <lwyi/result_file.hpp>
+
+#include <lwyi/check_target.hpp>
+#include <lwyi/dependency_visibility.hpp>
+#include <lwyi/session.hpp>
+#include <lwyi/shard.hpp>
+#include <scanner/include.hpp>
+#include <util/utils.hpp>
+
+#include <simdjson.h>
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <expected>
+#include <filesystem>
+#include <format>
+#include <fstream>
+#include <ios>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <utility>
+
+// The result file is a JSON object:
+//   {"version": 1,
+//    "shard": {"index": 1, "count": 4},
+//    "targets": [{"name": "liba", "status": "checked", "duration_ms": 1200, "scan_error": "",
+//                 "errors": [{"target": "libb", "linked": "private", "included": "public",
+//                             "sample_includes": [{"path": "/src/b.hpp",
+//                                                  "include_chain": [{"source": "/src/a.hpp",
+//                                                                     "line": 3}]}]}]}]}
+
+namespace lwyi
+{
+namespace
+{
+constexpr std::array status_names{"checked", "no_sources", "unknown_target", "scan_failed"};
+
+std::string_view visibility_name(Dependency_visibility visibility)
+{
+  switch (visibility)
+  {
+    case Dependency_visibility::none:
+      return "none";
+    case Dependency_visibility::private_scope:
+      return "private";
+    case Dependency_visibility::interface_scope:
+      return "interface";
+    case Dependency_visibility::public_scope:
+      return "public";
+  }
+  return "none";
+}
+
+std::expected<Dependency_visibility, std::string> parse_visibility(std::string_view name)
+{
+  for (auto visibility : {Dependency_visibility::none,
+                          Dependency_visibility::private_scope,
+                          Dependency_visibility::interface_scope,
+                          Dependency_visibility::public_scope})
+  {
+    if (visibility_name(visibility) == name)
+    {
+      return visibility;
+    }
+  }
+  return std::unexpected(std::format("Unknown visibility {}", name));
+}
+
+std::expected<Target_result::Status, std::string> parse_status(std::string_view name)
+{
+  for (size_t i = 0; i < status_names.size(); ++i)
+  {
+    if (status_names[i] == name)
+    {
+      return static_cast<Target_result::Status>(i);
+    }
+  }
+  return std::unexpected(std::format("Unknown status {}", name));
+}
+
+void write_include(std::ostream& os, const scanner::Include& include)
+{
+  os << "{\"path\": " << util::json_quote(include.path.generic_string())
+     << ", \"include_chain\": [";
+  const char* separator = "";
+  for (const auto& source_line : include.include_chain)
+  {
+    os << separator << "{\"source\": " << util::json_quote(source_line.source.generic_string())
+       << ", \"line\": " << source_line.line << "}";
+    separator = ", ";
+  }
+  os << "]}";
+}
+
+void write_error(std::ostream& os, const LWYI_error& error)
+{
+  os << "{\"target\": " << util::json_quote(error.target.name) << ", \"linked\": \""
+     << visibility_name(error.linked_visibility) << "\", \"included\": \""
+     << visibility_name(error.included_visibility) << "\", \"sample_includes\": [";
+  const char* separator = "";
+  for (const auto& include : error.sample_includes)
+  {
+    os << separator;
+    write_include(os, include);
+    separator = ", ";
+  }
+  os << "]}";
+}
+
+void write_target_result(std::ostream& os, const Target_result& target_result)
+{
+  os << "{\"name\": " << util::json_quote(target_result.target.name) << ", \"status\": \""
+     << status_names.at(static_cast<size_t>(target_result.status))
+     << "\", \"duration_ms\": " << target_result.duration.count()
+     << ", \"scan_error\": " << util::json_quote(target_result.scan_error) << ", \"errors\": [";
+  const char* separator = "";
+  for (const auto& error : target_result.errors)
+  {
+    os << separator;
+    write_error(os, error);
+    separator = ", ";
+  }
+  os << "]}";
+}
+
+std::unexpected<std::string> json_error(simdjson::error_code error)
+{
+  return std::unexpected(std::string(simdjson::error_message(error)));
+}
+
+template <typename T>
+std::expected<void, std::string> get_value(simdjson::ondemand::value value, T& result)
+{
+  if (auto error = value.get(result))
+  {
+    return json_error(error);
+  }
+  return {};
+}
+
+std::expected<void, std::string> get_string(simdjson::ondemand::value value, std::string& result)
+{
+  std::string_view text;
+  if (auto parsed = get_value(value, text); !parsed)
+  {
+    return parsed;
+  }
+  result = text;
+  return {};
+}
+
+template <typename Parse_name>
+std::expected<void, std::string> get_enum(simdjson::ondemand::value value,
+                                          Parse_name parse_name,
+                                          auto& result)
+{
+  std::string_view name;
+  if (auto parsed = get_value(value, name); !parsed)
+  {
+    return parsed;
+  }
+  auto enum_value = parse_name(name);
+  if (!enum_value)
+  {
+    return std::unexpected(enum_value.error());
+  }
+  result = *enum_value;
+  return {};
+}
+
+// Call parse_field(key, value) for every field of the object
+template <typename Parse_field>
+std::expected<void, std::string> parse_object(simdjson::ondemand::value value,
+                                              Parse_field&& parse_field)
+{
+  simdjson::ondemand::object object;
+  if (auto error = value.get_object().get(object))
+  {
+    return json_error(error);
+  }
+  for (auto field : object)
+  {
+    std::string_view key;
+    if (auto error = field.unescaped_key().get(key))
+    {
+      return json_error(error);
+    }
+    simdjson::ondemand::value field_value;
+    if (auto error = field.value().get(field_value))
+    {
+      return json_error(error);
+    }
+    if (auto parsed = parse_field(key, field_value); !parsed)
+    {
+      return parsed;
+    }
+  }
+  return {};
+}
+
+// Call parse_element(value) for every element of the array
+template <typename Parse_element>
+std::expected<void, std::string> parse_array(simdjson::ondemand::value value,
+                                             Parse_element&& parse_element)
+{
+  simdjson::ondemand::array array;
+  if (auto error = value.get_array().get(array))
+  {
+    return json_error(error);
+  }
+  for (auto element : array)
+  {
+    simdjson::ondemand::value element_value;
+    if (auto error = element.get(element_value))
+    {
+      return json_error(error);
+    }
+    if (auto parsed = parse_element(element_value); !parsed)
+    {
+      return parsed;
+    }
+  }
+  return {};
+}
+
+std::expected<void, std::string> parse_source_line(simdjson::ondemand::value value,
+                                                   scanner::Source_line& source_line)
+{
+  return parse_object(
+    value,
+    [&](std::string_view key, simdjson::ondemand::value field) -> std::expected<void, std::string>
+    {
+      if (key == "source")
+      {
+        std::string source;
+        auto parsed = get_string(field, source);
+        source_line.source = source;
+        return parsed;
+      }
+      if (key == "line")
+      {
+        uint64_t line = 0;
+        auto parsed = get_value(field, line);
+        source_line.line = static_cast<uint32_t>(line);
+        return parsed;
+      }
+      return {};
+    });
+}
+
+std::expected<void, std::string> parse_include(simdjson::ondemand::value value,
+                                               scanner::Include& include)
+{
+  return parse_object(
+    value,
+    [&](std::string_view key, simdjson::ondemand::value field) -> std::expected<void, std::string>
+    {
+      if (key == "path")
+      {
+        std::string path;
+        auto parsed = get_string(field, path);
+        include.path = path;
+        return parsed;
+      }
+      if (key == "include_chain")
+      {
+        return parse_array(field,
+                           [&](simdjson::ondemand::value element)
+                           {
+                             return parse_source_line(element,
+                                                      include.include_chain.emplace_back());
+                           });
+      }
+      return {};
+    });
+}
+
+std::expected<void, std::string> parse_error(simdjson::ondemand::value value, LWYI_error& error)
+{
+  return parse_object(
+    value,
+    [&](std::string_view key, simdjson::ondemand::value field) -> std::expected<void, std::string>
+    {
+      if (key == "target")
+      {
+        return get_string(field, error.target.name);
+      }
+      if (key == "linked")
+      {
+        return get_enum(field, parse_visibility, error.linked_visibility);
+      }
+      if (key == "included")
+      {
+        return get_enum(field, parse_visibility, error.included_visibility);
+      }
+      if (key == "sample_includes")
+      {
+        return parse_array(field,
+                           [&](simdjson::ondemand::value element)
+                           { return parse_include(element, error.sample_includes.emplace_back()); });
+      }
+      return {};
+    });
+}
+
+std::expected<void, std::string> parse_target_result(simdjson::ondemand::value value,
+                                                     Target_result& target_result)
+{
+  return parse_object(
+    value,
+    [&](std::string_view key, simdjson::ondemand::value field) -> std::expected<void, std::string>
+    {
+      if (key == "name")
+      {
+        return get_string(field, target_result.target.name);
+      }
+      if (key == "status")
+      {
+        return get_enum(field, parse_status, target_result.status);
+      }
+      if (key == "duration_ms")
+      {
+        uint64_t milliseconds = 0;
+        auto parsed = get_value(field, milliseconds);
+        target_result.duration = std::chrono::milliseconds(milliseconds);
+        return parsed;
+      }
+      if (key == "scan_error")
+      {
+        return get_string(field, target_result.scan_error);
+      }
+      if (key == "errors")
+      {
+        return parse_array(field,
+                           [&](simdjson::ondemand::value element)
+                           { return parse_error(element, target_result.errors.emplace_back()); });
+      }
+      return {};
+    });
+}
+
+std::expected<void, std::string> parse_shard_object(simdjson::ondemand::value value,
+                                                    Shard& shard)
+{
+  return parse_object(
+    value,
+    [&](std::string_view key, simdjson::ondemand::value field) -> std::expected<void, std::string>
+    {
+      if (key != "index" && key != "count")
+      {
+        return {};
+      }
+      uint64_t number = 0;
+      auto parsed = get_value(field, number);
+      (key == "index" ? shard.index : shard.count) = static_cast<uint32_t>(number);
+      return parsed;
+    });
+}
+} // namespace
+
+std::expected<void, std::string> write_result_file(const std::filesystem::path& path,
+                                                   const Shard_result& shard_result)
+{
+  std::ofstream ofs(path, std::ios::out | std::ios::trunc);
+  if (ofs.fail())
+  {
+    return std::unexpected(std::format("Failed to open {}", path.string()));
+  }
+
+  ofs << "{\n  \"version\": 1,\n  \"shard\": {\"index\": " << shard_result.shard.index
+      << ", \"count\": " << shard_result.shard.count << "},\n  \"targets\": [";
+  const char* separator = "\n    ";
+  for (const auto& target_result : shard_result.result.targets)
+  {
+    ofs << separator;
+    write_target_result(ofs, target_result);
+    separator = ",\n    ";
+  }
+  ofs << (shard_result.result.targets.empty() ? "]\n}\n" : "\n  ]\n}\n");
+
+  if (ofs.flush().fail())
+  {
+    return std::unexpected(std::format("Failed to write {}", path.string()));
+  }
+
+  return {};
+}
+
+std::expected<Shard_result, std::string> read_result_file(const std::filesystem::path& path)
+{
+  simdjson::padded_string json;
+  if (auto error = simdjson::padded_string::load(path.string()).get(json))
+  {
+    return std::unexpected(
+      std::format("Failed to load {}: {}", path.string(), simdjson::error_message(error)));
+  }
+
+  simdjson::ondemand::parser parser;
+  simdjson::ondemand::document doc;
+  simdjson::ondemand::value root;
+  if (auto error = parser.iterate(json).get(doc))
+  {
+    return std::unexpected(
+      std::format("Failed to parse {}: {}", path.string(), simdjson::error_message(error)));
+  }
+  if (auto error = doc.get_value().get(root))
+  {
+    return std::unexpected(
+      std::format("Failed to parse {}: {}", path.string(), simdjson::error_message(error)));
+  }
+
+  Shard_result shard_result;
+  uint64_t version = 0;
+  auto parsed = parse_object(
+    root,
+    [&](std::string_view key, simdjson::ondemand::value field) -> std::expected<void, std::string>
+    {
+      if (key == "version")
+      {
+        return get_value(field, version);
+      }
+      if (key == "shard")
+      {
+        return parse_shard_object(field, shard_result.shard);
+      }
+      if (key == "targets")
+      {
+        return parse_array(field,
+                           [&](simdjson::ondemand::value element)
+                           {
+                             return parse_target_result(
+                               element, shard_result.result.targets.emplace_back());
+                           });
+      }
+      return {};
+    });
+  if (!parsed)
+  {
+    return std::unexpected(std::format("Failed to parse {}: {}", path.string(), parsed.error()));
+  }
+  if (version != 1)
+  {
+    return std::unexpected(
+      std::format("Unsupported result file version {} in {}", version, path.string()));
+  }
+
+  return shard_result;
+}
+} // namespace lwyi
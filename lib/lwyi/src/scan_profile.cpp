@@ -0,0 +1,135 @@
+// Copyright (c) 2025 Environmental Systems Research Institute, Inc.
+// SPDX-License-Identifier: Apache-2.0
+
+#include <lwyi/scan_profile.hpp>
+
+#include <lwyi/session.hpp>
+#include <target_model/target.hpp>
+#include <util/utils.hpp>
+
+#include <simdjson.h>
+
+#include <chrono>
+#include <cstdint>
+#include <expected>
+#include <filesystem>
+#include <format>
+#include <fstream>
+#include <ios>
+#include <optional>
+#include <string>
+#include <string_view>
+
+namespace lwyi
+{
+// The file is a JSON object with the duration of each target in milliseconds:
+//   {"version": 1, "targets": {"liba": 1200, "libb": 300}}
+std::expected<Scan_profile, std::string> Scan_profile::load(const std::filesystem::path& path)
+{
+  const auto format_error = [&](simdjson::error_code error)
+  {
+    return std::unexpected(std::format(
+      "Failed to load scan profile {}: {}", path.string(), simdjson::error_message(error)));
+  };
+
+  simdjson::padded_string json;
+  if (auto error = simdjson::padded_string::load(path.string()).get(json))
+  {
+    return format_error(error);
+  }
+
+  simdjson::ondemand::parser parser;
+  simdjson::ondemand::document doc;
+  if (auto error = parser.iterate(json).get(doc))
+  {
+    return format_error(error);
+  }
+
+  uint64_t version = 0;
+  if (auto error = doc["version"].get_uint64().get(version))
+  {
+    return format_error(error);
+  }
+  if (version != 1)
+  {
+    return std::unexpected(
+      std::format("Unsupported scan profile version {} in {}", version, path.string()));
+  }
+
+  simdjson::ondemand::object targets;
+  if (auto error = doc["targets"].get_object().get(targets))
+  {
+    return format_error(error);
+  }
+
+  Scan_profile profile;
+  for (auto field : targets)
+  {
+    std::string_view name;
+    uint64_t milliseconds = 0;
+    if (auto error = field.unescaped_key().get(name))
+    {
+      return format_error(error);
+    }
+    if (auto error = field.value().get_uint64().get(milliseconds))
+    {
+      return format_error(error);
+    }
+    profile.durations_[target_model::Target{std::string(name)}] =
+      std::chrono::milliseconds(milliseconds);
+  }
+
+  return profile;
+}
+
+std::expected<void, std::string> Scan_profile::save(const std::filesystem::path& path) const
+{
+  std::ofstream ofs(path, std::ios::out | std::ios::trunc);
+  if (ofs.fail())
+  {
+    return std::unexpected(std::format("Failed to open {}", path.string()));
+  }
+
+  ofs << "{\n  \"version\": 1,\n  \"targets\": {";
+  const char* separator = "\n";
+  for (const auto& [target, duration] : durations_)
+  {
+    ofs << separator << "    " << util::json_quote(target.name) << ": " << duration.count();
+    separator = ",\n";
+  }
+  ofs << "\n  }\n}\n";
+
+  if (ofs.flush().fail())
+  {
+    return std::unexpected(std::format("Failed to write {}", path.string()));
+  }
+
+  return {};
+}
+
+void Scan_profile::record(const Check_result& result)
+{
+  for (const auto& target_result : result.targets)
+  {
+    if (target_result.status == Target_result::Status::checked)
+    {
+      durations_[target_result.target] = target_result.duration;
+    }
+  }
+}
+
+std::optional<std::chrono::milliseconds> Scan_profile::duration(
+  const target_model::Target& target) const
+{
+  if (auto it = durations_.find(target); it != durations_.end())
+  {
+    return it->second;
+  }
+  return std::nullopt;
+}
+
+bool Scan_profile::empty() const
+{
+  return durations_.empty();
+}
+} // namespace lwyi
@@ -0,0 +1,472 @@
+// Copyright (c) 2025 Environmental Systems Research Institute, Inc.
+// SPDX-License-Identifier: Apache-2.0
+
+#include <lwyi/session.hpp>
+
+#include <lwyi/check_target.hpp>
+#include <message/message.hpp>
+#include <scanner/include_index.hpp>
+#include <scanner/scan.hpp>
+#include <target_model/target.hpp>
+#include <target_model/target_data.hpp>
+#include <target_model/target_model.hpp>
+#include <target_model/target_model_loader.hpp>
+#include <util/parallel.hpp>
+#include <util/parallel_transformer.hpp>
+#include <util/utils.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <expected>
+#include <filesystem>
+#include <format>
+#include <fstream>
+#include <future>
+#include <ios>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <set>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace lwyi
+{
+namespace
+{
+constexpr const char* info_filename = "link_what_you_include_info.json";
+constexpr const char* include_graphs_filename = "lwyi_include_graphs.db";
+
+// The source directory the build directory was configured for, if it is a CMake build directory
+std::optional<std::filesystem::path> cmake_home_directory(const std::filesystem::path& binary_dir)
+{
+  constexpr std::string_view key = "CMAKE_HOME_DIRECTORY:INTERNAL=";
+  std::ifstream ifs(binary_dir / "CMakeCache.txt", std::ios::in);
+  std::string line;
+  while (std::getline(ifs, line))
+  {
+    if (line.starts_with(key))
+    {
+      return std::filesystem::path(line.substr(key.size()));
+    }
+  }
+  return std::nullopt;
+}
+
+// The directory the relative paths of a list of changed files are relative to. Lists like the
+// output of git diff --name-only are relative to the root of the repository of the sources,
+// wherever lwyi is run from.
+std::filesystem::path changed_files_root(const std::filesystem::path& binary_dir,
+                                         const std::filesystem::path& working_dir)
+{
+  const auto source_dir = cmake_home_directory(binary_dir).value_or(working_dir);
+  return util::repository_root(source_dir).value_or(source_dir);
+}
+} // namespace
+
+std::expected<target_model::Target_model, std::string> load_target_model(
+  const std::filesystem::path& binary_dir,
+  size_t thread_count)
+{
+  const auto info_file = binary_dir / info_filename;
+  if (!std::filesystem::is_regular_file(info_file))
+  {
+    return std::unexpected(std::format("error: {} is not a file", info_file.string()));
+  }
+
+  auto loader = target_model::Target_model_loader::create(thread_count);
+  const auto load_result = loader->load_json(info_file);
+  if (!load_result.has_value())
+  {
+    return std::unexpected(
+      std::format("error: failed to load {}: {}", info_file.string(), load_result.error()));
+  }
+  return loader->make_target_model();
+}
+
+std::expected<std::vector<std::filesystem::path>, std::string> read_changed_files(
+  const std::filesystem::path& list_path,
+  const std::filesystem::path& binary_dir,
+  const std::filesystem::path& working_dir)
+{
+  return util::read_path_list(list_path, changed_files_root(binary_dir, working_dir));
+}
+
+bool Target_result::success() const
+{
+  return status == Status::no_sources || (status == Status::checked && errors.empty());
+}
+
+bool Check_result::success() const
+{
+  return std::ranges::all_of(targets, &Target_result::success);
+}
+
+struct Session::Impl
+{
+  Impl(std::filesystem::path dir,
+       target_model::Target_model model,
+       std::unique_ptr<scanner::Scanner> target_scanner)
+  : binary_dir(std::move(dir)),
+    target_model(std::move(model)),
+    scanner(std::move(target_scanner)),
+    pipeline(std::max(scanner->thread_count(), size_t{2}))
+  {
+  }
+
+  // A target whose includes were scanned but not yet checked
+  struct Scanned_target
+  {
+    Target_result result;
+    std::optional<scanner::Intransitive_includes> includes;
+    // the messages of the scan, printed when the target is reported
+    std::string messages;
+  };
+
+  Scanned_target scan_target(const target_model::Target& target,
+                             const target_model::Target_data& target_data)
+  {
+    Scanned_target scanned;
+    scanned.result.target = target;
+    if (target_data.sources.empty() && target_data.verify_interface_header_sets_sources.empty())
+    {
+      scanned.result.status = Target_result::Status::no_sources;
+      return scanned;
+    }
+
+    // the scanner uses all of its threads for one target at a time
+    std::scoped_lock lock(scan_mutex);
+    const auto start = std::chrono::steady_clock::now();
+    auto includes = scanner->scan(binary_dir, target_data);
+    scanned.result.duration = std::chrono::duration_cast<std::chrono::milliseconds>(
+      std::chrono::steady_clock::now() - start);
+    if (!includes.has_value())
+    {
+      scanned.result.status = Target_result::Status::scan_failed;
+      scanned.result.scan_error = std::move(includes.error());
+      return scanned;
+    }
+    scanned.includes = std::move(*includes);
+    return scanned;
+  }
+
+  Target_result check_target(Scanned_target scanned,
+                             const target_model::Target_data& target_data) const
+  {
+    auto result = std::move(scanned.result);
+    if (!scanned.includes)
+    {
+      return result;
+    }
+
+    const auto start = std::chrono::steady_clock::now();
+    result.errors =
+      lwyi::check_target(target_model, result.target, target_data, *scanned.includes);
+    result.duration += std::chrono::duration_cast<std::chrono::milliseconds>(
+      std::chrono::steady_clock::now() - start);
+
+    // TODO: consider enabling the following with a command line option
+#if 0
+    // special case: ignore linked PUBLIC but included INTERFACE errors
+    std::erase_if(result.errors,
+                  [](const LWYI_error& error)
+                  {
+                    return error.linked_visibility == Dependency_visibility::public_scope &&
+                           error.included_visibility == Dependency_visibility::interface_scope;
+                  });
+#endif
+
+    return result;
+  }
+
+  std::filesystem::path binary_dir;
+  target_model::Target_model target_model;
+  std::unique_ptr<scanner::Scanner> scanner;
+  std::mutex scan_mutex;
+  // checks targets while the next one is scanned
+  util::Parallel_transformer pipeline;
+  bool fail_fast{false};
+};
+
+Session::Session(std::unique_ptr<Impl> impl)
+: impl_(std::move(impl))
+{
+}
+
+Session::~Session() = default;
+Session::Session(Session&& other) noexcept = default;
+Session& Session::operator=(Session&& other) noexcept = default;
+
+std::expected<Session, std::string> Session::open(const std::filesystem::path& binary_dir,
+                                                  size_t thread_count)
+{
+  // the first scan needs the compilation database, read it while the model loads. A database
+  // that fails to load is reported by the scans.
+  auto scanner = std::make_unique<scanner::Scanner>(thread_count);
+  auto compilation_database = std::async(std::launch::async,
+                                         [&]()
+                                         {
+                                           return scanner->load_compilation_database(binary_dir);
+                                         });
+  auto target_model = load_target_model(binary_dir, thread_count);
+  compilation_database.wait();
+  if (!target_model.has_value())
+  {
+    return std::unexpected(target_model.error());
+  }
+
+  return Session(
+    std::make_unique<Impl>(binary_dir, std::move(*target_model), std::move(scanner)));
+}
+
+const std::filesystem::path& Session::binary_dir() const
+{
+  return impl_->binary_dir;
+}
+
+const target_model::Target_model& Session::target_model() const
+{
+  return impl_->target_model;
+}
+
+size_t Session::thread_count() const
+{
+  return impl_->scanner->thread_count();
+}
+
+std::expected<void, std::string> Session::reload_model()
+{
+  auto target_model = load_target_model(impl_->binary_dir, thread_count());
+  if (!target_model.has_value())
+  {
+    return std::unexpected(target_model.error());
+  }
+
+  impl_->target_model = std::move(*target_model);
+  return {};
+}
+
+std::expected<void, std::string> Session::load_include_graphs()
+{
+  const auto include_graphs_file = impl_->binary_dir / include_graphs_filename;
+  if (!std::filesystem::is_regular_file(include_graphs_file))
+  {
+    return {};
+  }
+  return impl_->scanner->load_include_graphs(include_graphs_file);
+}
+
+std::expected<void, std::string> Session::save_include_graphs() const
+{
+  return impl_->scanner->save_include_graphs(impl_->binary_dir / include_graphs_filename);
+}
+
+void Session::force_rescan(bool rescan)
+{
+  impl_->scanner->force_rescan(rescan);
+}
+
+void Session::use_process_isolation(bool isolate)
+{
+  impl_->scanner->use_process_isolation(isolate);
+}
+
+void Session::set_fail_fast(bool fail_fast)
+{
+  impl_->fail_fast = fail_fast;
+  impl_->scanner->set_fail_fast(fail_fast);
+}
+
+void Session::set_tu_timeout(std::chrono::milliseconds tu_timeout)
+{
+  impl_->scanner->set_tu_timeout(tu_timeout);
+}
+
+void Session::set_memory_limit(uint64_t memory_limit)
+{
+  impl_->scanner->set_memory_limit(memory_limit);
+}
+
+void Session::rescan(const std::vector<std::filesystem::path>& changed_files)
+{
+  impl_->scanner->invalidate(changed_files);
+}
+
+std::set<std::filesystem::path> Session::recorded_files() const
+{
+  return impl_->scanner->include_index().files();
+}
+
+std::optional<std::vector<target_model::Target>> Session::affected_targets(
+  const std::vector<std::filesystem::path>& changed_files) const
+{
+  const auto include_index = impl_->scanner->include_index();
+  if (include_index.empty())
+  {
+    return std::nullopt;
+  }
+
+  auto affected_sources = include_index.affected_sources(changed_files);
+
+  // sources that are new since the graphs were recorded are not known to the index
+  affected_sources.insert(changed_files.begin(), changed_files.end());
+
+  std::vector<target_model::Target> affected_targets;
+  impl_->target_model.for_each_target(
+    [&](const target_model::Target& target, const target_model::Target_data& target_data)
+    {
+      auto is_affected = [&](const std::filesystem::path& source)
+      {
+        return affected_sources.contains(source);
+      };
+      if (std::ranges::any_of(target_data.sources, is_affected) ||
+          std::ranges::any_of(target_data.verify_interface_header_sets_sources, is_affected))
+      {
+        affected_targets.push_back(target);
+      }
+    });
+
+  return affected_targets;
+}
+
+std::expected<size_t, std::string> Session::scan_on_workers(
+  const std::vector<target_model::Target>& targets,
+  scanner::Scan_coordinator& coordinator)
+{
+  std::vector<const target_model::Target_data*> target_datas;
+  if (targets.empty())
+  {
+    impl_->target_model.for_each_target(
+      [&](const target_model::Target& /*target*/, const target_model::Target_data& target_data)
+      { target_datas.push_back(&target_data); });
+  }
+  for (const auto& target : targets)
+  {
+    // the check stops at the first unknown target and reports it
+    auto target_data = impl_->target_model.get_target_data(target);
+    if (!target_data.has_value())
+    {
+      break;
+    }
+    target_datas.push_back(&target_data->get());
+  }
+
+  return impl_->scanner->scan_on_workers(impl_->binary_dir, target_datas, coordinator);
+}
+
+Check_result Session::check(const std::vector<target_model::Target>& targets,
+                            const Check_callbacks& callbacks)
+{
+  // the target data is null for the unknown target that ends the check
+  std::vector<std::pair<target_model::Target, const target_model::Target_data*>> jobs;
+  if (targets.empty())
+  {
+    impl_->target_model.for_each_target(
+      [&](const target_model::Target& target, const target_model::Target_data& target_data)
+      { jobs.emplace_back(target, &target_data); });
+  }
+  for (const auto& target : targets)
+  {
+    auto target_data = impl_->target_model.get_target_data(target);
+    jobs.emplace_back(target, target_data.has_value() ? &target_data->get() : nullptr);
+    if (!target_data.has_value())
+    {
+      break;
+    }
+  }
+
+  // Targets are scanned one after the other and checked in parallel while the next ones are
+  // scanned. The results are reported in the order of the targets. With fail_fast, the targets
+  // after the first failed one are not scanned, although some may already have been.
+  const auto max_in_flight = 2 * impl_->pipeline.thread_count();
+  std::atomic_size_t first_failure{std::numeric_limits<size_t>::max()};
+  const auto skipped = [&](size_t index)
+  {
+    return impl_->fail_fast && first_failure < index;
+  };
+
+  struct Reported_target
+  {
+    Target_result result;
+    std::string scan_messages;
+    std::string report;
+  };
+
+  Check_result result;
+  util::ordered_pipeline(
+    impl_->pipeline,
+    jobs.size(),
+    max_in_flight,
+    [&](size_t index)
+    {
+      const auto& [target, target_data] = jobs[index];
+      if (!target_data || skipped(index))
+      {
+        return std::pair{index, Impl::Scanned_target{}};
+      }
+      // the messages of the scan are printed with the report of the target
+      message::Capture capture;
+      auto scanned = impl_->scan_target(target, *target_data);
+      scanned.messages = capture.take();
+      return std::pair{index, std::move(scanned)};
+    },
+    [&](std::pair<size_t, Impl::Scanned_target> scanned)
+    {
+      const auto index = scanned.first;
+      const auto& [target, target_data] = jobs[index];
+      Reported_target reported;
+      reported.result.target = target;
+      reported.scan_messages = std::move(scanned.second.messages);
+      if (!target_data)
+      {
+        reported.result.status = Target_result::Status::unknown_target;
+      }
+      else if (!skipped(index))
+      {
+        reported.result = impl_->check_target(std::move(scanned.second), *target_data);
+      }
+      if (!reported.result.success())
+      {
+        auto failure = first_failure.load();
+        while (index < failure && !first_failure.compare_exchange_weak(failure, index))
+        {
+        }
+      }
+      if (callbacks.render_report && !skipped(index))
+      {
+        reported.report = callbacks.render_report(reported.result);
+      }
+      return reported;
+    },
+    [&](Reported_target reported)
+    {
+      if (result.stopped)
+      {
+        return;
+      }
+      if (callbacks.target_started)
+      {
+        callbacks.target_started(reported.result.target);
+      }
+      message::write(reported.scan_messages);
+      result.targets.push_back(std::move(reported.result));
+      if (callbacks.target_finished)
+      {
+        callbacks.target_finished(result.targets.back());
+      }
+      if (callbacks.target_reported)
+      {
+        callbacks.target_reported(result.targets.back(), reported.report);
+      }
+      result.stopped = impl_->fail_fast && !result.targets.back().success();
+    });
+
+  return result;
+}
+} // namespace lwyi
@@ -0,0 +1,140 @@
+// Copyright (c) 2025 Environmental Systems Research Institute, Inc.
+// SPDX-License-Identifier: Apache-2.0
+
+#include <lwyi/shard.hpp>
+
+#include <lwyi/scan_profile.hpp>
+#include <target_model/target.hpp>
+#include <target_model/target_data.hpp>
+#include <target_model/target_model.hpp>
+
+#include <algorithm>
+#include <charconv>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <expected>
+#include <format>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <tuple>
+#include <vector>
+
+namespace lwyi
+{
+namespace
+{
+bool parse_number(std::string_view text, uint32_t& value)
+{
+  const auto* last = text.data() + text.size();
+  auto [ptr, ec] = std::from_chars(text.data(), last, value);
+  return ec == std::errc() && ptr == last;
+}
+
+int64_t translation_unit_count(const target_model::Target_model& target_model,
+                               const target_model::Target& target)
+{
+  const auto target_data = target_model.get_target_data(target);
+  if (!target_data)
+  {
+    return 0;
+  }
+  return static_cast<int64_t>(target_data->get().sources.size() +
+                              target_data->get().verify_interface_header_sets_sources.size());
+}
+} // namespace
+
+std::expected<Shard, std::string> parse_shard(std::string_view text)
+{
+  const auto slash = text.find('/');
+  Shard shard;
+  if (slash == std::string_view::npos || !parse_number(text.substr(0, slash), shard.index) ||
+      !parse_number(text.substr(slash + 1), shard.count) || shard.index < 1 ||
+      shard.count < shard.index)
+  {
+    return std::unexpected(
+      std::format("Invalid shard {}. Expected K/N with 1 <= K <= N.", text));
+  }
+  return shard;
+}
+
+std::vector<target_model::Target> select_shard(const target_model::Target_model& target_model,
+                                               const std::vector<target_model::Target>& targets,
+                                               const Scan_profile& profile,
+                                               Shard shard)
+{
+  std::vector<target_model::Target> all_targets;
+  if (targets.empty())
+  {
+    target_model.for_each_target([&](const target_model::Target& target,
+                                     const target_model::Target_data&)
+                                 { all_targets.push_back(target); });
+  }
+  const auto& candidates = targets.empty() ? all_targets : targets;
+
+  struct Weighted_target
+  {
+    int64_t cost;
+    size_t index;
+  };
+
+  // the time per translation unit of the profiled targets prices the other targets
+  int64_t profiled_milliseconds = 0;
+  int64_t profiled_units = 0;
+  std::vector<std::optional<std::chrono::milliseconds>> durations;
+  durations.reserve(candidates.size());
+  for (const auto& target : candidates)
+  {
+    durations.push_back(profile.duration(target));
+    if (durations.back())
+    {
+      profiled_milliseconds += durations.back()->count();
+      profiled_units += translation_unit_count(target_model, target);
+    }
+  }
+  const auto milliseconds_per_unit =
+    (0 < profiled_units) ? std::max<int64_t>(1, profiled_milliseconds / profiled_units) : 1;
+
+  std::vector<Weighted_target> weighted_targets;
+  weighted_targets.reserve(candidates.size());
+  for (size_t i = 0; i < candidates.size(); ++i)
+  {
+    const auto cost = durations[i] ? durations[i]->count()
+                                   : translation_unit_count(target_model, candidates[i]) *
+                                       milliseconds_per_unit;
+    // free targets still count, or they would all end up in the first shard
+    weighted_targets.push_back({std::max<int64_t>(cost, 1), i});
+  }
+  std::ranges::sort(weighted_targets,
+                    [&](const Weighted_target& lhs, const Weighted_target& rhs)
+                    {
+                      return std::tie(rhs.cost, candidates[lhs.index].name) <
+                             std::tie(lhs.cost, candidates[rhs.index].name);
+                    });
+
+  std::vector<int64_t> loads(shard.count, 0);
+  std::vector<size_t> selected_indices;
+  for (const auto& weighted_target : weighted_targets)
+  {
+    // min_element picks the lowest numbered of equally loaded shards
+    const auto least_loaded = std::ranges::min_element(loads);
+    *least_loaded += weighted_target.cost;
+    if (static_cast<uint32_t>(least_loaded - loads.begin()) + 1 == shard.index)
+    {
+      selected_indices.push_back(weighted_target.index);
+    }
+  }
+
+  // check in the order the targets were given
+  std::ranges::sort(selected_indices);
+  std::vector<target_model::Target> selected_targets;
+  selected_targets.reserve(selected_indices.size());
+  for (auto i : selected_indices)
+  {
+    selected_targets.push_back(candidates[i]);
+  }
+  return selected_targets;
+}
+} // namespace lwyi
@@ -3,100 +3,37 @@
 
 #include <lwyi/strongly_connected_dependencies.hpp>
 
+#include <lwyi/target_graph.hpp>
 #include <target_model/target.hpp>
-#include <target_model/target_data.hpp>
 #include <target_model/target_model.hpp>
 
-#include <algorithm>
-#include <functional>
-#include <map>
-#include <optional>
+#include <cstdint>
 #include <set>
-#include <utility>
 #include <vector>
 
 namespace lwyi
 {
-namespace
-{
-struct Vertex_data
-{
-  int index{-1};
-  int lowlink{-1};
-  bool on_stack{false};
-};
-} // namespace
-
 std::vector<std::set<target_model::Target>> compute_strongly_connected_dependencies(
   const target_model::Target_model& target_model)
 {
-  using Component = std::set<target_model::Target>;
+  const Target_graph graph(target_model);
+  const Strongly_connected_components components(graph.dependencies());
 
-  int index = 0;
-  std::vector<target_model::Target> stack;
-  std::vector<Component> strongly_connected;
-  std::map<target_model::Target, Vertex_data> data;
-
-  std::function<void(target_model::Target v)> strong_connect;
-  strong_connect = [&](const target_model::Target& v)
+  std::vector<std::set<target_model::Target>> strongly_connected;
+  for (uint32_t component = 0; component < components.size(); ++component)
   {
-    auto& vdata = data[v];
-    vdata.index = index;
-    vdata.lowlink = index;
-    vdata.on_stack = true;
-
-    stack.push_back(v);
-    ++index;
-
-    if (auto target_data = target_model.get_target_data(v))
+    const auto members = components.members(component);
+    // only interested in non-trivial components
+    if (members.size() < 2)
     {
-      for (const auto& w : target_data->get().dependencies)
-      {
-        auto& wdata = data[w];
-        if (wdata.index == -1)
-        {
-          strong_connect(w);
-          vdata.lowlink = std::min(vdata.lowlink, wdata.lowlink);
-        }
-        else if (wdata.on_stack)
-        {
-          vdata.lowlink = std::min(vdata.lowlink, wdata.index);
-        }
-      }
+      continue;
     }
-
-    if (vdata.lowlink == vdata.index)
+    auto& targets = strongly_connected.emplace_back();
+    for (const auto member : members)
     {
-      Component c;
-      for (;;)
-      {
-        auto w = stack.back();
-        stack.pop_back();
-        auto& wdata = data[w];
-        wdata.on_stack = false;
-        c.insert(w);
-        if (w == v)
-        {
-          break;
-        }
-      }
-      // only interested in non-trivial components
-      if (1 < c.size())
-      {
-        strongly_connected.push_back(std::move(c));
-      }
+      targets.insert(graph.target(member));
     }
-  };
-
-  target_model.for_each_target(
-    [&](const target_model::Target& v, const target_model::Target_data&)
-    {
-      auto& vdata = data[v];
-      if (vdata.index == -1)
-      {
-        strong_connect(v);
-      }
-    });
+  }
 
   return strongly_connected;
 }
@@ -0,0 +1,260 @@
+// Copyright (c) 2025 Environmental Systems Research Institute, Inc.
+// SPDX-License-Identifier: Apache-2.0
+
+#include <lwyi/target_graph.hpp>
+
+#include <target_model/target.hpp>
+#include <target_model/target_data.hpp>
+#include <target_model/target_model.hpp>
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <optional>
+#include <span>
+#include <utility>
+#include <vector>
+
+namespace lwyi
+{
+namespace
+{
+constexpr uint32_t unvisited = std::numeric_limits<uint32_t>::max();
+} // namespace
+
+Digraph::Digraph(std::vector<uint32_t> offsets, std::vector<uint32_t> successors)
+: offsets_(std::move(offsets)),
+  successors_(std::move(successors))
+{
+  assert(!offsets_.empty() && offsets_.back() == successors_.size());
+}
+
+Digraph::Digraph(size_t vertex_count, std::span<const std::pair<uint32_t, uint32_t>> edges)
+: offsets_(vertex_count + 1),
+  successors_(edges.size())
+{
+  // counting sort of the edges by their source
+  for (const auto& [from, to] : edges)
+  {
+    assert(from < vertex_count && to < vertex_count);
+    ++offsets_[from + 1];
+  }
+  for (size_t v = 0; v < vertex_count; ++v)
+  {
+    offsets_[v + 1] += offsets_[v];
+  }
+  std::vector<uint32_t> next(offsets_.begin(), offsets_.end() - 1);
+  for (const auto& [from, to] : edges)
+  {
+    successors_[next[from]++] = to;
+  }
+}
+
+size_t Digraph::vertex_count() const
+{
+  return offsets_.size() - 1;
+}
+
+size_t Digraph::edge_count() const
+{
+  return successors_.size();
+}
+
+std::span<const uint32_t> Digraph::successors(uint32_t vertex) const
+{
+  return std::span(successors_).subspan(offsets_[vertex], offsets_[vertex + 1] - offsets_[vertex]);
+}
+
+Digraph Digraph::reversed() const
+{
+  std::vector<std::pair<uint32_t, uint32_t>> edges;
+  edges.reserve(edge_count());
+  for (uint32_t v = 0; v < vertex_count(); ++v)
+  {
+    for (const auto w : successors(v))
+    {
+      edges.emplace_back(w, v);
+    }
+  }
+  return Digraph(vertex_count(), edges);
+}
+
+Target_graph::Target_graph(const target_model::Target_model& target_model)
+{
+  const auto add = [&](const target_model::Target& target)
+  {
+    const auto [it, inserted] = ids_.try_emplace(target, static_cast<uint32_t>(targets_.size()));
+    if (inserted)
+    {
+      targets_.push_back(target);
+    }
+    return it->second;
+  };
+
+  target_model.for_each_target([&](const target_model::Target& target,
+                                   const target_model::Target_data& /*target_data*/)
+                               { add(target); });
+
+  std::vector<uint32_t> offsets{0};
+  std::vector<uint32_t> successors;
+  offsets.reserve(targets_.size() + 1);
+  target_model.for_each_target(
+    [&](const target_model::Target& /*target*/, const target_model::Target_data& target_data)
+    {
+      for (const auto& dependency : target_data.dependencies)
+      {
+        successors.push_back(add(dependency));
+      }
+      offsets.push_back(static_cast<uint32_t>(successors.size()));
+    });
+  // the dependencies outside of the model have no dependencies
+  offsets.resize(targets_.size() + 1, static_cast<uint32_t>(successors.size()));
+
+  dependencies_ = Digraph(std::move(offsets), std::move(successors));
+}
+
+size_t Target_graph::size() const
+{
+  return targets_.size();
+}
+
+const target_model::Target& Target_graph::target(uint32_t id) const
+{
+  return targets_[id];
+}
+
+std::optional<uint32_t> Target_graph::find(const target_model::Target& target) const
+{
+  const auto it = ids_.find(target);
+  if (it == ids_.end())
+  {
+    return std::nullopt;
+  }
+  return it->second;
+}
+
+const Digraph& Target_graph::dependencies() const
+{
+  return dependencies_;
+}
+
+Strongly_connected_components::Strongly_connected_components(const Digraph& graph)
+: component_of_(graph.vertex_count(), unvisited)
+{
+  const auto vertex_count = graph.vertex_count();
+  members_.reserve(vertex_count);
+
+  // A vertex is on the stack while it has an index but no component yet. Instead of recursing,
+  // the path to the current vertex is kept with the position of the next edge to follow.
+  std::vector<uint32_t> index(vertex_count, unvisited);
+  std::vector<uint32_t> lowlink(vertex_count);
+  std::vector<uint32_t> stack;
+  std::vector<std::pair<uint32_t, uint32_t>> path;
+  uint32_t next_index = 0;
+
+  const auto visit = [&](uint32_t v)
+  {
+    index[v] = next_index;
+    lowlink[v] = next_index;
+    ++next_index;
+    stack.push_back(v);
+    path.emplace_back(v, 0);
+  };
+
+  for (uint32_t root = 0; root < vertex_count; ++root)
+  {
+    if (index[root] != unvisited)
+    {
+      continue;
+    }
+    visit(root);
+    while (!path.empty())
+    {
+      auto& [v, next_edge] = path.back();
+      const auto successors = graph.successors(v);
+      if (next_edge < successors.size())
+      {
+        const auto w = successors[next_edge++];
+        if (index[w] == unvisited)
+        {
+          // invalidates v and next_edge
+          visit(w);
+        }
+        else if (component_of_[w] == unvisited)
+        {
+          lowlink[v] = std::min(lowlink[v], index[w]);
+        }
+        continue;
+      }
+
+      const auto finished = v;
+      path.pop_back();
+      if (lowlink[finished] == index[finished])
+      {
+        const auto component = static_cast<uint32_t>(member_offsets_.size() - 1);
+        uint32_t w = unvisited;
+        do // NOLINT(cppcoreguidelines-avoid-do-while)
+        {
+          w = stack.back();
+          stack.pop_back();
+          component_of_[w] = component;
+          members_.push_back(w);
+        }
+        while (w != finished);
+        member_offsets_.push_back(static_cast<uint32_t>(members_.size()));
+      }
+      if (!path.empty())
+      {
+        auto& parent = path.back().first;
+        lowlink[parent] = std::min(lowlink[parent], lowlink[finished]);
+      }
+    }
+  }
+
+  // the edges between components, in the order of the components and their members
+  std::vector<uint32_t> offsets{0};
+  std::vector<uint32_t> successors;
+  offsets.reserve(size() + 1);
+  std::vector<uint32_t> last_source(size(), unvisited);
+  for (uint32_t component = 0; component < size(); ++component)
+  {
+    for (const auto v : members(component))
+    {
+      for (const auto w : graph.successors(v))
+      {
+        const auto successor = component_of_[w];
+        if (successor != component && last_source[successor] != component)
+        {
+          last_source[successor] = component;
+          successors.push_back(successor);
+        }
+      }
+    }
+    offsets.push_back(static_cast<uint32_t>(successors.size()));
+  }
+  condensation_ = Digraph(std::move(offsets), std::move(successors));
+}
+
+size_t Strongly_connected_components::size() const
+{
+  return member_offsets_.size() - 1;
+}
+
+uint32_t Strongly_connected_components::component(uint32_t vertex) const
+{
+  return component_of_[vertex];
+}
+
+std::span<const uint32_t> Strongly_connected_components::members(uint32_t component) const
+{
+  return std::span(members_).subspan(member_offsets_[component],
+                                     member_offsets_[component + 1] - member_offsets_[component]);
+}
+
+const Digraph& Strongly_connected_components::condensation() const
+{
+  return condensation_;
+}
+} // namespace lwyi
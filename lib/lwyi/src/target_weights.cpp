@@ -0,0 +1,69 @@
+// Copyright (c) 2025 Environmental Systems Research Institute, Inc.
+// SPDX-License-Identifier: Apache-2.0
+
+#include <lwyi/target_weights.hpp>
+
+#include <lwyi/scan_profile.hpp>
+#include <lwyi/target_graph.hpp>
+#include <target_model/target.hpp>
+#include <target_model/target_data.hpp>
+#include <target_model/target_model.hpp>
+
+#include <cstdint>
+#include <filesystem>
+#include <system_error>
+#include <vector>
+
+namespace lwyi
+{
+namespace
+{
+uint64_t source_bytes(const target_model::Target_data& target_data)
+{
+  uint64_t bytes = 0;
+  for (const auto& source : target_data.sources)
+  {
+    std::error_code error;
+    const auto size = std::filesystem::file_size(source, error);
+    if (!error)
+    {
+      bytes += size;
+    }
+  }
+  return bytes;
+}
+} // namespace
+
+std::vector<uint64_t> target_weights(const target_model::Target_model& target_model,
+                                     const Target_graph& graph,
+                                     Target_weight weight)
+{
+  // the targets of the model have the first ids in the same order
+  std::vector<uint64_t> weights(graph.size());
+  uint32_t id = 0;
+  target_model.for_each_target(
+    [&](const target_model::Target& /*target*/, const target_model::Target_data& target_data)
+    {
+      weights[id] = weight == Target_weight::source_bytes ? source_bytes(target_data)
+                                                          : target_data.sources.size();
+      ++id;
+    });
+  return weights;
+}
+
+std::vector<uint64_t> target_weights(const target_model::Target_model& target_model,
+                                     const Target_graph& graph,
+                                     const Scan_profile& profile)
+{
+  std::vector<uint64_t> weights(graph.size());
+  uint32_t id = 0;
+  target_model.for_each_target(
+    [&](const target_model::Target& target, const target_model::Target_data& /*target_data*/)
+    {
+      const auto duration = profile.duration(target);
+      weights[id] = duration ? static_cast<uint64_t>(duration->count()) : 0;
+      ++id;
+    });
+  return weights;
+}
+} // namespace lwyi
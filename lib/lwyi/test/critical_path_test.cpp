@@ -0,0 +1,45 @@
+// Copyright (c) 2025 Environmental Systems Research Institute, Inc.
+// SPDX-License-Identifier: Apache-2.0
+
+#include <lwyi/critical_path.hpp>
+
+#include <lwyi/target_graph.hpp>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <algorithm>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+TEST_CASE("lwyi: Critical_path", "[lwyi]")
+{
+  // 4 depends on 2 and 3, 2 on 0 and 3 on 1
+  std::vector<std::pair<uint32_t, uint32_t>> edges{{2, 0}, {3, 1}, {4, 2}, {4, 3}};
+  const lwyi::Digraph dag(5, edges);
+  const std::vector<uint64_t> weights{3, 1, 2, 1, 1};
+
+  const lwyi::Critical_path critical_path(dag, weights);
+
+  CHECK(critical_path.length() == 6);
+  CHECK(critical_path.total_weight() == 8);
+  CHECK(std::ranges::equal(critical_path.path(), std::vector<uint32_t>{0, 2, 4}));
+  CHECK(critical_path.earliest_start(2) == 3);
+  CHECK(critical_path.earliest_start(4) == 5);
+  CHECK(critical_path.slack(0) == 0);
+  CHECK(critical_path.slack(2) == 0);
+  CHECK(critical_path.slack(4) == 0);
+  CHECK(critical_path.slack(1) == 3);
+  CHECK(critical_path.slack(3) == 3);
+  // 0 and 1 are built together, then 0 and 3
+  CHECK(critical_path.peak_parallelism() == 2);
+}
+
+TEST_CASE("lwyi: Critical_path of an empty graph", "[lwyi]")
+{
+  const lwyi::Critical_path critical_path(lwyi::Digraph(0, {}), {});
+
+  CHECK(critical_path.length() == 0);
+  CHECK(critical_path.path().empty());
+  CHECK(critical_path.peak_parallelism() == 0);
+}
@@ -0,0 +1,199 @@
+// Copyright (c) 2025 Environmental Systems Research Institute, Inc.
+// SPDX-License-Identifier: Apache-2.0
+
+#include <lwyi/graph_export.hpp>
+
+#include <lwyi/target_graph.hpp>
+#include <target_model/target.hpp>
+#include <target_model/target_data.hpp>
+#include <target_model/target_model.hpp>
+
+#include <catch2/catch_test_macros.hpp>
+#include <simdjson.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <format>
+#include <fstream>
+#include <iterator>
+#include <set>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+namespace
+{
+//  a ⇄ b   c → a   a → ext (not part of the model)
+// where b is also an interface dependency of a
+target_model::Target_model make_target_model()
+{
+  target_model::Target_data a;
+  a.dependencies = {{"b"}, {"ext"}};
+  a.interface_dependencies = {{"b"}};
+  target_model::Target_data b;
+  b.dependencies = {{"a"}};
+  target_model::Target_data c;
+  c.dependencies = {{"a"}};
+  return target_model::Target_model({{{"a"}, a}, {{"b"}, b}, {{"c"}, c}});
+}
+
+std::string read_file(const std::filesystem::path& path)
+{
+  std::ifstream file(path, std::ios::binary);
+  return {std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>()};
+}
+
+// Copies the value at the offset out of the file, as a reader that maps it would see it
+template <typename T>
+T read_value(const std::string& bytes, uint64_t offset)
+{
+  REQUIRE(offset + sizeof(T) <= bytes.size());
+  T value;
+  std::memcpy(&value, bytes.data() + offset, sizeof(T));
+  return value;
+}
+} // namespace
+
+TEST_CASE("lwyi: Graph_export", "[lwyi]")
+{
+  const auto target_model = make_target_model();
+  const lwyi::Target_graph graph(target_model);
+  const lwyi::Strongly_connected_components components(graph.dependencies());
+  const lwyi::Graph_export graph_export(target_model, graph, components);
+  REQUIRE(graph.size() == 4U);
+  REQUIRE(graph.target(3).name == "ext");
+
+  const auto dir = std::filesystem::temp_directory_path() / "lwyi_graph_export_test";
+  std::filesystem::create_directories(dir);
+
+  using Edge = std::tuple<uint32_t, uint32_t, std::string>;
+  const std::set<Edge> expected_edges{
+    {0U, 1U, "interface"}, {0U, 3U, "private"}, {1U, 0U, "private"}, {2U, 0U, "private"}};
+
+  SECTION("json")
+  {
+    const auto path = dir / "graph.json";
+    REQUIRE(graph_export.write_json(path));
+
+    simdjson::dom::parser parser;
+    simdjson::dom::element doc;
+    REQUIRE(!parser.load(path.string()).get(doc));
+    simdjson::dom::array targets;
+    REQUIRE(!doc["targets"].get_array().get(targets));
+    REQUIRE(targets.size() == 4U);
+
+    std::vector<std::string> names;
+    std::vector<uint64_t> sccs;
+    std::vector<bool> external;
+    std::set<Edge> edges;
+    for (auto target : targets)
+    {
+      names.emplace_back(std::string_view(target["name"]));
+      sccs.push_back(uint64_t(target["scc"]));
+      external.push_back(bool(target["external"]));
+      for (auto dependency : target["dependencies"])
+      {
+        edges.emplace(static_cast<uint32_t>(names.size() - 1),
+                      static_cast<uint32_t>(uint64_t(dependency["target"])),
+                      std::string(std::string_view(dependency["kind"])));
+      }
+    }
+    CHECK(names == std::vector<std::string>{"a", "b", "c", "ext"});
+    CHECK(sccs[0] == sccs[1]);
+    CHECK(sccs[0] != sccs[2]);
+    CHECK(external == std::vector<bool>{false, false, false, true});
+    CHECK(edges == expected_edges);
+  }
+
+  SECTION("graphml")
+  {
+    const auto path = dir / "graph.graphml";
+    REQUIRE(graph_export.write_graphml(path));
+
+    const auto text = read_file(path);
+    CHECK(text.starts_with(R"(<?xml version="1.0" encoding="UTF-8"?>)"));
+    CHECK(text.ends_with("  </graph>\n</graphml>\n"));
+    CHECK(text.contains(R"(<node id="n3"><data key="name">ext</data>)"));
+    CHECK(text.contains(R"(<data key="external">true</data></node>)"));
+    for (const auto& [from, to, kind] : expected_edges)
+    {
+      CHECK(text.contains(std::format(
+        R"(<edge source="n{}" target="n{}"><data key="kind">{}</data></edge>)", from, to, kind)));
+    }
+  }
+
+  SECTION("binary edge list")
+  {
+    const auto path = dir / "graph.bin";
+    REQUIRE(graph_export.write_edge_list(path));
+    const auto bytes = read_file(path);
+
+    const auto header = read_value<lwyi::edge_list::Header>(bytes, 0U);
+    CHECK(header.magic == lwyi::edge_list::magic);
+    CHECK(header.version == lwyi::edge_list::version);
+    REQUIRE(header.target_count == 4U);
+    CHECK(header.string_bytes == std::string_view("abcext").size());
+    REQUIRE(header.edge_count == expected_edges.size());
+
+    // every section starts 8 byte aligned right after the one before
+    const uint64_t offsets_start = sizeof(lwyi::edge_list::Header);
+    const uint64_t blob_start = offsets_start + (header.target_count + 1U) * sizeof(uint64_t);
+    const uint64_t targets_start = blob_start + lwyi::edge_list::aligned(header.string_bytes);
+    const uint64_t edges_start =
+      targets_start + header.target_count * sizeof(lwyi::edge_list::Target_entry);
+    const uint64_t end =
+      edges_start +
+      lwyi::edge_list::aligned(header.edge_count * sizeof(lwyi::edge_list::Edge_entry));
+    CHECK(blob_start % 8U == 0U);
+    CHECK(targets_start % 8U == 0U);
+    CHECK(edges_start % 8U == 0U);
+    REQUIRE(bytes.size() == end);
+
+    std::vector<std::string> names;
+    for (uint32_t v = 0; v < header.target_count; ++v)
+    {
+      const auto begin = read_value<uint64_t>(bytes, offsets_start + v * sizeof(uint64_t));
+      const auto next = read_value<uint64_t>(bytes, offsets_start + (v + 1) * sizeof(uint64_t));
+      REQUIRE(begin <= next);
+      REQUIRE(next <= header.string_bytes);
+      names.emplace_back(bytes.substr(blob_start + begin, next - begin));
+    }
+    CHECK(names == std::vector<std::string>{"a", "b", "c", "ext"});
+    // the padding after the names is zero
+    const auto padding = std::string_view(bytes).substr(
+      blob_start + header.string_bytes, targets_start - blob_start - header.string_bytes);
+    CHECK(std::ranges::all_of(padding,
+                              [](char c)
+                              {
+                                return c == '\0';
+                              }));
+
+    std::vector<lwyi::edge_list::Target_entry> targets;
+    for (uint32_t v = 0; v < header.target_count; ++v)
+    {
+      targets.push_back(read_value<lwyi::edge_list::Target_entry>(
+        bytes, targets_start + v * sizeof(lwyi::edge_list::Target_entry)));
+      CHECK(targets.back().scc == components.component(v));
+    }
+    CHECK(targets[0].scc == targets[1].scc);
+    CHECK(targets[0].flags == 0U);
+    CHECK(targets[3].flags == lwyi::edge_list::external_flag);
+
+    std::set<Edge> edges;
+    uint32_t previous_from = 0U;
+    for (uint64_t i = 0; i < header.edge_count; ++i)
+    {
+      const auto edge = read_value<lwyi::edge_list::Edge_entry>(
+        bytes, edges_start + i * sizeof(lwyi::edge_list::Edge_entry));
+      CHECK(previous_from <= edge.from);
+      previous_from = edge.from;
+      const bool interface = edge.kind == lwyi::edge_list::Edge_kind::interface_dependency;
+      edges.emplace(edge.from, edge.to, interface ? "interface" : "private");
+    }
+    CHECK(edges == expected_edges);
+  }
+}
@@ -0,0 +1,150 @@
+// Copyright (c) 2025 Environmental Systems Research Institute, Inc.
+// SPDX-License-Identifier: Apache-2.0
+
+#include <lwyi/incremental_components.hpp>
+
+#include <lwyi/target_graph.hpp>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <set>
+#include <utility>
+#include <vector>
+
+namespace
+{
+using Components = std::set<std::vector<uint32_t>>;
+
+Components sorted_components(const lwyi::Incremental_components& components)
+{
+  Components result;
+  for (const auto component : components.order())
+  {
+    std::vector<uint32_t> members(components.members(component).begin(),
+                                  components.members(component).end());
+    std::ranges::sort(members);
+    result.insert(std::move(members));
+  }
+  return result;
+}
+
+Components sorted_components(const lwyi::Strongly_connected_components& components)
+{
+  Components result;
+  for (uint32_t component = 0; component < components.size(); ++component)
+  {
+    std::vector<uint32_t> members(components.members(component).begin(),
+                                  components.members(component).end());
+    std::ranges::sort(members);
+    result.insert(std::move(members));
+  }
+  return result;
+}
+} // namespace
+
+TEST_CASE("lwyi: Incremental_components", "[lwyi]")
+{
+  // 0 → 1 → 2 → 3
+  std::vector<std::pair<uint32_t, uint32_t>> edges{{0, 1}, {1, 2}, {2, 3}};
+  lwyi::Incremental_components components(lwyi::Digraph(4, edges));
+  REQUIRE(components.size() == 4);
+
+  SECTION("an edge back merges the components on the cycle")
+  {
+    components.add_edge(2, 1);
+    CHECK(components.size() == 3);
+    CHECK(components.component(1) == components.component(2));
+
+    components.add_edge(3, 0);
+    CHECK(components.size() == 1);
+
+    SECTION("removing an edge of the cycle splits it again")
+    {
+      components.remove_edge(3, 0);
+      CHECK(components.size() == 3);
+      CHECK(components.component(1) == components.component(2));
+      CHECK(components.component(0) != components.component(3));
+    }
+  }
+
+  SECTION("an edge that does not close a cycle reorders the components")
+  {
+    // 0 → 1 and 2 → 3 are found in the order 1, 0, 3, 2
+    std::vector<std::pair<uint32_t, uint32_t>> chains{{0, 1}, {2, 3}};
+    lwyi::Incremental_components reordered(lwyi::Digraph(4, chains));
+    REQUIRE(reordered.order().front() == reordered.component(1));
+
+    reordered.add_edge(1, 2);
+    CHECK(reordered.size() == 4);
+    CHECK(std::ranges::equal(reordered.order(),
+                             std::vector{reordered.component(3),
+                                         reordered.component(2),
+                                         reordered.component(1),
+                                         reordered.component(0)}));
+  }
+
+  SECTION("edits that match the graph change nothing")
+  {
+    components.add_edge(0, 1);
+    components.remove_edge(1, 0);
+    CHECK(components.size() == 4);
+  }
+}
+
+TEST_CASE("lwyi: Incremental_components agree with a full search", "[lwyi]")
+{
+  constexpr uint32_t vertex_count = 60;
+  std::mt19937 random{7};
+  std::uniform_int_distribution<uint32_t> vertex(0, vertex_count - 1);
+
+  std::set<std::pair<uint32_t, uint32_t>> edges;
+  while (edges.size() < 50)
+  {
+    edges.emplace(vertex(random), vertex(random));
+  }
+  const std::vector<std::pair<uint32_t, uint32_t>> initial(edges.begin(), edges.end());
+  lwyi::Incremental_components components(lwyi::Digraph(vertex_count, initial));
+
+  for (int change = 0; change < 400; ++change)
+  {
+    const std::pair edge{vertex(random), vertex(random)};
+    if (random() % 3 != 0)
+    {
+      edges.insert(edge);
+      components.add_edge(edge.first, edge.second);
+    }
+    else if (!edges.empty())
+    {
+      // remove an existing edge
+      auto existing = edges.lower_bound(edge);
+      if (existing == edges.end())
+      {
+        existing = edges.begin();
+      }
+      components.remove_edge(existing->first, existing->second);
+      edges.erase(existing);
+    }
+
+    const std::vector<std::pair<uint32_t, uint32_t>> current(edges.begin(), edges.end());
+    const lwyi::Strongly_connected_components expected(lwyi::Digraph(vertex_count, current));
+    REQUIRE(sorted_components(components) == sorted_components(expected));
+
+    // every edge leads to the same or an earlier component in the order
+    std::vector<size_t> position(vertex_count);
+    for (size_t i = 0; i < components.order().size(); ++i)
+    {
+      for (const auto member : components.members(components.order()[i]))
+      {
+        position[member] = i;
+      }
+    }
+    for (const auto& [from, to] : edges)
+    {
+      REQUIRE(position[to] <= position[from]);
+    }
+  }
+}
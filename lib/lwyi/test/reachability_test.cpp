@@ -0,0 +1,127 @@
+// Copyright (c) 2025 Environmental Systems Research Institute, Inc.
+// SPDX-License-Identifier: Apache-2.0
+
+#include <lwyi/reachability.hpp>
+
+#include <lwyi/target_graph.hpp>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <algorithm>
+#include <cstdint>
+#include <random>
+#include <set>
+#include <utility>
+#include <vector>
+
+TEST_CASE("lwyi: Reachability", "[lwyi]")
+{
+  // 3 → 1 → 0, 2 → 0, and 100 → 99 → 3 to reach past the first word of the bitsets
+  std::vector<std::pair<uint32_t, uint32_t>> edges{{1, 0}, {2, 0}, {3, 1}, {99, 3}, {100, 99}};
+  const lwyi::Digraph dag(101, edges);
+
+  const lwyi::Reachability reachability(dag);
+
+  CHECK(reachability.reaches(1, 0));
+  CHECK(reachability.reaches(3, 0));
+  CHECK(reachability.reaches(100, 0));
+  CHECK(reachability.reaches(100, 99));
+  CHECK_FALSE(reachability.reaches(3, 2));
+  CHECK_FALSE(reachability.reaches(0, 1));
+  CHECK_FALSE(reachability.reaches(1, 1));
+  CHECK_FALSE(reachability.reaches(99, 100));
+  CHECK(reachability.reached(100).size() == 2);
+}
+
+TEST_CASE("lwyi: shortest_path", "[lwyi]")
+{
+  // 0 → 1 → 2 → 3 and 0 → 4 → 3, with a cycle 3 → 0
+  std::vector<std::pair<uint32_t, uint32_t>> edges{{0, 1}, {1, 2}, {2, 3}, {0, 4}, {4, 3}, {3, 0}};
+  const lwyi::Digraph graph(6, edges);
+
+  CHECK(lwyi::shortest_path(graph, 0, 3) == std::vector<uint32_t>{0, 4, 3});
+  CHECK(lwyi::shortest_path(graph, 2, 1) == std::vector<uint32_t>{2, 3, 0, 1});
+  CHECK(lwyi::shortest_path(graph, 0, 0) == std::vector<uint32_t>{0, 4, 3, 0});
+  CHECK(lwyi::shortest_path(graph, 0, 5).empty());
+}
+
+TEST_CASE("lwyi: reached_from", "[lwyi]")
+{
+  // 0 → 1 → 2, 3 → 2 and 70 → 3 past the first word, with a cycle 2 → 0
+  std::vector<std::pair<uint32_t, uint32_t>> edges{{0, 1}, {1, 2}, {2, 0}, {3, 2}, {70, 3}};
+  const lwyi::Digraph graph(71, edges);
+  const auto contains = [](const std::vector<uint64_t>& bitset, uint32_t v)
+  {
+    return (bitset[v / 64] >> (v % 64) & 1U) != 0;
+  };
+
+  const std::vector<uint32_t> starts{1};
+  const auto reached = lwyi::reached_from(graph, starts);
+  CHECK(reached.size() == 2);
+  CHECK(contains(reached, 0));
+  CHECK(contains(reached, 1));
+  CHECK(contains(reached, 2));
+  CHECK_FALSE(contains(reached, 3));
+
+  const std::vector<uint32_t> reversed_starts{2, 70};
+  const auto reaching = lwyi::reached_from(graph.reversed(), reversed_starts);
+  CHECK(contains(reaching, 3));
+  CHECK(contains(reaching, 70));
+  CHECK(contains(reaching, 0));
+  CHECK_FALSE(contains(reaching, 4));
+}
+
+TEST_CASE("lwyi: transitive_reduction", "[lwyi]")
+{
+  // 3 → 2 → 1 → 0 with the shortcuts 3 → 1, 3 → 0 and 2 → 0, and 70 → 3 → 0 past the first word
+  std::vector<std::pair<uint32_t, uint32_t>> edges{
+    {1, 0}, {2, 0}, {2, 1}, {3, 0}, {3, 1}, {3, 2}, {70, 0}, {70, 3}};
+  const lwyi::Digraph dag(71, edges);
+
+  const auto reduced = lwyi::transitive_reduction(dag);
+
+  CHECK(reduced.vertex_count() == 71);
+  CHECK(reduced.edge_count() == 4);
+  CHECK(std::ranges::equal(reduced.successors(1), std::vector<uint32_t>{0}));
+  CHECK(std::ranges::equal(reduced.successors(2), std::vector<uint32_t>{1}));
+  CHECK(std::ranges::equal(reduced.successors(3), std::vector<uint32_t>{2}));
+  CHECK(std::ranges::equal(reduced.successors(70), std::vector<uint32_t>{3}));
+}
+
+TEST_CASE("lwyi: transitive_reduction keeps the reachability", "[lwyi]")
+{
+  constexpr uint32_t vertex_count = 150;
+  std::mt19937 random{11};
+  std::set<std::pair<uint32_t, uint32_t>> edges;
+  while (edges.size() < 1000)
+  {
+    const auto from = random() % vertex_count;
+    const auto to = random() % vertex_count;
+    if (to < from)
+    {
+      edges.emplace(from, to);
+    }
+  }
+  const std::vector<std::pair<uint32_t, uint32_t>> edge_list(edges.begin(), edges.end());
+  const lwyi::Digraph dag(vertex_count, edge_list);
+  const lwyi::Reachability expected(dag);
+
+  const auto reduced = lwyi::transitive_reduction(dag);
+  const lwyi::Reachability reachability(reduced);
+  for (uint32_t v = 0; v < vertex_count; ++v)
+  {
+    REQUIRE(std::ranges::equal(reachability.reached(v), expected.reached(v)));
+  }
+
+  // none of the edges that are left is implied by the others
+  for (uint32_t v = 0; v < vertex_count; ++v)
+  {
+    for (const auto w : reduced.successors(v))
+    {
+      for (const auto u : reduced.successors(v))
+      {
+        REQUIRE_FALSE(reachability.reaches(u, w));
+      }
+    }
+  }
+}
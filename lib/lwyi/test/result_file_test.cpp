@@ -0,0 +1,77 @@
+// Copyright (c) 2025 Environmental Systems Research Institute, Inc.
+// SPDX-License-Identifier: Apache-2.0
+
+#include <lwyi/result_file.hpp>
+
+#include <lwyi/check_target.hpp>
+#include <lwyi/dependency_visibility.hpp>
+#include <lwyi/session.hpp>
+#include <lwyi/shard.hpp>
+#include <scanner/include.hpp>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+
+TEST_CASE("lwyi: result file", "[lwyi]")
+{
+  const auto path = std::filesystem::temp_directory_path() / "lwyi_result_file_test.json";
+  std::filesystem::remove(path);
+
+  lwyi::Shard_result shard_result;
+  shard_result.shard = {2, 3};
+  auto& checked = shard_result.result.targets.emplace_back();
+  checked.target = {"lib \"a\""};
+  checked.duration = std::chrono::milliseconds(42);
+  auto& error = checked.errors.emplace_back();
+  error.target = {"libb"};
+  error.linked_visibility = lwyi::Dependency_visibility::private_scope;
+  error.included_visibility = lwyi::Dependency_visibility::public_scope;
+  error.sample_includes.push_back({"/src/b.hpp", {{"/src/a.hpp", 3}, {"/src/a.cpp", 1}}});
+  auto& failed = shard_result.result.targets.emplace_back();
+  failed.target = {"libc"};
+  failed.status = lwyi::Target_result::Status::scan_failed;
+  failed.scan_error = "line 1\n\tline 2";
+
+  REQUIRE(lwyi::write_result_file(path, shard_result).has_value());
+
+  auto read = lwyi::read_result_file(path);
+  REQUIRE(read.has_value());
+  CHECK(read->shard == lwyi::Shard{2, 3});
+  REQUIRE(read->result.targets.size() == 2U);
+
+  const auto& read_checked = read->result.targets[0];
+  CHECK(read_checked.target.name == "lib \"a\"");
+  CHECK(read_checked.status == lwyi::Target_result::Status::checked);
+  CHECK(read_checked.duration == std::chrono::milliseconds(42));
+  REQUIRE(read_checked.errors.size() == 1U);
+  CHECK(read_checked.errors[0].target.name == "libb");
+  CHECK(read_checked.errors[0].linked_visibility == lwyi::Dependency_visibility::private_scope);
+  CHECK(read_checked.errors[0].included_visibility == lwyi::Dependency_visibility::public_scope);
+  REQUIRE(read_checked.errors[0].sample_includes.size() == 1U);
+  const auto& include = read_checked.errors[0].sample_includes[0];
+  CHECK(include.path == "/src/b.hpp");
+  REQUIRE(include.include_chain.size() == 2U);
+  CHECK(include.include_chain[0].source == "/src/a.hpp");
+  CHECK(include.include_chain[0].line == 3U);
+
+  const auto& read_failed = read->result.targets[1];
+  CHECK(read_failed.status == lwyi::Target_result::Status::scan_failed);
+  CHECK(read_failed.scan_error == "line 1\n\tline 2");
+  CHECK(!read->result.success());
+
+  SECTION("unknown values are rejected")
+  {
+    std::ofstream(path) << R"({"version": 1, "shard": {"index": 1, "count": 1},
+                               "targets": [{"name": "liba", "status": "great"}]})";
+    CHECK(!lwyi::read_result_file(path).has_value());
+  }
+
+  SECTION("other versions are rejected")
+  {
+    std::ofstream(path) << R"({"version": 2, "targets": []})";
+    CHECK(!lwyi::read_result_file(path).has_value());
+  }
+}
@@ -0,0 +1,251 @@
+// Copyright (c) 2025 Environmental Systems Research Institute, Inc.
+// SPDX-License-Identifier: Apache-2.0
+
+#include <lwyi/session.hpp>
+
+#include <message/message.hpp>
+#include <target_model/target.hpp>
+#include <target_model/target_model.hpp>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <cstddef>
+#include <filesystem>
+#include <format>
+#include <fstream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace
+{
+void write_target_model(const std::filesystem::path& binary_dir, std::string_view json)
+{
+  std::ofstream(binary_dir / "link_what_you_include_info.json") << json;
+}
+} // namespace
+
+TEST_CASE("lwyi: session", "[lwyi]")
+{
+  const auto binary_dir = std::filesystem::temp_directory_path() / "lwyi_session_test";
+  std::filesystem::remove_all(binary_dir);
+  std::filesystem::create_directories(binary_dir);
+
+  SECTION("a build directory without a target model cannot be opened")
+  {
+    auto session = lwyi::Session::open(binary_dir, 1U);
+    CHECK(!session.has_value());
+  }
+
+  SECTION("targets without sources are skipped")
+  {
+    write_target_model(binary_dir, R"({
+      "liba": {"interface_include_directories": [], "interface_headers": [],
+               "interface_dependencies": [], "dependencies": [], "sources": []}
+    })");
+
+    auto session = lwyi::Session::open(binary_dir, 1U);
+    REQUIRE(session.has_value());
+    CHECK(session->thread_count() == 1U);
+    CHECK(!session->affected_targets({binary_dir / "a.cpp"}).has_value());
+
+    auto result = session->check({});
+    REQUIRE(result.targets.size() == 1U);
+    CHECK(result.targets[0].target == target_model::Target{"liba"});
+    CHECK(result.targets[0].status == lwyi::Target_result::Status::no_sources);
+    CHECK(result.success());
+
+    WHEN("an unknown target is checked")
+    {
+      std::vector<target_model::Target> started;
+      lwyi::Check_callbacks callbacks;
+      callbacks.target_started = [&](const target_model::Target& target)
+      {
+        started.push_back(target);
+      };
+
+      result = session->check({{"missing"}, {"liba"}}, callbacks);
+
+      THEN("the check fails and stops")
+      {
+        REQUIRE(result.targets.size() == 1U);
+        CHECK(result.targets[0].status == lwyi::Target_result::Status::unknown_target);
+        CHECK(!result.success());
+        CHECK(started == std::vector<target_model::Target>{{"missing"}});
+      }
+    }
+
+    WHEN("the target model is changed and reloaded")
+    {
+      write_target_model(binary_dir, R"({
+        "liba": {"interface_include_directories": [], "interface_headers": [],
+                 "interface_dependencies": [], "dependencies": [], "sources": []},
+        "libb": {"interface_include_directories": [], "interface_headers": [],
+                 "interface_dependencies": [], "dependencies": [], "sources": []}
+      })");
+      REQUIRE(session->reload_model().has_value());
+
+      THEN("the new targets are checked")
+      {
+        CHECK(session->check({}).targets.size() == 2U);
+        CHECK(session->target_model().get_target_data({"libb"}).has_value());
+      }
+    }
+  }
+
+  SECTION("targets are reported in the order they are given")
+  {
+    write_target_model(binary_dir, R"({
+      "liba": {"interface_include_directories": [], "interface_headers": [],
+               "interface_dependencies": [], "dependencies": [], "sources": []},
+      "libb": {"interface_include_directories": [], "interface_headers": [],
+               "interface_dependencies": [], "dependencies": [], "sources": []},
+      "libc": {"interface_include_directories": [], "interface_headers": [],
+               "interface_dependencies": [], "dependencies": [], "sources": []}
+    })");
+
+    auto session = lwyi::Session::open(binary_dir, 2U);
+    REQUIRE(session.has_value());
+
+    const std::vector<target_model::Target> targets{{"libc"}, {"liba"}, {"libb"}};
+    std::vector<target_model::Target> started;
+    std::vector<target_model::Target> finished;
+    lwyi::Check_callbacks callbacks;
+    callbacks.target_started = [&](const target_model::Target& target)
+    {
+      started.push_back(target);
+    };
+    callbacks.target_finished = [&](const lwyi::Target_result& target_result)
+    {
+      finished.push_back(target_result.target);
+    };
+    callbacks.render_report = [](const lwyi::Target_result& target_result)
+    {
+      return target_result.target.name + ";";
+    };
+    std::string reports;
+    callbacks.target_reported = [&](const lwyi::Target_result& /*target_result*/,
+                                    const std::string& report)
+    {
+      reports += report;
+    };
+
+    const auto result = session->check(targets, callbacks);
+    REQUIRE(result.targets.size() == 3U);
+    CHECK(result.targets[0].target == target_model::Target{"libc"});
+    CHECK(result.targets[2].target == target_model::Target{"libb"});
+    CHECK(started == targets);
+    CHECK(finished == targets);
+    CHECK(reports == "libc;liba;libb;");
+  }
+
+  SECTION("the output does not depend on the thread count")
+  {
+    // libb and libc include the header of liba without linking it
+    const auto dir = binary_dir.generic_string();
+    std::ofstream(binary_dir / "a.hpp") << "\n";
+    std::ofstream compile_commands(binary_dir / "compile_commands.json");
+    compile_commands << "[";
+    std::vector<std::string> sources(3);
+    for (int i = 0; i < 6; ++i)
+    {
+      const auto source = std::format("{}/{}{}.cpp", dir, "abc"[i / 2], i);
+      std::ofstream(source) << (i < 2 ? "\n" : "#include \"a.hpp\"\n");
+      sources[i / 2] += std::format(R"({}"{}")", i % 2 == 0 ? "" : ", ", source);
+      compile_commands << std::format(R"({}{{"directory": "{}", "file": "{}", "command": "{}"}})",
+                                      i == 0 ? "" : ",",
+                                      dir,
+                                      source,
+                                      "clang++ -c " + source);
+    }
+    compile_commands << "]";
+    compile_commands.close();
+    write_target_model(binary_dir,
+                       std::format(R"({{
+      "liba": {{"interface_include_directories": ["{0}"], "interface_headers": ["{0}/a.hpp"],
+               "interface_dependencies": [], "dependencies": [], "sources": [{1}]}},
+      "libb": {{"interface_include_directories": [], "interface_headers": [],
+               "interface_dependencies": [], "dependencies": [], "sources": [{2}]}},
+      "libc": {{"interface_include_directories": [], "interface_headers": [],
+               "interface_dependencies": [], "dependencies": [], "sources": [{3}]}}
+    }})",
+                                   dir,
+                                   sources[0],
+                                   sources[1],
+                                   sources[2]));
+
+    const auto check_output = [&](size_t thread_count)
+    {
+      auto session = lwyi::Session::open(binary_dir, thread_count);
+      REQUIRE(session.has_value());
+      lwyi::Check_callbacks callbacks;
+      callbacks.target_started = [](const target_model::Target& target)
+      {
+        message::heading("Target: {}", target.name);
+      };
+      callbacks.render_report = [](const lwyi::Target_result& target_result)
+      {
+        message::Capture capture;
+        message::print("{} errors", target_result.errors.size());
+        return capture.take();
+      };
+      callbacks.target_reported = [](const lwyi::Target_result& /*target_result*/,
+                                     const std::string& report)
+      {
+        message::write(report);
+      };
+
+      message::Capture capture;
+      CHECK(!session->check({}, callbacks).success());
+      return capture.take();
+    };
+
+    message::configure(message::Color_output::never, message::Message_level::verbose);
+    const auto serial_output = check_output(1U);
+    const auto parallel_output = check_output(4U);
+    message::configure(message::Color_output::never, message::Message_level::normal);
+
+    // the summary of the scans
+    CHECK(serial_output.find("Processed") != std::string::npos);
+    CHECK(parallel_output == serial_output);
+  }
+
+  std::filesystem::remove_all(binary_dir);
+}
+
+TEST_CASE("lwyi: read_changed_files", "[lwyi]")
+{
+  // a repository whose sources are in src, built in build
+  const auto root = std::filesystem::temp_directory_path() / "lwyi_changed_files_test";
+  std::filesystem::remove_all(root);
+  std::filesystem::create_directories(root / ".git");
+  std::filesystem::create_directories(root / "src" / "lib");
+  std::filesystem::create_directories(root / "build");
+  const auto list = root / "build" / "changed.txt";
+  std::ofstream(list) << "src/lib/a.cpp\n" << (root / "src" / "b.cpp").string() << "\n";
+  const std::vector<std::filesystem::path> expected{root / "src" / "lib" / "a.cpp",
+                                                    root / "src" / "b.cpp"};
+
+  SECTION("relative paths are relative to the repository of the configured sources")
+  {
+    std::ofstream(root / "build" / "CMakeCache.txt")
+      << "CMAKE_HOME_DIRECTORY:INTERNAL=" << (root / "src").string() << "\n";
+    // wherever lwyi is run from
+    const auto files =
+      lwyi::read_changed_files(list, root / "build", std::filesystem::temp_directory_path());
+    REQUIRE(files.has_value());
+    CHECK(*files == expected);
+  }
+
+  SECTION("without a CMake cache they are relative to the repository of the working directory")
+  {
+    const auto files = lwyi::read_changed_files(list, root / "build", root / "src" / "lib");
+    REQUIRE(files.has_value());
+    CHECK(*files == expected);
+  }
+
+  SECTION("a missing list is an error")
+  {
+    CHECK(!lwyi::read_changed_files(root / "missing.txt", root / "build", root).has_value());
+  }
+}
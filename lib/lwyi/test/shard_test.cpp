@@ -0,0 +1,146 @@
+// Copyright (c) 2025 Environmental Systems Research Institute, Inc.
+// SPDX-License-Identifier: Apache-2.0
+
+#include <lwyi/shard.hpp>
+
+#include <lwyi/scan_profile.hpp>
+#include <lwyi/session.hpp>
+#include <target_model/target.hpp>
+#include <target_model/target_data.hpp>
+#include <target_model/target_model.hpp>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <chrono>
+#include <cstddef>
+#include <filesystem>
+#include <format>
+#include <fstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace
+{
+target_model::Target_data target_data_with_sources(size_t source_count)
+{
+  target_model::Target_data target_data;
+  for (size_t i = 0; i < source_count; ++i)
+  {
+    target_data.sources.insert(std::format("/src/{}.cpp", i));
+  }
+  return target_data;
+}
+
+// liba to libe with 5, 4, 3, 2 and 1 sources
+target_model::Target_model make_target_model()
+{
+  std::vector<std::pair<target_model::Target, target_model::Target_data>> targets;
+  for (size_t i = 0; i < 5; ++i)
+  {
+    targets.emplace_back(target_model::Target{std::format("lib{}", static_cast<char>('a' + i))},
+                         target_data_with_sources(5 - i));
+  }
+  return target_model::Target_model(std::move(targets));
+}
+
+std::vector<target_model::Target> targets(std::initializer_list<const char*> names)
+{
+  std::vector<target_model::Target> result;
+  for (const auto* name : names)
+  {
+    result.push_back({name});
+  }
+  return result;
+}
+} // namespace
+
+TEST_CASE("lwyi: parse_shard", "[lwyi]")
+{
+  CHECK(lwyi::parse_shard("1/1") == lwyi::Shard{1, 1});
+  CHECK(lwyi::parse_shard("2/4") == lwyi::Shard{2, 4});
+  CHECK(!lwyi::parse_shard("0/4").has_value());
+  CHECK(!lwyi::parse_shard("5/4").has_value());
+  CHECK(!lwyi::parse_shard("2").has_value());
+  CHECK(!lwyi::parse_shard("2/").has_value());
+  CHECK(!lwyi::parse_shard("a/4").has_value());
+  CHECK(!lwyi::parse_shard("2/4x").has_value());
+}
+
+TEST_CASE("lwyi: select_shard", "[lwyi]")
+{
+  const auto target_model = make_target_model();
+  const lwyi::Scan_profile profile;
+
+  SECTION("a single shard checks every target")
+  {
+    CHECK(lwyi::select_shard(target_model, {}, profile, {1, 1}) ==
+          targets({"liba", "libb", "libc", "libd", "libe"}));
+  }
+
+  SECTION("targets are balanced by their number of translation units")
+  {
+    // 5 | 4 | 3 then 2 joins 3 and 1 joins 4
+    CHECK(lwyi::select_shard(target_model, {}, profile, {1, 3}) == targets({"liba"}));
+    CHECK(lwyi::select_shard(target_model, {}, profile, {2, 3}) == targets({"libb", "libe"}));
+    CHECK(lwyi::select_shard(target_model, {}, profile, {3, 3}) == targets({"libc", "libd"}));
+  }
+
+  SECTION("only the given targets are split")
+  {
+    const auto selected = targets({"libe", "libd", "libc"});
+    CHECK(lwyi::select_shard(target_model, selected, profile, {1, 2}) == targets({"libc"}));
+    CHECK(lwyi::select_shard(target_model, selected, profile, {2, 2}) ==
+          targets({"libe", "libd"}));
+  }
+
+  SECTION("more shards than targets leaves shards empty")
+  {
+    const auto selected = targets({"liba"});
+    CHECK(lwyi::select_shard(target_model, selected, profile, {1, 2}) == targets({"liba"}));
+    CHECK(lwyi::select_shard(target_model, selected, profile, {2, 2}).empty());
+  }
+
+  SECTION("recorded durations take precedence over the number of translation units")
+  {
+    const auto path = std::filesystem::temp_directory_path() / "lwyi_shard_test_profile.json";
+    std::ofstream(path) << R"({"version": 1, "targets": {"libe": 100, "liba": 50}})";
+    auto loaded = lwyi::Scan_profile::load(path);
+    REQUIRE(loaded.has_value());
+
+    // the profiled targets take 25 ms per translation unit so libb to libd are estimated at
+    // 100, 75 and 50 ms
+    CHECK(lwyi::select_shard(target_model, {}, *loaded, {1, 2}) == targets({"libb", "libc"}));
+    CHECK(lwyi::select_shard(target_model, {}, *loaded, {2, 2}) ==
+          targets({"liba", "libd", "libe"}));
+  }
+}
+
+TEST_CASE("lwyi: scan profile", "[lwyi]")
+{
+  const auto path = std::filesystem::temp_directory_path() / "lwyi_scan_profile_test.json";
+  std::filesystem::remove(path);
+
+  CHECK(!lwyi::Scan_profile::load(path).has_value());
+
+  lwyi::Check_result result;
+  result.targets.resize(2);
+  result.targets[0].target = {"liba"};
+  result.targets[0].duration = std::chrono::milliseconds(1200);
+  result.targets[1].target = {"libb"};
+  result.targets[1].status = lwyi::Target_result::Status::no_sources;
+
+  lwyi::Scan_profile profile;
+  CHECK(profile.empty());
+  profile.record(result);
+  CHECK(profile.duration({"liba"}) == std::chrono::milliseconds(1200));
+  CHECK(!profile.duration({"libb"}).has_value());
+
+  REQUIRE(profile.save(path).has_value());
+  auto loaded = lwyi::Scan_profile::load(path);
+  REQUIRE(loaded.has_value());
+  CHECK(loaded->duration({"liba"}) == std::chrono::milliseconds(1200));
+
+  std::ofstream(path) << R"({"version": 2, "targets": {}})";
+  CHECK(!lwyi::Scan_profile::load(path).has_value());
+}
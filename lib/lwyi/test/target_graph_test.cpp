@@ -0,0 +1,177 @@
+// Copyright (c) 2025 Environmental Systems Research Institute, Inc.
+// SPDX-License-Identifier: Apache-2.0
+
+#include <lwyi/target_graph.hpp>
+
+#include <target_model/target.hpp>
+#include <target_model/target_data.hpp>
+#include <target_model/target_model.hpp>
+
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <span>
+#include <utility>
+#include <vector>
+
+namespace
+{
+std::vector<uint32_t> sorted(std::span<const uint32_t> values)
+{
+  std::vector<uint32_t> result(values.begin(), values.end());
+  std::ranges::sort(result);
+  return result;
+}
+} // namespace
+
+TEST_CASE("lwyi: Digraph", "[lwyi]")
+{
+  const std::vector<std::pair<uint32_t, uint32_t>> edges{{2, 0}, {0, 1}, {0, 2}, {2, 1}};
+  const lwyi::Digraph graph(4, edges);
+
+  CHECK(graph.vertex_count() == 4);
+  CHECK(graph.edge_count() == 4);
+  CHECK(std::ranges::equal(graph.successors(0), std::vector<uint32_t>{1, 2}));
+  CHECK(graph.successors(1).empty());
+  CHECK(std::ranges::equal(graph.successors(2), std::vector<uint32_t>{0, 1}));
+  CHECK(graph.successors(3).empty());
+
+  const auto reversed = graph.reversed();
+  CHECK(reversed.edge_count() == 4);
+  CHECK(std::ranges::equal(reversed.successors(0), std::vector<uint32_t>{2}));
+  CHECK(sorted(reversed.successors(1)) == std::vector<uint32_t>{0, 2});
+  CHECK(std::ranges::equal(reversed.successors(2), std::vector<uint32_t>{0}));
+}
+
+TEST_CASE("lwyi: Target_graph", "[lwyi]")
+{
+  //    a
+  //   ↗ ↘
+  //  c ← b
+  //       ↘
+  //        d → e (not part of the model)
+
+  target_model::Target_data liba_target_data;
+  liba_target_data.dependencies = {{"b"}};
+
+  target_model::Target_data libb_target_data;
+  libb_target_data.dependencies = {{"c"}, {"d"}};
+
+  target_model::Target_data libc_target_data;
+  libc_target_data.dependencies = {{"a"}};
+
+  target_model::Target_data libd_target_data;
+  libd_target_data.dependencies = {{"e"}};
+
+  target_model::Target_model target_model{{
+    {{"a"}, liba_target_data},
+    {{"b"}, libb_target_data},
+    {{"c"}, libc_target_data},
+    {{"d"}, libd_target_data},
+  }};
+
+  const lwyi::Target_graph graph(target_model);
+
+  REQUIRE(graph.size() == 5);
+  CHECK(graph.target(0) == target_model::Target{"a"});
+  CHECK(graph.target(3) == target_model::Target{"d"});
+  CHECK(graph.target(4) == target_model::Target{"e"});
+  CHECK(graph.find({"c"}) == 2U);
+  CHECK_FALSE(graph.find({"x"}).has_value());
+  CHECK(sorted(graph.dependencies().successors(1)) == std::vector<uint32_t>{2, 3});
+  CHECK(graph.dependencies().successors(4).empty());
+
+  const lwyi::Strongly_connected_components components(graph.dependencies());
+
+  REQUIRE(components.size() == 3);
+  const auto cycle = components.component(0);
+  CHECK(components.component(1) == cycle);
+  CHECK(components.component(2) == cycle);
+  CHECK(sorted(components.members(cycle)) == std::vector<uint32_t>{0, 1, 2});
+
+  // reverse topological order: e, d, then the cycle
+  CHECK(components.component(4) == 0);
+  CHECK(components.component(3) == 1);
+  CHECK(cycle == 2);
+  const auto& condensation = components.condensation();
+  CHECK(condensation.edge_count() == 2);
+  CHECK(std::ranges::equal(condensation.successors(cycle), std::vector<uint32_t>{1}));
+  CHECK(std::ranges::equal(condensation.successors(1), std::vector<uint32_t>{0}));
+}
+
+TEST_CASE("lwyi: Strongly_connected_components", "[lwyi]")
+{
+  SECTION("a long chain does not exhaust the stack")
+  {
+    constexpr uint32_t length = 1'000'000;
+    std::vector<std::pair<uint32_t, uint32_t>> edges;
+    for (uint32_t v = 0; v + 1 < length; ++v)
+    {
+      edges.emplace_back(v, v + 1);
+    }
+    edges.emplace_back(length - 1, length / 2);
+
+    const lwyi::Strongly_connected_components components(lwyi::Digraph(length, edges));
+
+    CHECK(components.size() == length / 2 + 1);
+    CHECK(components.members(0).size() == length / 2);
+    CHECK(components.condensation().edge_count() == length / 2);
+  }
+
+  SECTION("edges of the condensation lead to lower components")
+  {
+    constexpr uint32_t vertex_count = 1000;
+    std::mt19937 random{42};
+    std::uniform_int_distribution<uint32_t> vertex(0, vertex_count - 1);
+    std::vector<std::pair<uint32_t, uint32_t>> edges(1500);
+    std::ranges::generate(edges, [&]() { return std::pair{vertex(random), vertex(random)}; });
+    const lwyi::Digraph graph(vertex_count, edges);
+
+    const lwyi::Strongly_connected_components components(graph);
+
+    size_t member_count = 0;
+    for (uint32_t component = 0; component < components.size(); ++component)
+    {
+      member_count += components.members(component).size();
+      for (const auto successor : components.condensation().successors(component))
+      {
+        CHECK(successor < component);
+      }
+    }
+    CHECK(member_count == vertex_count);
+    for (const auto& [from, to] : edges)
+    {
+      CHECK(components.component(to) <= components.component(from));
+    }
+  }
+}
+
+TEST_CASE("lwyi: Strongly_connected_components scaling", "[!benchmark][.]")
+{
+  // about as many edges per target as a large generated project
+  constexpr uint32_t vertex_count = 100'000;
+  constexpr size_t edge_count = 1'000'000;
+  std::mt19937 random{42};
+  std::uniform_int_distribution<uint32_t> vertex(0, vertex_count - 1);
+  std::vector<std::pair<uint32_t, uint32_t>> edges(edge_count);
+  std::ranges::generate(edges,
+                        [&]()
+                        {
+                          // mostly downwards, so there are components of all sizes
+                          const auto from = vertex(random);
+                          const auto to = vertex(random);
+                          return random() % 64 == 0 ? std::pair{from, to}
+                                                    : std::pair{std::max(from, to),
+                                                                std::min(from, to)};
+                        });
+  const lwyi::Digraph graph(vertex_count, edges);
+
+  BENCHMARK("1M edges")
+  {
+    return lwyi::Strongly_connected_components(graph).size();
+  };
+}
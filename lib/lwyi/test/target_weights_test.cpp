@@ -0,0 +1,64 @@
+// Copyright (c) 2025 Environmental Systems Research Institute, Inc.
+// SPDX-License-Identifier: Apache-2.0
+
+#include <lwyi/target_weights.hpp>
+
+#include <lwyi/scan_profile.hpp>
+#include <lwyi/target_graph.hpp>
+#include <target_model/target.hpp>
+#include <target_model/target_data.hpp>
+#include <target_model/target_model.hpp>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+TEST_CASE("lwyi: target weights", "[lwyi]")
+{
+  const auto dir = std::filesystem::temp_directory_path() / "lwyi_target_weights_test";
+  std::filesystem::create_directories(dir);
+  std::ofstream(dir / "a1.cpp") << std::string(100, ' ');
+  std::ofstream(dir / "a2.cpp") << std::string(20, ' ');
+  std::ofstream(dir / "b.cpp") << std::string(3, ' ');
+
+  // liba depends on ext, which is not part of the model
+  target_model::Target_data liba;
+  liba.sources = {dir / "a1.cpp", dir / "a2.cpp"};
+  liba.dependencies = {{"ext"}};
+  target_model::Target_data libb;
+  libb.sources = {dir / "b.cpp", dir / "missing.cpp"};
+  const target_model::Target_model target_model({{{"liba"}, liba}, {{"libb"}, libb}});
+  const lwyi::Target_graph graph(target_model);
+  REQUIRE(graph.size() == 3U);
+
+  SECTION("sources")
+  {
+    CHECK(lwyi::target_weights(target_model, graph, lwyi::Target_weight::sources) ==
+          std::vector<uint64_t>{2U, 2U, 0U});
+  }
+
+  SECTION("source bytes")
+  {
+    CHECK(lwyi::target_weights(target_model, graph, lwyi::Target_weight::source_bytes) ==
+          std::vector<uint64_t>{120U, 3U, 0U});
+  }
+
+  SECTION("timing from a scan profile")
+  {
+    // the format documented by critical-path --timing
+    const auto path = dir / "profile.json";
+    std::ofstream(path) << R"({"version": 1, "targets": {"liba": 1200, "ext": 50}})";
+    auto profile = lwyi::Scan_profile::load(path);
+    REQUIRE(profile.has_value());
+    CHECK(lwyi::target_weights(target_model, graph, *profile) ==
+          std::vector<uint64_t>{1200U, 0U, 0U});
+
+    // a file without a version is not a scan profile
+    std::ofstream(path) << R"({"targets": {"liba": 1200}})";
+    CHECK(!lwyi::Scan_profile::load(path).has_value());
+  }
+}
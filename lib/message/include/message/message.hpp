@@ -5,6 +5,7 @@
 
 #include <cstdint>
 #include <format>
+#include <string>
 #include <string_view>
 #include <utility>
 
@@ -47,6 +48,29 @@ void warning(std::string_view text);
 void debug(std::string_view text);
 bool verbose_enabled();
 
+// Collects the messages of the current thread instead of printing them, e.g. to print the output
+// of work done in parallel in a fixed order with write
+class Capture
+{
+public:
+  Capture();
+  ~Capture();
+  Capture(const Capture&) = delete;
+  Capture(Capture&&) = delete;
+  Capture& operator=(const Capture&) = delete;
+  Capture& operator=(Capture&&) = delete;
+
+  // The messages collected so far
+  std::string take();
+
+private:
+  std::string text_;
+  std::string* previous_;
+};
+
+// Print messages collected by a Capture
+void write(std::string_view captured);
+
 template <typename... TArgs>
 void print(std::format_string<TArgs...> format, TArgs&&... args)
 {
@@ -6,6 +6,7 @@
 #include <iostream>
 #include <string>
 #include <string_view>
+#include <utility>
 
 #ifdef _WIN32
 #include <windows.h>
@@ -25,6 +26,20 @@ struct Output_options
 
 Output_options g_options{}; // NOLINT(cppcoreguidelines-avoid-non-const-global-variables)
 
+// set while a Capture of the thread is alive
+thread_local std::string* t_capture = nullptr;
+
+void emit(std::string_view line)
+{
+  if (t_capture)
+  {
+    *t_capture += line;
+    *t_capture += '\n';
+    return;
+  }
+  std::cout << line << '\n';
+}
+
 #ifdef _WIN32
 bool enable_virtual_terminal_processing(HANDLE handle)
 {
@@ -126,14 +141,39 @@ bool verbose_enabled()
   return message_level() >= Message_level::verbose;
 }
 
+Capture::Capture()
+: previous_(std::exchange(t_capture, &text_))
+{
+}
+
+Capture::~Capture()
+{
+  t_capture = previous_;
+}
+
+std::string Capture::take()
+{
+  return std::exchange(text_, {});
+}
+
+void write(std::string_view captured)
+{
+  if (t_capture)
+  {
+    *t_capture += captured;
+    return;
+  }
+  std::cout << captured;
+}
+
 void print(std::string_view text, Style style)
 {
-  std::cout << paint(text, style) << '\n';
+  emit(paint(text, style));
 }
 
 void blank_line()
 {
-  std::cout << '\n';
+  emit({});
 }
 
 void heading(std::string_view text)
@@ -143,7 +183,7 @@ void heading(std::string_view text)
 
 void status(std::string_view label, std::string_view text, Style style)
 {
-  std::cout << paint(label, style) << ": " << text << '\n';
+  emit(paint(label, style) + ": " + std::string{text});
 }
 
 void info(std::string_view text)
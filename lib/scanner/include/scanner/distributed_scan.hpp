@@ -0,0 +1,57 @@
+// Copyright (c) 2025 Environmental Systems Research Institute, Inc.
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <expected>
+#include <memory>
+#include <string>
+#include <string_view>
+
+namespace scanner
+{
+struct Coordinator_timeouts
+{
+  // How long to wait while no worker is connected before leaving the remaining translation
+  // units to the local scan
+  std::chrono::milliseconds idle{std::chrono::minutes(1)};
+  // How long a worker may take for a batch before it is considered lost
+  std::chrono::milliseconds batch{std::chrono::minutes(10)};
+};
+
+// Hands the translation units a scanner needs to preprocess to worker processes, on this or any
+// other host that sees the source tree at the same paths. Workers ask for a batch whenever they
+// are done with the previous one, so fast workers take more of the work. Addresses are
+// HOST:PORT for TCP or the path of a Unix domain socket.
+class Scan_coordinator
+{
+public:
+  static std::expected<Scan_coordinator, std::string> listen(std::string_view address,
+                                                            Coordinator_timeouts timeouts = {});
+
+  ~Scan_coordinator();
+  Scan_coordinator(const Scan_coordinator&) = delete;
+  Scan_coordinator(Scan_coordinator&& other) noexcept;
+  Scan_coordinator& operator=(const Scan_coordinator&) = delete;
+  Scan_coordinator& operator=(Scan_coordinator&& other) noexcept;
+
+  const std::string& address() const;
+
+private:
+  friend class Scanner;
+  struct Impl;
+
+  explicit Scan_coordinator(std::unique_ptr<Impl> impl);
+
+  std::unique_ptr<Impl> impl_;
+};
+
+// Preprocess the translation units handed out by the coordinator until it has no more. Returns
+// the number of translation units preprocessed. A translation unit that takes longer than a
+// non-zero tu_timeout fails and is left to the coordinator.
+std::expected<size_t, std::string> run_scan_worker(std::string_view address,
+                                                   size_t thread_count,
+                                                   std::chrono::milliseconds tu_timeout);
+} // namespace scanner
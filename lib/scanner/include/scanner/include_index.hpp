@@ -0,0 +1,37 @@
+// Copyright (c) 2025 Environmental Systems Research Institute, Inc.
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+
+#include <filesystem>
+#include <map>
+#include <set>
+#include <unordered_map>
+#include <vector>
+
+namespace scanner
+{
+// Records, for every scanned translation unit, the set of files that were read while
+// preprocessing it. The reverse index from every file to the translation units that read it
+// answers which translation units need to be scanned again when some of those files change.
+class Include_index
+{
+public:
+  // Replace the recorded files for a translation unit
+  void update(const std::filesystem::path& source, std::set<std::filesystem::path> files);
+
+  bool empty() const;
+
+  // Every file read by any of the translation units
+  std::set<std::filesystem::path> files() const;
+
+  // The translation units that read any of the given files. A changed file that is itself a
+  // recorded translation unit is also part of the result.
+  std::set<std::filesystem::path> affected_sources(
+    const std::vector<std::filesystem::path>& changed_files) const;
+
+private:
+  std::map<std::filesystem::path, std::set<std::filesystem::path>> source_to_files_;
+  std::unordered_map<std::filesystem::path, std::vector<std::filesystem::path>> file_to_sources_;
+};
+} // namespace scanner
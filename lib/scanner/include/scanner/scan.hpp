@@ -4,12 +4,16 @@
 #pragma once
 
 #include <scanner/include.hpp>
+#include <scanner/include_index.hpp>
 
+#include <chrono>
 #include <cstddef>
+#include <cstdint>
 #include <expected>
 #include <filesystem>
 #include <memory>
 #include <string>
+#include <string_view>
 #include <vector>
 
 namespace target_model
@@ -19,6 +23,8 @@ struct Target_data;
 
 namespace scanner
 {
+class Scan_coordinator;
+
 struct Intransitive_includes
 {
   std::vector<Include> interface_includes;
@@ -35,14 +41,67 @@ public:
   Scanner& operator=(const Scanner&) = delete;
   Scanner& operator=(Scanner&&) = delete;
 
+  size_t thread_count() const;
+
+  // Read compile_commands.json of the build directory ahead of the first scan. Scans read it
+  // themselves when this was not called.
+  std::expected<void, std::string> load_compilation_database(
+    const std::filesystem::path& binary_dir);
+
   std::expected<Intransitive_includes, std::string> scan(
     const std::filesystem::path& binary_dir,
     const target_model::Target_data& target_data);
 
+  // Record the include graphs of the translation units of the targets on the workers of the
+  // coordinator, so the following scans only have to classify them. Translation units the
+  // workers fail to preprocess are left to the following scans. Returns the number of recorded
+  // graphs.
+  std::expected<size_t, std::string> scan_on_workers(
+    const std::filesystem::path& binary_dir,
+    const std::vector<const target_model::Target_data*>& targets,
+    Scan_coordinator& coordinator);
+
+  // The include graph of every scanned translation unit is recorded. Graphs loaded from a
+  // previous run are reused instead of preprocessing again when the compile command is the
+  // same and none of the files read were modified since, unless a rescan is forced.
+  std::expected<void, std::string> load_include_graphs(const std::filesystem::path& path);
+  std::expected<void, std::string> save_include_graphs(const std::filesystem::path& path) const;
+  void force_rescan(bool rescan);
+
+  // Stop preprocessing the rest of a target once one of its translation units failed
+  void set_fail_fast(bool fail_fast);
+
+  // Give up on a translation unit that takes longer to preprocess. Zero means no limit.
+  void set_tu_timeout(std::chrono::milliseconds tu_timeout);
+
+  // Start fewer translation units at once while the resident memory of the process gets close
+  // to the limit in bytes. Zero means no limit.
+  void set_memory_limit(uint64_t memory_limit);
+
+  // Preprocess in as many child processes as there are threads. A translation unit that crashes
+  // the preprocessor then fails on its own instead of taking the whole scan down with it. The
+  // processes run the current executable with scan_process_argument, see run_scan_process.
+  void use_process_isolation(bool isolate);
+
+  // The files read by every translation unit recorded so far
+  Include_index include_index() const;
+
+  // The compilation database and the contents of files read while scanning are cached across
+  // scans. Forget everything that depends on the given files.
+  void invalidate(const std::vector<std::filesystem::path>& changed_files);
+
 private:
   struct Impl;
 
   std::unique_ptr<Impl> impl_;
 };
 
+// An executable that uses process isolation must call run_scan_process first thing when this is
+// its only argument
+inline constexpr std::string_view scan_process_argument = "--scan-process";
+
+// The loop of a process started for process isolation, recording the include graphs its parent
+// sends. Returns the exit code of the process.
+int run_scan_process();
+
 } // namespace scanner
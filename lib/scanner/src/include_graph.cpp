@@ -0,0 +1,256 @@
+// Copyright (c) 2025 Environmental Systems Research Institute, Inc.
+// SPDX-License-Identifier: Apache-2.0
+
+#include <src/include_graph.hpp>
+
+#include <message/message.hpp>
+#include <scanner/include.hpp>
+#include <src/scan_impl.hpp>
+#include <target_model/target_data.hpp>
+
+#include <cassert>
+#include <cstdint>
+#include <filesystem>
+#include <span>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace scanner
+{
+namespace
+{
+struct File_class
+{
+  bool interface_header{false};
+  bool private_source{false};
+};
+
+class Include_classifier
+{
+  std::span<const std::filesystem::path> files_;
+  const target_model::Target_data& target_data_;
+  Include_data include_data_;
+  std::unordered_map<uint32_t, File_class> file_classes_;
+
+  Source_line last_include_loc_;
+  std::vector<Source_line> include_chain_;
+  uint32_t current_file_{0U};
+  Include_set* current_include_set_{nullptr};
+
+  enum class Context : uint8_t
+  {
+    arbitrary_file,
+    source_file,
+    interface_header
+  };
+  Context context_{Context::arbitrary_file};
+
+  const File_class& classify_(uint32_t file)
+  {
+    auto [it, inserted] = file_classes_.try_emplace(file);
+    if (inserted)
+    {
+      it->second.interface_header = target_model::is_interface_header(target_data_, path_(file));
+      it->second.private_source = target_model::is_private_source(target_data_, path_(file));
+    }
+    return it->second;
+  }
+
+  const std::filesystem::path& path_(uint32_t file) const
+  {
+    assert(file < files_.size());
+    return files_[file];
+  }
+
+  void file_changed_(const Include_event& event)
+  {
+    const bool enter = event.kind == Include_event_kind::enter_file;
+    current_file_ = event.file;
+    const auto& current_source_file = path_(current_file_);
+
+    message::debug("# {} {}", (enter ? "Enter" : "Reenter"), current_source_file.string());
+
+    const auto previous_context = context_;
+    const auto previous_include_set = current_include_set_;
+    const auto& file_class = classify_(current_file_);
+
+    if (!event.main_file && file_class.interface_header)
+    {
+      message::debug("Context interface header");
+      context_ = Context::interface_header;
+      current_include_set_ = &include_data_.interface_header_includes[current_source_file];
+    }
+    else if (file_class.private_source)
+    {
+      message::debug("Context source");
+      context_ = Context::source_file;
+      current_include_set_ = &include_data_.includes;
+    }
+    else
+    {
+      message::debug("Context arbitrary file");
+      context_ = Context::arbitrary_file;
+      current_include_set_ = nullptr;
+    }
+
+    if (enter)
+    {
+      if (!last_include_loc_.source.empty())
+      {
+        message::debug("Push include chain {}", last_include_loc_.source.string());
+        include_chain_.emplace_back(last_include_loc_);
+      }
+
+      if (previous_include_set && context_ == Context::arbitrary_file)
+      {
+        message::debug("Dependency added to previous context: {} ({})",
+                       current_source_file.string(),
+                       static_cast<const void*>(previous_include_set));
+        previous_include_set->emplace(Include{current_source_file, include_chain_});
+      }
+    }
+    else
+    {
+      if (!include_chain_.empty())
+      {
+        message::debug("Pop include chain {}", include_chain_.back().source.string());
+        include_chain_.pop_back();
+      }
+
+      if (previous_context == Context::interface_header && context_ != Context::arbitrary_file)
+      {
+        message::debug("Dependency propagation");
+        // propagate includes
+        for (const auto& e : *previous_include_set)
+        {
+          message::debug("Dependency added to current context: {} ({})",
+                         e.path.string(),
+                         static_cast<const void*>(current_include_set_));
+          current_include_set_->insert(e);
+        }
+      }
+    }
+  }
+
+  void file_skipped_(const Include_event& event)
+  {
+    const auto& filename = path_(event.file);
+
+    message::debug("file skipped: {}", filename.string());
+
+    if (context_ == Context::arbitrary_file)
+    {
+      return;
+    }
+
+    const auto& file_class = classify_(event.file);
+    if (file_class.interface_header || file_class.private_source)
+    {
+      if (auto it = include_data_.interface_header_includes.find(filename);
+          it != include_data_.interface_header_includes.end())
+      {
+        message::debug("Dependency propagation");
+        // propagate includes
+        for (const auto& e : it->second)
+        {
+          message::debug("Dependency added: {} ({})",
+                         e.path.string(),
+                         static_cast<const void*>(current_include_set_));
+          current_include_set_->insert(e);
+        }
+      }
+    }
+    else
+    {
+      message::debug("Dependency added: {} ({})",
+                     filename.string(),
+                     static_cast<const void*>(current_include_set_));
+      auto include_chain = include_chain_;
+      if (!last_include_loc_.source.empty())
+      {
+        include_chain.emplace_back(last_include_loc_);
+      }
+      current_include_set_->emplace(Include{filename, std::move(include_chain)});
+    }
+  }
+
+public:
+  Include_classifier(std::span<const std::filesystem::path> files,
+                     const target_model::Target_data& target_data)
+  : files_(files),
+    target_data_(target_data)
+  {
+  }
+
+  void replay(std::span<const Include_event> events)
+  {
+    for (const auto& event : events)
+    {
+      switch (event.kind)
+      {
+        case Include_event_kind::predefines:
+          context_ = Context::arbitrary_file;
+          break;
+        case Include_event_kind::enter_file:
+        case Include_event_kind::reenter_file:
+          file_changed_(event);
+          break;
+        case Include_event_kind::skip_file:
+          file_skipped_(event);
+          break;
+        case Include_event_kind::include_directive:
+          assert(event.file == current_file_);
+          last_include_loc_ = Source_line{path_(event.file), event.line};
+          break;
+      }
+    }
+  }
+
+  Include_data take()
+  {
+    return std::move(include_data_);
+  }
+};
+} // namespace
+
+uint32_t Include_graph_builder::file_id(const std::filesystem::path& path)
+{
+  auto [it, inserted] =
+    file_ids_.try_emplace(path, static_cast<uint32_t>(graph_.files.size()));
+  if (inserted)
+  {
+    graph_.files.push_back(path);
+  }
+  return it->second;
+}
+
+void Include_graph_builder::add_event(Include_event event)
+{
+  graph_.events.push_back(event);
+}
+
+void Include_graph_builder::add_directory(const std::filesystem::path& path)
+{
+  if (directories_.insert(path).second)
+  {
+    graph_.directories.push_back(path);
+  }
+}
+
+Include_graph Include_graph_builder::take()
+{
+  file_ids_.clear();
+  directories_.clear();
+  return std::exchange(graph_, {});
+}
+
+Include_data classify_includes(std::span<const Include_event> events,
+                               std::span<const std::filesystem::path> files,
+                               const target_model::Target_data& target_data)
+{
+  Include_classifier classifier(files, target_data);
+  classifier.replay(events);
+  return classifier.take();
+}
+} // namespace scanner
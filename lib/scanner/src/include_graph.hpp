@@ -0,0 +1,74 @@
+// Copyright (c) 2025 Environmental Systems Research Institute, Inc.
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <span>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace target_model
+{
+struct Target_data;
+}
+
+namespace scanner
+{
+struct Include_data;
+
+enum class Include_event_kind : uint8_t
+{
+  predefines,        // the predefines buffer was entered or exited
+  enter_file,        // a file was entered because of an include or as the main file
+  reenter_file,      // the includer was reentered after an included file was finished
+  skip_file,         // an included file was skipped because of an include guard
+  include_directive, // an include directive in the current file, file is the includer
+};
+
+// One preprocessor event. The layout is fixed so arrays of events can be written to and mapped
+// from disk as is.
+struct Include_event
+{
+  Include_event_kind kind{Include_event_kind::predefines};
+  uint8_t main_file{0U};
+  uint16_t reserved{0U};
+  uint32_t file{0U};
+  uint32_t line{0U};
+};
+static_assert(sizeof(Include_event) == 12);
+
+// The file level include graph of a single translation unit, recorded as the sequence of
+// preprocessor events before any target classification. Files are nodes and include directives
+// followed by an enter or skip event are the edges.
+struct Include_graph
+{
+  std::vector<std::filesystem::path> files;
+  std::vector<Include_event> events;
+  // The directories searched for includes. A header created in one of them can shadow a file
+  // that was found further down the search path without touching any of the files.
+  std::vector<std::filesystem::path> directories;
+};
+
+class Include_graph_builder
+{
+public:
+  uint32_t file_id(const std::filesystem::path& path);
+  void add_event(Include_event event);
+  void add_directory(const std::filesystem::path& path);
+  Include_graph take();
+
+private:
+  Include_graph graph_;
+  std::unordered_map<std::filesystem::path, uint32_t> file_ids_;
+  std::unordered_set<std::filesystem::path> directories_;
+};
+
+// Replay the recorded events, classifying every file with respect to the target. The event
+// file ids index into files.
+Include_data classify_includes(std::span<const Include_event> events,
+                               std::span<const std::filesystem::path> files,
+                               const target_model::Target_data& target_data);
+} // namespace scanner
@@ -0,0 +1,508 @@
+// Copyright (c) 2025 Environmental Systems Research Institute, Inc.
+// SPDX-License-Identifier: Apache-2.0
+
+#include <src/include_graph_db.hpp>
+
+#include <scanner/include_index.hpp>
+#include <src/include_graph.hpp>
+#include <src/mapped_file.hpp>
+#include <src/scan_impl.hpp>
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <expected>
+#include <filesystem>
+#include <format>
+#include <fstream>
+#include <ios>
+#include <map>
+#include <optional>
+#include <set>
+#include <span>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace scanner
+{
+namespace
+{
+// The database is a single binary file in native byte order made of 8 byte aligned sections
+// that follow the header in this order:
+//   string offsets  uint64_t[string_count + 1], offsets into the string blob
+//   string blob     char[string_bytes], paths and arguments without terminators
+//   records         Record_entry[record_count]
+//   arguments       uint32_t[argument_count], string ids
+//   files           uint32_t[file_count], string ids
+//   directories     uint32_t[directory_count], string ids
+//   events          Include_event[event_count], file ids are local to the record
+//   durations       Duration_entry[duration_count]
+// All sections are flat arrays so the file can be mapped and read without parsing.
+constexpr std::array<char, 8> magic = {'L', 'W', 'Y', 'I', 'G', 'D', 'B', '1'};
+constexpr uint32_t version = 3U;
+
+struct Header
+{
+  std::array<char, 8> magic{};
+  uint32_t version{0U};
+  uint32_t record_count{0U};
+  uint64_t string_count{0U};
+  uint64_t string_bytes{0U};
+  uint64_t argument_count{0U};
+  uint64_t file_count{0U};
+  uint64_t directory_count{0U};
+  uint64_t event_count{0U};
+  uint64_t duration_count{0U};
+};
+static_assert(sizeof(Header) == 72);
+
+struct Record_entry
+{
+  uint32_t cwd{0U};
+  uint32_t source{0U};
+  uint32_t first_argument{0U};
+  uint32_t argument_count{0U};
+  int64_t scan_time{0};
+  uint64_t first_file{0U};
+  uint64_t file_count{0U};
+  uint64_t first_directory{0U};
+  uint64_t directory_count{0U};
+  uint64_t first_event{0U};
+  uint64_t event_count{0U};
+};
+static_assert(sizeof(Record_entry) == 72);
+
+struct Duration_entry
+{
+  uint32_t source{0U};
+  uint32_t milliseconds{0U};
+};
+static_assert(sizeof(Duration_entry) == 8);
+
+constexpr size_t aligned(size_t size)
+{
+  return (size + 7U) & ~size_t{7U};
+}
+
+std::string make_key(const Compile_command& compile_command)
+{
+  std::string key = compile_command.cwd.generic_string();
+  for (const auto& arg : compile_command.command)
+  {
+    key += '\0';
+    key += arg;
+  }
+  return key;
+}
+
+class String_table
+{
+public:
+  uint32_t id(const std::string& str)
+  {
+    auto [it, inserted] = ids_.try_emplace(str, static_cast<uint32_t>(offsets_.size() - 1U));
+    if (inserted)
+    {
+      blob_ += str;
+      offsets_.push_back(blob_.size());
+    }
+    return it->second;
+  }
+
+  const std::vector<uint64_t>& offsets() const
+  {
+    return offsets_;
+  }
+
+  const std::string& blob() const
+  {
+    return blob_;
+  }
+
+private:
+  std::unordered_map<std::string, uint32_t> ids_;
+  std::vector<uint64_t> offsets_{0U};
+  std::string blob_;
+};
+
+template <class T>
+void write_section(std::ofstream& ofs, std::span<const T> values)
+{
+  constexpr std::array<char, 8> padding{};
+  const auto size = values.size_bytes();
+  ofs.write(reinterpret_cast<const char*>(values.data()), // NOLINT(cppcoreguidelines-pro-type-reinterpret-cast)
+            static_cast<std::streamsize>(size));
+  ofs.write(padding.data(), static_cast<std::streamsize>(aligned(size) - size));
+}
+
+class Section_reader
+{
+public:
+  explicit Section_reader(std::span<const std::byte> bytes)
+  : bytes_(bytes)
+  {
+  }
+
+  // Copy the next section of count values, or nothing if the file is truncated
+  template <class T>
+  std::optional<std::vector<T>> read(uint64_t count)
+  {
+    if (count > (bytes_.size() - offset_) / sizeof(T))
+    {
+      return std::nullopt;
+    }
+    std::vector<T> values(count);
+    std::memcpy(values.data(), bytes_.data() + offset_, count * sizeof(T));
+    offset_ += aligned(count * sizeof(T));
+    offset_ = std::min(offset_, bytes_.size());
+    return values;
+  }
+
+private:
+  std::span<const std::byte> bytes_;
+  size_t offset_{0U};
+};
+} // namespace
+
+std::optional<int64_t> File_time_cache::modification_time(const std::filesystem::path& path)
+{
+  auto [it, inserted] = times_.try_emplace(path);
+  if (inserted)
+  {
+    std::error_code ec;
+    const auto time = std::filesystem::last_write_time(path, ec);
+    if (!ec)
+    {
+      it->second = time.time_since_epoch().count();
+    }
+  }
+  return it->second;
+}
+
+int64_t current_file_time()
+{
+  return std::filesystem::file_time_type::clock::now().time_since_epoch().count();
+}
+
+std::expected<Include_graph_db, std::string> Include_graph_db::load(
+  const std::filesystem::path& path)
+{
+  auto file = Mapped_file::open(path);
+  if (!file)
+  {
+    return std::unexpected(file.error());
+  }
+
+  const auto unexpected_format = [&]
+  {
+    return std::unexpected(std::format("Unexpected include graph format in {}", path.string()));
+  };
+
+  Section_reader reader(file->bytes());
+  auto header = reader.read<Header>(1U);
+  if (!header || header->front().magic != magic || header->front().version != version)
+  {
+    return unexpected_format();
+  }
+  const auto& h = header->front();
+
+  auto offsets = reader.read<uint64_t>(h.string_count + 1U);
+  auto blob = reader.read<char>(h.string_bytes);
+  auto records = reader.read<Record_entry>(h.record_count);
+  auto arguments = reader.read<uint32_t>(h.argument_count);
+  auto files = reader.read<uint32_t>(h.file_count);
+  auto directories = reader.read<uint32_t>(h.directory_count);
+  auto events = reader.read<Include_event>(h.event_count);
+  auto durations = reader.read<Duration_entry>(h.duration_count);
+  if (!offsets || !blob || !records || !arguments || !files || !directories || !events ||
+      !durations)
+  {
+    return unexpected_format();
+  }
+
+  std::vector<std::string_view> strings;
+  strings.reserve(h.string_count);
+  for (size_t i = 0; i < h.string_count; ++i)
+  {
+    const auto first = (*offsets)[i];
+    const auto last = (*offsets)[i + 1U];
+    if (first > last || last > blob->size())
+    {
+      return unexpected_format();
+    }
+    strings.emplace_back(blob->data() + first, last - first);
+  }
+
+  const auto in_range = [](uint64_t first, uint64_t count, size_t size)
+  {
+    return first <= size && count <= size - first;
+  };
+  const auto valid_id = [&](uint32_t id)
+  {
+    return id < strings.size();
+  };
+
+  Include_graph_db db;
+  for (const auto& entry : *records)
+  {
+    if (!valid_id(entry.cwd) || !valid_id(entry.source) ||
+        !in_range(entry.first_argument, entry.argument_count, arguments->size()) ||
+        !in_range(entry.first_file, entry.file_count, files->size()) ||
+        !in_range(entry.first_directory, entry.directory_count, directories->size()) ||
+        !in_range(entry.first_event, entry.event_count, events->size()))
+    {
+      return unexpected_format();
+    }
+
+    Include_graph_record record;
+    record.compile_command.cwd = strings[entry.cwd];
+    record.compile_command.source = strings[entry.source];
+    record.scan_time = entry.scan_time;
+    for (size_t i = 0; i < entry.argument_count; ++i)
+    {
+      const auto id = (*arguments)[entry.first_argument + i];
+      if (!valid_id(id))
+      {
+        return unexpected_format();
+      }
+      record.compile_command.command.emplace_back(strings[id]);
+    }
+    for (size_t i = 0; i < entry.file_count; ++i)
+    {
+      const auto id = (*files)[entry.first_file + i];
+      if (!valid_id(id))
+      {
+        return unexpected_format();
+      }
+      record.graph.files.emplace_back(strings[id]);
+    }
+    for (size_t i = 0; i < entry.directory_count; ++i)
+    {
+      const auto id = (*directories)[entry.first_directory + i];
+      if (!valid_id(id))
+      {
+        return unexpected_format();
+      }
+      record.graph.directories.emplace_back(strings[id]);
+    }
+    for (size_t i = 0; i < entry.event_count; ++i)
+    {
+      const auto& event = (*events)[entry.first_event + i];
+      if (event.kind != Include_event_kind::predefines && event.file >= entry.file_count)
+      {
+        return unexpected_format();
+      }
+      record.graph.events.push_back(event);
+    }
+
+    db.update(std::move(record));
+  }
+
+  for (const auto& entry : *durations)
+  {
+    if (!valid_id(entry.source))
+    {
+      return unexpected_format();
+    }
+    db.scan_durations_.insert_or_assign(std::filesystem::path(strings[entry.source]),
+                                        std::chrono::milliseconds(entry.milliseconds));
+  }
+
+  return db;
+}
+
+std::expected<void, std::string> Include_graph_db::save(const std::filesystem::path& path) const
+{
+  String_table strings;
+  std::vector<Record_entry> records;
+  std::vector<uint32_t> arguments;
+  std::vector<uint32_t> files;
+  std::vector<uint32_t> directories;
+  std::vector<Include_event> events;
+
+  records.reserve(records_.size());
+  for (const auto& [key, record] : records_)
+  {
+    Record_entry entry;
+    entry.cwd = strings.id(record.compile_command.cwd.generic_string());
+    entry.source = strings.id(record.compile_command.source.generic_string());
+    entry.first_argument = static_cast<uint32_t>(arguments.size());
+    entry.argument_count = static_cast<uint32_t>(record.compile_command.command.size());
+    entry.scan_time = record.scan_time;
+    entry.first_file = files.size();
+    entry.file_count = record.graph.files.size();
+    entry.first_directory = directories.size();
+    entry.directory_count = record.graph.directories.size();
+    entry.first_event = events.size();
+    entry.event_count = record.graph.events.size();
+
+    for (const auto& arg : record.compile_command.command)
+    {
+      arguments.push_back(strings.id(arg));
+    }
+    for (const auto& file : record.graph.files)
+    {
+      files.push_back(strings.id(file.generic_string()));
+    }
+    for (const auto& directory : record.graph.directories)
+    {
+      directories.push_back(strings.id(directory.generic_string()));
+    }
+    events.insert(events.end(), record.graph.events.begin(), record.graph.events.end());
+    records.push_back(entry);
+  }
+
+  std::vector<Duration_entry> durations;
+  durations.reserve(scan_durations_.size());
+  for (const auto& [source, duration] : scan_durations_)
+  {
+    durations.push_back(Duration_entry{strings.id(source.generic_string()),
+                                       static_cast<uint32_t>(duration.count())});
+  }
+
+  Header header;
+  header.magic = magic;
+  header.version = version;
+  header.record_count = static_cast<uint32_t>(records.size());
+  header.string_count = strings.offsets().size() - 1U;
+  header.string_bytes = strings.blob().size();
+  header.argument_count = arguments.size();
+  header.file_count = files.size();
+  header.directory_count = directories.size();
+  header.event_count = events.size();
+  header.duration_count = durations.size();
+
+  std::ofstream ofs(path, std::ios::out | std::ios::binary | std::ios::trunc);
+  if (ofs.fail())
+  {
+    return std::unexpected(std::format("Failed to open {}", path.string()));
+  }
+
+  write_section(ofs, std::span<const Header>(&header, 1U));
+  write_section(ofs, std::span<const uint64_t>(strings.offsets()));
+  write_section(ofs, std::span<const char>(strings.blob()));
+  write_section(ofs, std::span<const Record_entry>(records));
+  write_section(ofs, std::span<const uint32_t>(arguments));
+  write_section(ofs, std::span<const uint32_t>(files));
+  write_section(ofs, std::span<const uint32_t>(directories));
+  write_section(ofs, std::span<const Include_event>(events));
+  write_section(ofs, std::span<const Duration_entry>(durations));
+
+  if (ofs.flush().fail())
+  {
+    return std::unexpected(std::format("Failed to write {}", path.string()));
+  }
+
+  return {};
+}
+
+const Include_graph* Include_graph_db::find_current(const Compile_command& compile_command,
+                                                    File_time_cache& file_times) const
+{
+  auto it = records_.find(make_key(compile_command));
+  if (it == records_.end())
+  {
+    return nullptr;
+  }
+
+  const auto& record = it->second;
+  for (const auto& file : record.graph.files)
+  {
+    // a file modified in the same tick as the scan may have been read before the change
+    auto time = file_times.modification_time(file);
+    if (!time || *time >= record.scan_time)
+    {
+      return nullptr;
+    }
+  }
+  for (const auto& directory : record.graph.directories)
+  {
+    // a file created in a searched directory may shadow one that was read, while a directory
+    // that does not exist cannot shadow anything
+    auto time = file_times.modification_time(directory);
+    if (time && *time >= record.scan_time)
+    {
+      return nullptr;
+    }
+  }
+
+  return &record.graph;
+}
+
+void Include_graph_db::update(Include_graph_record record)
+{
+  if (record.scan_duration.count() > 0)
+  {
+    scan_durations_.insert_or_assign(record.compile_command.source, record.scan_duration);
+  }
+  auto key = make_key(record.compile_command);
+  records_.insert_or_assign(std::move(key), std::move(record));
+}
+
+void Include_graph_db::erase(const Compile_command& compile_command)
+{
+  records_.erase(make_key(compile_command));
+}
+
+void Include_graph_db::invalidate(const std::vector<std::filesystem::path>& changed_files)
+{
+  const std::set<std::filesystem::path> changed(changed_files.begin(), changed_files.end());
+  std::erase_if(records_,
+                [&](const auto& entry)
+                {
+                  const auto& graph = entry.second.graph;
+                  return std::ranges::any_of(graph.files,
+                                             [&](const std::filesystem::path& file)
+                                             {
+                                               return changed.contains(file);
+                                             }) ||
+                         std::ranges::any_of(changed,
+                                             [&](const std::filesystem::path& file)
+                                             {
+                                               return std::ranges::find(graph.directories,
+                                                                        file.parent_path()) !=
+                                                      graph.directories.end();
+                                             });
+                });
+}
+
+std::optional<std::chrono::milliseconds> Include_graph_db::scan_duration(
+  const std::filesystem::path& source) const
+{
+  auto it = scan_durations_.find(source);
+  if (it == scan_durations_.end())
+  {
+    return std::nullopt;
+  }
+  return it->second;
+}
+
+bool Include_graph_db::empty() const
+{
+  return records_.empty();
+}
+
+Include_index Include_graph_db::include_index() const
+{
+  std::map<std::filesystem::path, std::set<std::filesystem::path>> source_files;
+  for (const auto& [key, record] : records_)
+  {
+    auto& files = source_files[record.compile_command.source];
+    files.insert(record.graph.files.begin(), record.graph.files.end());
+  }
+
+  Include_index index;
+  for (auto& [source, files] : source_files)
+  {
+    index.update(source, std::move(files));
+  }
+  return index;
+}
+} // namespace scanner
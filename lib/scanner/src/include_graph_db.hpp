@@ -0,0 +1,83 @@
+// Copyright (c) 2025 Environmental Systems Research Institute, Inc.
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+
+#include <scanner/include_index.hpp>
+#include <src/include_graph.hpp>
+#include <src/scan_impl.hpp>
+
+#include <chrono>
+#include <cstdint>
+#include <expected>
+#include <filesystem>
+#include <map>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace scanner
+{
+// Caches the modification times of files for the duration of a run, since most headers are
+// read by many translation units.
+class File_time_cache
+{
+public:
+  // The modification time of the file or nothing if it does not exist
+  std::optional<int64_t> modification_time(const std::filesystem::path& path);
+
+private:
+  std::unordered_map<std::filesystem::path, std::optional<int64_t>> times_;
+};
+
+// The current time in the units recorded by File_time_cache
+int64_t current_file_time();
+
+struct Include_graph_record
+{
+  Compile_command compile_command;
+  int64_t scan_time{0};
+  Include_graph graph;
+  // how long preprocessing took, zero when unknown
+  std::chrono::milliseconds scan_duration{0};
+};
+
+// The include graphs of all translation units scanned so far, keyed by compile command. The
+// graphs do not depend on the target model so they can be reused by later runs as long as
+// none of the files they read have been modified and no file has been added to the directories
+// they searched since they were recorded.
+class Include_graph_db
+{
+public:
+  static std::expected<Include_graph_db, std::string> load(const std::filesystem::path& path);
+  std::expected<void, std::string> save(const std::filesystem::path& path) const;
+
+  // The recorded graph for the compile command if none of its files or searched directories
+  // changed after the scan
+  const Include_graph* find_current(const Compile_command& compile_command,
+                                    File_time_cache& file_times) const;
+
+  void update(Include_graph_record record);
+
+  // Forget the graph recorded for the compile command
+  void erase(const Compile_command& compile_command);
+
+  // Remove the graphs that read any of the files or searched the directories of any of them.
+  // Their scan durations are kept since the next scan is likely to take about as long.
+  void invalidate(const std::vector<std::filesystem::path>& changed_files);
+
+  // How long the last recorded scan of the source took
+  std::optional<std::chrono::milliseconds> scan_duration(
+    const std::filesystem::path& source) const;
+
+  bool empty() const;
+
+  // The files read by every recorded translation unit
+  Include_index include_index() const;
+
+private:
+  std::map<std::string, Include_graph_record> records_;
+  std::map<std::filesystem::path, std::chrono::milliseconds> scan_durations_;
+};
+} // namespace scanner
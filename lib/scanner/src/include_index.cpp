@@ -0,0 +1,66 @@
+// Copyright (c) 2025 Environmental Systems Research Institute, Inc.
+// SPDX-License-Identifier: Apache-2.0
+
+#include <scanner/include_index.hpp>
+
+#include <filesystem>
+#include <set>
+#include <utility>
+#include <vector>
+
+namespace scanner
+{
+void Include_index::update(const std::filesystem::path& source,
+                           std::set<std::filesystem::path> files)
+{
+  auto& recorded = source_to_files_[source];
+  for (const auto& file : recorded)
+  {
+    const auto it = file_to_sources_.find(file);
+    std::erase(it->second, source);
+    if (it->second.empty())
+    {
+      file_to_sources_.erase(it);
+    }
+  }
+
+  recorded = std::move(files);
+  for (const auto& file : recorded)
+  {
+    file_to_sources_[file].push_back(source);
+  }
+}
+
+bool Include_index::empty() const
+{
+  return source_to_files_.empty();
+}
+
+std::set<std::filesystem::path> Include_index::files() const
+{
+  std::set<std::filesystem::path> all_files;
+  for (const auto& [file, sources] : file_to_sources_)
+  {
+    all_files.insert(file);
+  }
+  return all_files;
+}
+
+std::set<std::filesystem::path> Include_index::affected_sources(
+  const std::vector<std::filesystem::path>& changed_files) const
+{
+  std::set<std::filesystem::path> sources;
+  for (const auto& file : changed_files)
+  {
+    if (source_to_files_.contains(file))
+    {
+      sources.insert(file);
+    }
+    if (const auto it = file_to_sources_.find(file); it != file_to_sources_.end())
+    {
+      sources.insert(it->second.begin(), it->second.end());
+    }
+  }
+  return sources;
+}
+} // namespace scanner
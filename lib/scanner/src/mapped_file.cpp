@@ -0,0 +1,153 @@
+// Copyright (c) 2025 Environmental Systems Research Institute, Inc.
+// SPDX-License-Identifier: Apache-2.0
+
+#include <src/mapped_file.hpp>
+
+#include <cstddef>
+#include <expected>
+#include <filesystem>
+#include <format>
+#include <span>
+#include <string>
+#include <utility>
+
+#ifdef _WIN32
+#include <Windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace scanner
+{
+std::expected<Mapped_file, std::string> Mapped_file::open(const std::filesystem::path& path)
+{
+  Mapped_file file;
+
+#ifdef _WIN32
+  HANDLE handle = CreateFileW(path.c_str(),
+                              GENERIC_READ,
+                              FILE_SHARE_READ,
+                              nullptr,
+                              OPEN_EXISTING,
+                              FILE_ATTRIBUTE_NORMAL,
+                              nullptr);
+  if (handle == INVALID_HANDLE_VALUE)
+  {
+    return std::unexpected(std::format("Failed to open {}", path.string()));
+  }
+
+  LARGE_INTEGER size{};
+  if (!GetFileSizeEx(handle, &size))
+  {
+    CloseHandle(handle);
+    return std::unexpected(std::format("Failed to stat {}", path.string()));
+  }
+  file.size_ = static_cast<size_t>(size.QuadPart);
+  if (file.size_ == 0)
+  {
+    CloseHandle(handle);
+    return file;
+  }
+
+  file.mapping_ = CreateFileMappingW(handle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+  CloseHandle(handle);
+  if (!file.mapping_)
+  {
+    return std::unexpected(std::format("Failed to map {}", path.string()));
+  }
+
+  file.data_ = static_cast<const std::byte*>(MapViewOfFile(file.mapping_, FILE_MAP_READ, 0, 0, 0));
+  if (!file.data_)
+  {
+    return std::unexpected(std::format("Failed to map {}", path.string()));
+  }
+#else
+  const int fd = ::open(path.c_str(), O_RDONLY); // NOLINT(cppcoreguidelines-pro-type-vararg)
+  if (fd < 0)
+  {
+    return std::unexpected(std::format("Failed to open {}", path.string()));
+  }
+
+  struct stat st{};
+  if (fstat(fd, &st) != 0)
+  {
+    ::close(fd);
+    return std::unexpected(std::format("Failed to stat {}", path.string()));
+  }
+  file.size_ = static_cast<size_t>(st.st_size);
+  if (file.size_ == 0)
+  {
+    ::close(fd);
+    return file;
+  }
+
+  void* data = mmap(nullptr, file.size_, PROT_READ, MAP_PRIVATE, fd, 0);
+  ::close(fd);
+  if (data == MAP_FAILED)
+  {
+    return std::unexpected(std::format("Failed to map {}", path.string()));
+  }
+  file.data_ = static_cast<const std::byte*>(data);
+#endif
+
+  return file;
+}
+
+Mapped_file::~Mapped_file()
+{
+  close_();
+}
+
+Mapped_file::Mapped_file(Mapped_file&& other) noexcept
+: data_(std::exchange(other.data_, nullptr)),
+  size_(std::exchange(other.size_, 0U))
+#ifdef _WIN32
+  ,
+  mapping_(std::exchange(other.mapping_, nullptr))
+#endif
+{
+}
+
+Mapped_file& Mapped_file::operator=(Mapped_file&& other) noexcept
+{
+  if (this != &other)
+  {
+    close_();
+    data_ = std::exchange(other.data_, nullptr);
+    size_ = std::exchange(other.size_, 0U);
+#ifdef _WIN32
+    mapping_ = std::exchange(other.mapping_, nullptr);
+#endif
+  }
+  return *this;
+}
+
+std::span<const std::byte> Mapped_file::bytes() const
+{
+  return {data_, size_};
+}
+
+void Mapped_file::close_()
+{
+#ifdef _WIN32
+  if (data_)
+  {
+    UnmapViewOfFile(data_);
+  }
+  if (mapping_)
+  {
+    CloseHandle(mapping_);
+  }
+#else
+  if (data_)
+  {
+    munmap(const_cast<std::byte*>(data_), size_); // NOLINT(cppcoreguidelines-pro-type-const-cast)
+  }
+#endif
+  data_ = nullptr;
+  size_ = 0U;
+}
+} // namespace scanner
@@ -0,0 +1,38 @@
+// Copyright (c) 2025 Environmental Systems Research Institute, Inc.
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+
+#include <cstddef>
+#include <expected>
+#include <filesystem>
+#include <span>
+#include <string>
+
+namespace scanner
+{
+// A read-only memory mapping of a whole file
+class Mapped_file
+{
+public:
+  static std::expected<Mapped_file, std::string> open(const std::filesystem::path& path);
+
+  Mapped_file() = default;
+  ~Mapped_file();
+  Mapped_file(const Mapped_file&) = delete;
+  Mapped_file(Mapped_file&& other) noexcept;
+  Mapped_file& operator=(const Mapped_file&) = delete;
+  Mapped_file& operator=(Mapped_file&& other) noexcept;
+
+  [[nodiscard]] std::span<const std::byte> bytes() const;
+
+private:
+  void close_();
+
+  const std::byte* data_{nullptr};
+  size_t size_{0U};
+#ifdef _WIN32
+  void* mapping_{nullptr};
+#endif
+};
+} // namespace scanner
@@ -0,0 +1,94 @@
+// Copyright (c) 2025 Environmental Systems Research Institute, Inc.
+// SPDX-License-Identifier: Apache-2.0
+
+#include <src/memory_budget.hpp>
+
+#include <util/system_resources.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <optional>
+#include <stop_token>
+#include <utility>
+
+namespace scanner
+{
+Memory_budget::Reservation::Reservation(Memory_budget& budget)
+: budget_(&budget)
+{
+}
+
+Memory_budget::Reservation::Reservation(Reservation&& other) noexcept
+: budget_(std::exchange(other.budget_, nullptr))
+{
+}
+
+Memory_budget::Reservation::~Reservation()
+{
+  if (budget_)
+  {
+    budget_->release_();
+  }
+}
+
+Memory_budget::Memory_budget(uint64_t limit, size_t thread_count, Probe probe)
+: limit_(limit),
+  thread_share_(limit / std::max(thread_count, size_t{1})),
+  probe_(probe ? std::move(probe) : Probe(util::resident_memory))
+{
+}
+
+uint64_t Memory_budget::limit() const
+{
+  return limit_;
+}
+
+std::optional<Memory_budget::Reservation> Memory_budget::reserve(const std::stop_token& stop_token)
+{
+  // memory is given back when a translation unit finishes, and by the allocator some time later
+  constexpr auto recheck_interval = std::chrono::milliseconds(50);
+
+  std::unique_lock lock(mutex_);
+  for (;;)
+  {
+    if (stop_token.stop_requested())
+    {
+      return std::nullopt;
+    }
+
+    const auto usage = probe_();
+    if (!usage || in_flight_count_ == 0)
+    {
+      if (in_flight_count_ == 0)
+      {
+        idle_usage_ = usage.value_or(0);
+      }
+      break;
+    }
+
+    const auto measured = *usage > idle_usage_ ? (*usage - idle_usage_) / in_flight_count_ : 0U;
+    largest_per_translation_unit_ = std::max(largest_per_translation_unit_, measured);
+    const auto per_translation_unit = std::max(largest_per_translation_unit_, thread_share_);
+    if (*usage + per_translation_unit <= limit_)
+    {
+      break;
+    }
+    cv_.wait_for(lock, recheck_interval);
+  }
+
+  ++in_flight_count_;
+  return Reservation(*this);
+}
+
+void Memory_budget::release_()
+{
+  {
+    std::scoped_lock lock(mutex_);
+    --in_flight_count_;
+  }
+  cv_.notify_one();
+}
+} // namespace scanner
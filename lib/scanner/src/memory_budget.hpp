@@ -0,0 +1,66 @@
+// Copyright (c) 2025 Environmental Systems Research Institute, Inc.
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <optional>
+#include <stop_token>
+
+namespace scanner
+{
+// Holds back translation units while the memory of the process is close to a limit. The memory
+// a translation unit needs is estimated from the memory used by the ones in flight beyond what
+// the process used when none were, but not below the largest estimate so far or the share of
+// the limit of one thread, since the ones that just started have not grown yet. One translation
+// unit is always let through, so a limit below the needs of a single one slows the scan down
+// but does not stop it.
+class Memory_budget
+{
+public:
+  // The memory currently used, or nothing when it cannot be measured
+  using Probe = std::function<std::optional<uint64_t>()>;
+
+  // Lets the translation unit run until it is destroyed
+  class Reservation
+  {
+  public:
+    ~Reservation();
+    Reservation(const Reservation&) = delete;
+    Reservation(Reservation&& other) noexcept;
+    Reservation& operator=(const Reservation&) = delete;
+    Reservation& operator=(Reservation&&) = delete;
+
+  private:
+    friend class Memory_budget;
+    explicit Reservation(Memory_budget& budget);
+
+    Memory_budget* budget_;
+  };
+
+  // Measures the resident memory of the process unless another probe is given
+  Memory_budget(uint64_t limit, size_t thread_count, Probe probe = {});
+
+  uint64_t limit() const;
+
+  // Waits until one more translation unit is expected to fit, or nothing if a stop is requested
+  // first
+  std::optional<Reservation> reserve(const std::stop_token& stop_token = {});
+
+private:
+  void release_();
+
+  uint64_t limit_;
+  uint64_t thread_share_;
+  Probe probe_;
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  size_t in_flight_count_{0};
+  uint64_t idle_usage_{0};
+  uint64_t largest_per_translation_unit_{0};
+};
+} // namespace scanner
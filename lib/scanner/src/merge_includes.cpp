@@ -5,39 +5,90 @@
 
 #include <scanner/scan.hpp>
 #include <src/scan_impl.hpp>
+#include <util/parallel.hpp>
+#include <util/parallel_transformer.hpp>
 
 #include <expected>
+#include <optional>
 #include <string>
 #include <utility>
 #include <vector>
 
 namespace scanner
 {
-std::expected<Intransitive_includes, std::string> merge_includes(
-  std::vector<std::expected<Include_data, std::string>> include_data_array)
+namespace
+{
+struct Merged
 {
   Include_set interface_includes;
   Include_set includes;
-  for (auto& eincdata : include_data_array)
+  // the first error in the order of the translation units
+  std::optional<std::string> error;
+};
+
+Merged merge(Merged lhs, Merged rhs)
+{
+  if (lhs.error)
   {
-    if (!eincdata.has_value())
-    {
-      // TODO: collect all errors
-      return std::unexpected(eincdata.error());
-    }
+    return lhs;
+  }
+  if (rhs.error)
+  {
+    lhs.error = std::move(rhs.error);
+    return lhs;
+  }
+
+  // merge keeps the element of lhs when both have an equivalent one, as a serial merge would
+  lhs.includes.merge(rhs.includes);
+  lhs.interface_includes.merge(rhs.interface_includes);
+  return lhs;
+}
+} // namespace
 
-    includes.merge(eincdata->includes);
-    for (auto& includes : eincdata->interface_header_includes)
+std::expected<Intransitive_includes, std::string> merge_includes(
+  std::vector<std::expected<Include_data, std::string>> include_data_array)
+{
+  util::Parallel_transformer pool(0);
+  return merge_includes(pool, std::move(include_data_array));
+}
+
+std::expected<Intransitive_includes, std::string> merge_includes(
+  util::Parallel_transformer& pool,
+  std::vector<std::expected<Include_data, std::string>> include_data_array)
+{
+  auto merged = util::parallel_reduce(
+    pool,
+    include_data_array.size(),
+    Merged{},
+    [&](size_t i)
     {
-      interface_includes.merge(includes.second);
-    }
+      auto& eincdata = include_data_array[i];
+      Merged merged;
+      if (!eincdata.has_value())
+      {
+        // TODO: collect all errors
+        merged.error = std::move(eincdata.error());
+        return merged;
+      }
+
+      merged.includes = std::move(eincdata->includes);
+      for (auto& includes : eincdata->interface_header_includes)
+      {
+        merged.interface_includes.merge(includes.second);
+      }
+      return merged;
+    },
+    merge);
+  if (merged.error)
+  {
+    return std::unexpected(std::move(*merged.error));
   }
 
   Intransitive_includes output;
   output.interface_includes.insert(output.interface_includes.begin(),
-                                   interface_includes.begin(),
-                                   interface_includes.end());
-  output.includes.insert(output.includes.begin(), includes.begin(), includes.end());
+                                   merged.interface_includes.begin(),
+                                   merged.interface_includes.end());
+  output.includes.insert(output.includes.begin(), merged.includes.begin(), merged.includes.end());
 
   return output;
 }
@@ -10,10 +10,21 @@
 #include <string>
 #include <vector>
 
+namespace util
+{
+class Parallel_transformer;
+} // namespace util
+
 namespace scanner
 {
 struct Include_data;
 
 std::expected<Intransitive_includes, std::string> merge_includes(
   std::vector<std::expected<Include_data, std::string>> include_data_array);
+
+// Merges the translation units in chunks on the threads of the pool. The result and the error
+// reported are the same as those of the serial merge.
+std::expected<Intransitive_includes, std::string> merge_includes(
+  util::Parallel_transformer& pool,
+  std::vector<std::expected<Include_data, std::string>> include_data_array);
 } // namespace scanner
@@ -0,0 +1,333 @@
+// Copyright (c) 2025 Environmental Systems Research Institute, Inc.
+// SPDX-License-Identifier: Apache-2.0
+
+#include <src/process_pool.hpp>
+
+#include <message/message.hpp>
+#include <src/scan_impl.hpp>
+#include <src/scan_protocol.hpp>
+#include <util/socket.hpp>
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <csignal>
+#include <cstddef>
+#include <cstring>
+#include <expected>
+#include <format>
+#include <optional>
+#include <span>
+#include <string>
+#include <utility>
+#include <vector>
+
+#ifndef _WIN32
+#include <poll.h>
+#include <spawn.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+extern char** environ; // NOLINT(readability-redundant-declaration)
+#endif
+
+namespace scanner
+{
+namespace
+{
+#ifndef _WIN32
+// Long enough to amortize starting a process, short enough to bound the memory held by the
+// allocator and the file system cache of a process
+constexpr size_t translation_units_per_process = 64;
+
+constexpr size_t idle = static_cast<size_t>(-1);
+
+std::string describe_exit_status(int status)
+{
+  if (WIFSIGNALED(status))
+  {
+    const int signal = WTERMSIG(status);
+    return std::format("the preprocessor crashed with signal {} ({})", signal, ::strsignal(signal));
+  }
+  if (WIFEXITED(status))
+  {
+    return std::format("the preprocessor exited with status {}", WEXITSTATUS(status));
+  }
+  return "the preprocessor stopped unexpectedly";
+}
+#endif
+} // namespace
+
+Process_pool::Process_pool(size_t process_count, std::vector<std::string> command)
+: command_(std::move(command)),
+  processes_(std::max<size_t>(process_count, 1U))
+{
+}
+
+Process_pool::~Process_pool()
+{
+  for (auto& process : processes_)
+  {
+    stop(process);
+  }
+}
+
+size_t Process_pool::process_count() const
+{
+  return processes_.size();
+}
+
+#ifndef _WIN32
+std::expected<void, std::string> Process_pool::start(Process& process)
+{
+  auto sockets = util::socket_pair();
+  if (!sockets)
+  {
+    return std::unexpected(sockets.error());
+  }
+
+  // the other sockets are closed on exec, so a process only holds its own connection and
+  // notices when the parent closes it
+  posix_spawn_file_actions_t file_actions;
+  posix_spawn_file_actions_init(&file_actions);
+  posix_spawn_file_actions_adddup2(&file_actions, sockets->second.get(), pool_connection_fd);
+
+  std::vector<char*> argv;
+  argv.reserve(command_.size() + 1);
+  for (auto& argument : command_)
+  {
+    argv.push_back(argument.data());
+  }
+  argv.push_back(nullptr);
+
+  pid_t pid = -1;
+  const int error =
+    ::posix_spawn(&pid, argv.front(), &file_actions, nullptr, argv.data(), environ);
+  posix_spawn_file_actions_destroy(&file_actions);
+  if (error != 0)
+  {
+    return std::unexpected(
+      std::format("error: failed to start a scan process: {}", std::strerror(error)));
+  }
+
+  process.pid = pid;
+  process.connection = std::move(sockets->first);
+  process.task_count = 0;
+  return {};
+}
+
+void Process_pool::stop(Process& process)
+{
+  if (process.pid < 0)
+  {
+    return;
+  }
+  util::write_frame(process.connection.get(), encode_batch({}));
+  reap(process);
+}
+
+std::string Process_pool::reap(Process& process)
+{
+  process.connection = util::File_descriptor();
+  int status = 0;
+  while (::waitpid(process.pid, &status, 0) < 0 && errno == EINTR)
+  {
+  }
+  process.pid = -1;
+  return describe_exit_status(status);
+}
+
+std::vector<std::optional<Process_result>> Process_pool::record(
+  std::span<const Compile_command* const> compile_commands,
+  std::chrono::milliseconds time_limit,
+  bool stop_on_failure)
+{
+  std::vector<std::optional<Process_result>> results(compile_commands.size());
+  std::vector<size_t> current(processes_.size(), idle);
+  size_t next = 0;
+  size_t running = 0;
+  bool stopped = false;
+  const auto finish =
+    [&](size_t index, Graph_result result, std::chrono::steady_clock::time_point start)
+  {
+    stopped = stopped || (stop_on_failure && !result);
+    results[index] = Process_result{std::move(result),
+                                    std::chrono::duration_cast<std::chrono::milliseconds>(
+                                      std::chrono::steady_clock::now() - start)};
+  };
+
+  while (running > 0 || (!stopped && next < compile_commands.size()))
+  {
+    // hand the next translation unit to every idle process, starting processes as needed
+    for (size_t i = 0; i < processes_.size() && !stopped && next < compile_commands.size(); ++i)
+    {
+      auto& process = processes_[i];
+      if (current[i] != idle)
+      {
+        continue;
+      }
+      if (process.pid >= 0 && process.task_count == translation_units_per_process)
+      {
+        stop(process);
+      }
+      if (process.pid < 0)
+      {
+        if (auto started = start(process); !started)
+        {
+          finish(next++, std::unexpected(started.error()), std::chrono::steady_clock::now());
+          continue;
+        }
+      }
+
+      // a process that died meanwhile is noticed when polling for its result
+      util::write_frame(process.connection.get(),
+                        encode_batch(compile_commands.subspan(next, 1)));
+      ++process.task_count;
+      process.task_start = std::chrono::steady_clock::now();
+      current[i] = next++;
+      ++running;
+    }
+
+    std::vector<pollfd> polls;
+    std::vector<size_t> polled_processes;
+    auto poll_timeout = std::chrono::milliseconds(-1);
+    const auto now = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < processes_.size(); ++i)
+    {
+      if (current[i] == idle)
+      {
+        continue;
+      }
+      polls.push_back(pollfd{processes_[i].connection.get(), POLLIN, 0});
+      polled_processes.push_back(i);
+      if (time_limit.count() > 0)
+      {
+        const auto remaining = std::max(
+          std::chrono::duration_cast<std::chrono::milliseconds>(
+            processes_[i].task_start + time_limit - now),
+          std::chrono::milliseconds(0));
+        poll_timeout = poll_timeout.count() < 0 ? remaining : std::min(poll_timeout, remaining);
+      }
+    }
+    if (polls.empty())
+    {
+      continue;
+    }
+    if (::poll(polls.data(), polls.size(), static_cast<int>(poll_timeout.count())) < 0)
+    {
+      if (errno == EINTR)
+      {
+        continue;
+      }
+
+      // polling again would fail the same way, give up on everything that is not finished
+      const auto error = std::format("error: failed to wait for the scan processes: {}",
+                                     std::strerror(errno));
+      for (const auto i : polled_processes)
+      {
+        auto& process = processes_[i];
+        ::kill(process.pid, SIGKILL);
+        reap(process);
+        finish(std::exchange(current[i], idle), std::unexpected(error), process.task_start);
+      }
+      for (; next < compile_commands.size(); ++next)
+      {
+        finish(next, std::unexpected(error), std::chrono::steady_clock::now());
+      }
+      return results;
+    }
+
+    for (size_t p = 0; p < polls.size(); ++p)
+    {
+      const auto i = polled_processes[p];
+      auto& process = processes_[i];
+      const auto& source = compile_commands[current[i]]->source;
+      if (polls[p].revents == 0)
+      {
+        // the preprocessor may be stuck anywhere, only killing the process reliably stops it
+        if (time_limit.count() > 0 &&
+            std::chrono::steady_clock::now() - process.task_start >= time_limit)
+        {
+          ::kill(process.pid, SIGKILL);
+          reap(process);
+          message::warning("Restarting a scan process, preprocessing {} took longer than {} s",
+                           source.string(),
+                           std::chrono::duration_cast<std::chrono::seconds>(time_limit).count());
+          finish(std::exchange(current[i], idle),
+                 std::unexpected(std::format("Preprocessing {} timed out.\n", source.string())),
+                 process.task_start);
+          --running;
+        }
+        continue;
+      }
+
+      const auto index = std::exchange(current[i], idle);
+      --running;
+
+      auto result = util::read_frame(process.connection.get()).and_then(decode_results);
+      if (result && result->size() == 1)
+      {
+        finish(index, std::move(result->front()), process.task_start);
+        continue;
+      }
+
+      const auto reason = reap(process);
+      message::warning("Restarting a scan process, {} while preprocessing {}",
+                       reason,
+                       source.string());
+      finish(index,
+             std::unexpected(std::format("{}: {}", source.string(), reason)),
+             process.task_start);
+    }
+  }
+  return results;
+}
+
+void serve_process_pool(int fd, const Recorder& recorder)
+{
+  while (true)
+  {
+    auto batch = util::read_frame(fd).and_then(decode_batch);
+    if (!batch || batch->empty())
+    {
+      return;
+    }
+
+    std::vector<Graph_result> results;
+    results.reserve(batch->size());
+    for (const auto& compile_command : *batch)
+    {
+      results.push_back(recorder(compile_command));
+    }
+    if (!util::write_frame(fd, encode_results(results)))
+    {
+      return;
+    }
+  }
+}
+#else
+std::expected<void, std::string> Process_pool::start(Process& /*process*/)
+{
+  return std::unexpected(std::string("error: scan processes are not supported on Windows"));
+}
+
+void Process_pool::stop(Process& /*process*/) {}
+
+std::string Process_pool::reap(Process& /*process*/)
+{
+  return {};
+}
+
+std::vector<std::optional<Process_result>> Process_pool::record(
+  std::span<const Compile_command* const> compile_commands,
+  std::chrono::milliseconds /*time_limit*/,
+  bool /*stop_on_failure*/)
+{
+  const Process_result unsupported{
+    std::unexpected(std::string("error: scan processes are not supported on Windows"))};
+  return std::vector<std::optional<Process_result>>(compile_commands.size(), unsupported);
+}
+
+void serve_process_pool(int /*fd*/, const Recorder& /*recorder*/) {}
+#endif
+} // namespace scanner
@@ -0,0 +1,83 @@
+// Copyright (c) 2025 Environmental Systems Research Institute, Inc.
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+
+#include <src/scan_impl.hpp>
+#include <src/scan_protocol.hpp>
+#include <util/socket.hpp>
+
+#include <chrono>
+#include <cstddef>
+#include <expected>
+#include <functional>
+#include <optional>
+#include <span>
+#include <string>
+#include <vector>
+
+namespace scanner
+{
+struct Process_result
+{
+  Graph_result graph;
+  // measured by the parent, from handing out the translation unit to receiving its graph
+  std::chrono::milliseconds duration{0};
+};
+
+// Records include graphs in child processes, so a translation unit that crashes the preprocessor
+// only takes down its own process. Every process handles one translation unit at a time and is
+// replaced after a number of them to give its memory back to the system.
+//
+// The processes are started from a fresh image rather than forked, since a fork of the
+// multithreaded parent may inherit locks held by its other threads. A process runs the command
+// with a connection to the pool as its standard input and is expected to call
+// serve_process_pool on it.
+class Process_pool
+{
+public:
+  Process_pool(size_t process_count, std::vector<std::string> command);
+  ~Process_pool();
+  Process_pool(const Process_pool&) = delete;
+  Process_pool(Process_pool&&) = delete;
+  Process_pool& operator=(const Process_pool&) = delete;
+  Process_pool& operator=(Process_pool&&) = delete;
+
+  size_t process_count() const;
+
+  // The include graphs of the translation units, in the same order. A translation unit that
+  // crashed its process or ran longer than the time limit gets an error naming the source and
+  // the reason, and its process is replaced. A time limit of zero means no limit. With
+  // stop_on_failure, no translation units are handed out after the first error and the ones
+  // that were not started are left empty.
+  std::vector<std::optional<Process_result>> record(
+    std::span<const Compile_command* const> compile_commands,
+    std::chrono::milliseconds time_limit,
+    bool stop_on_failure);
+
+private:
+  struct Process
+  {
+    int pid{-1};
+    util::File_descriptor connection;
+    size_t task_count{0};
+    std::chrono::steady_clock::time_point task_start;
+  };
+
+  std::expected<void, std::string> start(Process& process);
+  void stop(Process& process);
+  std::string reap(Process& process);
+
+  std::vector<std::string> command_;
+  std::vector<Process> processes_;
+};
+
+using Recorder = std::function<Graph_result(const Compile_command&)>;
+
+// The processes of the pool are connected to it through their standard input
+constexpr int pool_connection_fd = 0;
+
+// The loop of a process of the pool: record the translation units sent over the connection
+// until the pool sends an empty batch or goes away
+void serve_process_pool(int fd, const Recorder& recorder);
+} // namespace scanner
@@ -5,9 +5,17 @@
 
 #include <message/message.hpp>
 #include <relative_resource_dir.hpp>
+#include <scanner/distributed_scan.hpp>
+#include <scanner/include_index.hpp>
 #include <src/executable_path.hpp>
+#include <src/include_graph.hpp>
+#include <src/include_graph_db.hpp>
+#include <src/memory_budget.hpp>
 #include <src/merge_includes.hpp>
+#include <src/process_pool.hpp>
+#include <src/scan_coordinator_impl.hpp>
 #include <src/scan_impl.hpp>
+#include <src/scan_protocol.hpp>
 #include <target_model/target_data.hpp>
 #include <util/parallel_transformer.hpp>
 
@@ -18,15 +26,24 @@
 #include <llvm/ADT/IntrusiveRefCntPtr.h>
 #include <llvm/Support/VirtualFileSystem.h>
 
+#include <algorithm>
 #include <cassert>
+#include <chrono>
+#include <cstdint>
 #include <cstdlib>
 #include <expected>
 #include <filesystem>
 #include <format>
 #include <functional>
+#include <iterator>
 #include <map>
 #include <memory>
+#include <numeric>
+#include <optional>
+#include <span>
+#include <stop_token>
 #include <string>
+#include <system_error>
 #include <unordered_set>
 #include <utility>
 #include <vector>
@@ -41,6 +58,33 @@ struct Scanner::Impl
   }
 
   util::Parallel_transformer transformer;
+  Include_graph_db include_graphs;
+  bool rescan{false};
+  bool fail_fast{false};
+  std::chrono::milliseconds tu_timeout{0};
+
+  struct File_stats
+  {
+    size_t processed_file_count{0};
+    std::map<std::string, size_t> skipped_file_types;
+  };
+
+  std::expected<void, std::string> load_compilation_database(
+    const std::filesystem::path& binary_dir);
+  std::expected<std::vector<Compile_command>, std::string> compile_commands(
+    const target_model::Target_data& target_data,
+    File_stats& file_stats) const;
+
+  // kept across scans, until invalidated
+  std::filesystem::path compilation_database_dir;
+  std::unique_ptr<clang::tooling::JSONCompilationDatabase> compilation_database;
+  std::unique_ptr<clang::tooling::dependencies::DependencyScanningFilesystemSharedCache> dep_cache{
+    std::make_unique<clang::tooling::dependencies::DependencyScanningFilesystemSharedCache>()};
+
+  // preprocesses in child processes instead of the transformer threads when set
+  std::unique_ptr<Process_pool> process_pool;
+  // holds back the transformer threads when set
+  std::unique_ptr<Memory_budget> memory_budget;
 };
 
 Scanner::Scanner(size_t thread_count)
@@ -50,22 +94,199 @@ Scanner::Scanner(size_t thread_count)
 
 Scanner::~Scanner() = default;
 
-std::expected<Intransitive_includes, std::string> Scanner::scan(
-  const std::filesystem::path& binary_dir,
-  const target_model::Target_data& target_data)
+size_t Scanner::thread_count() const
+{
+  return impl_->transformer.thread_count();
+}
+
+std::expected<void, std::string> Scanner::load_compilation_database(
+  const std::filesystem::path& binary_dir)
+{
+  return impl_->load_compilation_database(binary_dir);
+}
+
+std::expected<void, std::string> Scanner::load_include_graphs(const std::filesystem::path& path)
+{
+  auto include_graphs = Include_graph_db::load(path);
+  if (!include_graphs)
+  {
+    return std::unexpected(include_graphs.error());
+  }
+  impl_->include_graphs = std::move(*include_graphs);
+  return {};
+}
+
+std::expected<void, std::string> Scanner::save_include_graphs(
+  const std::filesystem::path& path) const
+{
+  return impl_->include_graphs.save(path);
+}
+
+void Scanner::force_rescan(bool rescan)
+{
+  impl_->rescan = rescan;
+}
+
+void Scanner::set_fail_fast(bool fail_fast)
+{
+  impl_->fail_fast = fail_fast;
+}
+
+void Scanner::set_tu_timeout(std::chrono::milliseconds tu_timeout)
+{
+  impl_->tu_timeout = tu_timeout;
+}
+
+void Scanner::set_memory_limit(uint64_t memory_limit)
+{
+  impl_->memory_budget =
+    memory_limit > 0
+      ? std::make_unique<Memory_budget>(memory_limit, impl_->transformer.thread_count())
+      : nullptr;
+}
 
+void Scanner::use_process_isolation(bool isolate)
 {
+  if (!isolate)
+  {
+    impl_->process_pool.reset();
+    return;
+  }
+  if (impl_->process_pool)
+  {
+    return;
+  }
+
+  impl_->process_pool = std::make_unique<Process_pool>(
+    thread_count(),
+    std::vector<std::string>{executable_path().string(), std::string(scan_process_argument)});
+}
+
+int run_scan_process()
+{
+  // every process fills its own copy of the cache
+  clang::tooling::dependencies::DependencyScanningFilesystemSharedCache dep_cache;
+  serve_process_pool(pool_connection_fd,
+                     [&](const Compile_command& compile_command)
+                     {
+                       auto file_system = llvm::IntrusiveRefCntPtr<llvm::vfs::FileSystem>{
+                         llvm::vfs::createPhysicalFileSystem()};
+                       // the pool enforces the time limit by killing the process
+                       return record_include_graph(file_system, dep_cache, compile_command, {});
+                     });
+  return EXIT_SUCCESS;
+}
+
+Include_index Scanner::include_index() const
+{
+  return impl_->include_graphs.include_index();
+}
+
+void Scanner::invalidate(const std::vector<std::filesystem::path>& changed_files)
+{
+  if (changed_files.empty())
+  {
+    return;
+  }
+
+  // the shared cache has no way to evict single entries
+  impl_->dep_cache =
+    std::make_unique<clang::tooling::dependencies::DependencyScanningFilesystemSharedCache>();
+  impl_->include_graphs.invalidate(changed_files);
+
+  if (std::ranges::any_of(changed_files,
+                          [](const std::filesystem::path& file)
+                          {
+                            return file.filename() == "compile_commands.json";
+                          }))
+  {
+    impl_->compilation_database.reset();
+  }
+}
+
+namespace
+{
+// Longest processing time first: the translation units expected to take longest start first so
+// a slow one cannot start last and hold up the whole target. The expected time is the duration
+// of the last scan, else the size of the source scaled by the sources with a known duration.
+// Null commands need no preprocessing and go last.
+std::vector<size_t> longest_first(std::span<const Compile_command* const> compile_commands,
+                                  const Include_graph_db& include_graphs)
+{
+  std::vector<std::optional<std::chrono::milliseconds>> durations;
+  std::vector<uintmax_t> sizes;
+  durations.reserve(compile_commands.size());
+  sizes.reserve(compile_commands.size());
+  double known_milliseconds = 0.0;
+  double known_bytes = 0.0;
+  for (const auto* compile_command : compile_commands)
+  {
+    std::optional<std::chrono::milliseconds> duration;
+    uintmax_t size = 0;
+    if (compile_command)
+    {
+      duration = include_graphs.scan_duration(compile_command->source);
+      std::error_code error;
+      size = std::filesystem::file_size(compile_command->source, error);
+      size = error ? 0 : size;
+    }
+    if (duration && size > 0)
+    {
+      known_milliseconds += static_cast<double>(duration->count());
+      known_bytes += static_cast<double>(size);
+    }
+    durations.push_back(duration);
+    sizes.push_back(size);
+  }
+
+  const double milliseconds_per_byte =
+    known_bytes > 0.0 ? known_milliseconds / known_bytes : 1.0;
+  std::vector<double> costs;
+  costs.reserve(compile_commands.size());
+  for (size_t i = 0; i < compile_commands.size(); ++i)
+  {
+    if (!compile_commands[i])
+    {
+      costs.push_back(-1.0);
+      continue;
+    }
+    costs.push_back(durations[i] ? static_cast<double>(durations[i]->count())
+                                 : static_cast<double>(sizes[i]) * milliseconds_per_byte);
+  }
+
+  std::vector<size_t> order(compile_commands.size());
+  std::iota(order.begin(), order.end(), size_t{0});
+  std::ranges::stable_sort(order, std::greater<>(), [&](size_t i) { return costs[i]; });
+  return order;
+}
+} // namespace
+
+std::expected<void, std::string> Scanner::Impl::load_compilation_database(
+  const std::filesystem::path& binary_dir)
+{
+  if (compilation_database && compilation_database_dir == binary_dir)
+  {
+    return {};
+  }
+
   std::string compilation_database_error;
-  auto compilation_database = clang::tooling::JSONCompilationDatabase::loadFromFile(
+  compilation_database = clang::tooling::JSONCompilationDatabase::loadFromFile(
     binary_dir.string() + "/compile_commands.json",
     compilation_database_error,
     clang::tooling::JSONCommandLineSyntax::AutoDetect);
   if (!compilation_database)
   {
-    return std::unexpected(std::format("Failed to load compilation database: {}\n",
-                                       compilation_database_error));
+    return std::unexpected(
+      std::format("Failed to load compilation database: {}\n", compilation_database_error));
   }
+  compilation_database_dir = binary_dir;
+  return {};
+}
 
+std::expected<std::vector<Compile_command>, std::string> Scanner::Impl::compile_commands(
+  const target_model::Target_data& target_data,
+  File_stats& file_stats) const
+{
   std::vector<std::filesystem::path> source_paths;
   source_paths.reserve(target_data.sources.size() +
                        target_data.verify_interface_header_sets_sources.size());
@@ -99,10 +320,7 @@ std::expected<Intransitive_includes, std::string> Scanner::scan(
     clang::tooling::combineAdjusters(std::move(args_adjuster),
                                      clang::tooling::getClangStripDependencyFileAdjuster());
 
-  size_t processed_file_count = 0;
-  std::map<std::string, size_t> skipped_file_types;
-
-  std::vector<Compile_command> compile_commands;
+  std::vector<Compile_command> result;
   for (const auto& source_path : source_paths)
   {
     if (!source_path.is_absolute())
@@ -115,7 +333,7 @@ std::expected<Intransitive_includes, std::string> Scanner::scan(
       compilation_database->getCompileCommands(source_path.string());
     if (compile_commands_for_file.empty())
     {
-      ++skipped_file_types[source_path.extension().string()];
+      ++file_stats.skipped_file_types[source_path.extension().string()];
       continue;
     }
     for (clang::tooling::CompileCommand& compile_command : compile_commands_for_file)
@@ -123,38 +341,296 @@ std::expected<Intransitive_includes, std::string> Scanner::scan(
       auto command_line =
         args_adjuster(compile_command.CommandLine, compile_command.Filename);
       assert(!command_line.empty());
-      compile_commands.emplace_back(
+      result.emplace_back(
         Compile_command{compile_command.Directory, source_path, std::move(command_line)});
     }
-    ++processed_file_count;
+    ++file_stats.processed_file_count;
   }
 
-  clang::tooling::dependencies::DependencyScanningFilesystemSharedCache dep_cache;
+  return result;
+}
+
+std::expected<size_t, std::string> Scanner::scan_on_workers(
+  const std::filesystem::path& binary_dir,
+  const std::vector<const target_model::Target_data*>& targets,
+  Scan_coordinator& coordinator)
+{
+  if (auto loaded = impl_->load_compilation_database(binary_dir); !loaded)
+  {
+    return std::unexpected(loaded.error());
+  }
 
-  std::vector<std::expected<Include_data, std::string>> include_data_array(
-    compile_commands.size());
+  Impl::File_stats file_stats;
+  std::vector<Compile_command> compile_commands;
+  for (const auto* target_data : targets)
+  {
+    auto target_commands = impl_->compile_commands(*target_data, file_stats);
+    if (!target_commands)
+    {
+      return std::unexpected(target_commands.error());
+    }
+    std::ranges::move(*target_commands, std::back_inserter(compile_commands));
+  }
 
-  impl_->transformer.transform(
-    compile_commands.begin(),
-    compile_commands.end(),
-    include_data_array.begin(),
-    [&](const Compile_command& compile_command) -> std::expected<Include_data, std::string>
+  File_time_cache file_times;
+  std::vector<const Compile_command*> outdated_commands;
+  for (const auto& compile_command : compile_commands)
+  {
+    if (impl_->rescan || !impl_->include_graphs.find_current(compile_command, file_times))
+    {
+      outdated_commands.push_back(&compile_command);
+    }
+  }
+
+  // the workers take the translation units in this order
+  std::vector<const Compile_command*> ordered_commands;
+  ordered_commands.reserve(outdated_commands.size());
+  for (const auto index : longest_first(outdated_commands, impl_->include_graphs))
+  {
+    ordered_commands.push_back(outdated_commands[index]);
+  }
+
+  // with a forced rescan, the sources the workers leave out must not fall back to old graphs
+  if (impl_->rescan)
+  {
+    for (const auto* compile_command : ordered_commands)
+    {
+      impl_->include_graphs.erase(*compile_command);
+    }
+  }
+
+  auto records = coordinator.impl_->record(ordered_commands);
+  const auto recorded_count = records.size();
+  for (auto& record : records)
+  {
+    impl_->include_graphs.update(std::move(record));
+  }
+
+  // the graphs were just recorded, rescanning them again locally would only repeat the work
+  impl_->rescan = false;
+  return recorded_count;
+}
+
+std::expected<Intransitive_includes, std::string> Scanner::scan(
+  const std::filesystem::path& binary_dir,
+  const target_model::Target_data& target_data)
+
+{
+  if (auto loaded = impl_->load_compilation_database(binary_dir); !loaded)
+  {
+    return std::unexpected(loaded.error());
+  }
+
+  Impl::File_stats file_stats;
+  const auto compile_commands = impl_->compile_commands(target_data, file_stats);
+  if (!compile_commands)
+  {
+    return std::unexpected(compile_commands.error());
+  }
+
+  struct Scan_job
+  {
+    const Compile_command* compile_command;
+    const Include_graph* recorded_graph;
+    // recorded by the process pool, empty when the pool stopped before this translation unit
+    std::optional<Process_result>* isolated_graph{nullptr};
+  };
+
+  size_t reused_graph_count = 0;
+  File_time_cache file_times;
+  std::vector<Scan_job> jobs;
+  jobs.reserve(compile_commands->size());
+  for (const auto& compile_command : *compile_commands)
+  {
+    const Include_graph* recorded_graph = nullptr;
+    if (!impl_->rescan)
     {
+      recorded_graph = impl_->include_graphs.find_current(compile_command, file_times);
+    }
+    reused_graph_count += recorded_graph ? 1U : 0U;
+    jobs.emplace_back(Scan_job{&compile_command, recorded_graph});
+  }
+
+  std::vector<const Compile_command*> outdated_commands;
+  outdated_commands.reserve(jobs.size());
+  for (const auto& job : jobs)
+  {
+    outdated_commands.push_back(job.recorded_graph ? nullptr : job.compile_command);
+  }
+  const auto order = longest_first(outdated_commands, impl_->include_graphs);
+
+  // the processes record the graphs up front, the threads only classify them
+  const auto isolated_scan_time = current_file_time();
+  std::vector<std::optional<Process_result>> isolated_graphs;
+  if (impl_->process_pool)
+  {
+    std::vector<const Compile_command*> isolated_commands;
+    for (const auto index : order)
+    {
+      if (!jobs[index].recorded_graph)
+      {
+        isolated_commands.push_back(jobs[index].compile_command);
+      }
+    }
+    isolated_graphs =
+      impl_->process_pool->record(isolated_commands, impl_->tu_timeout, impl_->fail_fast);
+    auto isolated_graph = isolated_graphs.begin();
+    for (const auto index : order)
+    {
+      if (!jobs[index].recorded_graph)
+      {
+        jobs[index].isolated_graph = &*isolated_graph++;
+      }
+    }
+  }
+
+  struct Scan_result
+  {
+    Include_data include_data;
+    std::optional<Include_graph_record> new_record;
+  };
+
+  auto& dep_cache = *impl_->dep_cache;
+
+  // with fail fast, the first failure makes preprocessing the rest of the target pointless
+  std::stop_source stop_source;
+
+  // empty for the translation units that were skipped after a failure
+  using Job_result = std::optional<std::expected<Scan_result, std::string>>;
+  const auto scan_job = [&](size_t index, const std::stop_token& stop_token) -> Job_result
+  {
+    const auto& job = jobs[index];
+    if (job.recorded_graph)
+    {
+      const auto& graph = *job.recorded_graph;
+      return Scan_result{classify_includes(graph.events, graph.files, target_data),
+                         std::nullopt};
+    }
+
+    auto scan_time = isolated_scan_time;
+    std::chrono::milliseconds scan_duration{0};
+    Graph_result graph;
+    if (job.isolated_graph)
+    {
+      if (!job.isolated_graph->has_value())
+      {
+        return std::nullopt;
+      }
+      graph = std::move((*job.isolated_graph)->graph);
+      scan_duration = (*job.isolated_graph)->duration;
+    }
+    else
+    {
+      if (stop_token.stop_requested())
+      {
+        return std::nullopt;
+      }
+      // the wait for memory does not count against the time limit
+      std::optional<Memory_budget::Reservation> reservation;
+      if (impl_->memory_budget)
+      {
+        auto reserved = impl_->memory_budget->reserve(stop_token);
+        if (!reserved)
+        {
+          return std::nullopt;
+        }
+        reservation.emplace(std::move(*reserved));
+      }
+      Scan_budget budget{stop_token, std::nullopt};
+      if (impl_->tu_timeout.count() > 0)
+      {
+        budget.deadline = std::chrono::steady_clock::now() + impl_->tu_timeout;
+      }
+      scan_time = current_file_time();
+      const auto start = std::chrono::steady_clock::now();
       auto file_system = llvm::IntrusiveRefCntPtr<llvm::vfs::FileSystem>{
         llvm::vfs::createPhysicalFileSystem()};
-      return scan_impl(file_system, dep_cache, target_data, compile_command);
-    });
+      graph = record_include_graph(file_system, dep_cache, *job.compile_command, budget);
+      scan_duration = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now() - start);
+      if (!graph && stop_token.stop_requested())
+      {
+        return std::nullopt;
+      }
+    }
+    if (!graph)
+    {
+      if (impl_->fail_fast)
+      {
+        stop_source.request_stop();
+      }
+      return std::unexpected(graph.error());
+    }
+    auto include_data = classify_includes(graph->events, graph->files, target_data);
+    return Scan_result{
+      std::move(include_data),
+      Include_graph_record{*job.compile_command, scan_time, std::move(*graph), scan_duration}};
+  };
+
+  // the messages of the translation units are printed in the order of the sources
+  struct Job_output
+  {
+    Job_result result;
+    std::string messages;
+  };
+  std::vector<Job_output> ordered_results(jobs.size());
+
+  impl_->transformer.transform(
+    order.begin(),
+    order.end(),
+    ordered_results.begin(),
+    [&](size_t index, std::stop_token stop_token)
+    {
+      message::Capture capture;
+      auto result = scan_job(index, stop_token);
+      return Job_output{std::move(result), capture.take()};
+    },
+    stop_source.get_token(),
+    // the longest translation units come first, one thread must not claim several of them
+    1);
+
+  // merge in the order of the sources, so the reported include chains do not depend on timing
+  std::vector<Job_output> results(jobs.size());
+  for (size_t i = 0; i < order.size(); ++i)
+  {
+    results[order[i]] = std::move(ordered_results[i]);
+  }
+
+  std::vector<std::expected<Include_data, std::string>> include_data_array;
+  include_data_array.reserve(results.size());
+  for (auto& [result, messages] : results)
+  {
+    message::write(messages);
+    if (!result)
+    {
+      continue;
+    }
+    if (!*result)
+    {
+      include_data_array.emplace_back(std::unexpected(std::move(result->error())));
+      continue;
+    }
+    if ((*result)->new_record)
+    {
+      impl_->include_graphs.update(std::move(*(*result)->new_record));
+    }
+    include_data_array.emplace_back(std::move((*result)->include_data));
+  }
 
   if (message::verbose_enabled())
   {
-    message::print("Processed {} source files", processed_file_count);
-    for (const auto& skipped_file_type : skipped_file_types)
+    message::print("Processed {} source files", file_stats.processed_file_count);
+    if (reused_graph_count > 0)
+    {
+      message::print("Reused {} recorded include graphs", reused_graph_count);
+    }
+    for (const auto& skipped_file_type : file_stats.skipped_file_types)
     {
       auto msg = 1 == skipped_file_type.second ? "file" : "files";
       message::print("Skipped {} *{} {}", skipped_file_type.second, skipped_file_type.first, msg);
     }
   }
 
-  return merge_includes(include_data_array);
+  return merge_includes(impl_->transformer, std::move(include_data_array));
 }
 } // namespace scanner
@@ -0,0 +1,292 @@
+// Copyright (c) 2025 Environmental Systems Research Institute, Inc.
+// SPDX-License-Identifier: Apache-2.0
+
+#include <scanner/distributed_scan.hpp>
+
+#include <message/message.hpp>
+#include <src/include_graph_db.hpp>
+#include <src/scan_coordinator_impl.hpp>
+#include <src/scan_impl.hpp>
+#include <src/scan_protocol.hpp>
+#include <util/socket.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <expected>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#ifndef _WIN32
+#include <poll.h>
+#include <sys/socket.h>
+#endif
+
+namespace scanner
+{
+namespace
+{
+// Anyone who can reach the coordinator can connect, so the frames of a worker are bounded before
+// they are allocated. The results of a batch hold the include graphs of a few translation units.
+constexpr uint32_t max_hello_size = 1U << 10U;
+constexpr uint32_t max_results_size = 1U << 30U;
+
+// The translation units not handed out yet and the graphs received so far, shared by the
+// connections to all workers
+class Dispatcher
+{
+public:
+  Dispatcher(std::span<const Compile_command* const> compile_commands,
+             const Coordinator_timeouts& timeouts)
+  : compile_commands_(compile_commands),
+    timeouts_(timeouts)
+  {
+    for (size_t i = 0; i < compile_commands.size(); ++i)
+    {
+      pending_.push_back(i);
+    }
+  }
+
+  bool finished()
+  {
+    std::lock_guard lock(mutex_);
+    return pending_.empty() && in_flight_ == 0;
+  }
+
+  // The number of workers connected, counted from the accept to the end of serve
+  size_t connected()
+  {
+    std::lock_guard lock(mutex_);
+    return connected_;
+  }
+
+  // The translation units not handed out yet
+  size_t pending()
+  {
+    std::lock_guard lock(mutex_);
+    return pending_.size();
+  }
+
+  void connect()
+  {
+    std::lock_guard lock(mutex_);
+    ++connected_;
+  }
+
+  void disconnect()
+  {
+    std::lock_guard lock(mutex_);
+    --connected_;
+  }
+
+  // Hand out batches to the worker until every translation unit is recorded. The batch of a
+  // worker that goes away is handed out again.
+  void serve(int fd)
+  {
+    auto hello = util::read_frame(fd, timeouts_.idle, max_hello_size).and_then(decode_hello);
+    if (!hello)
+    {
+      return;
+    }
+
+    size_t worker_id = 0;
+    {
+      std::lock_guard lock(mutex_);
+      worker_id = ++worker_count_;
+      message::info("Worker {} connected with {} thread{}",
+                    worker_id,
+                    hello->thread_count,
+                    hello->thread_count == 1 ? "" : "s");
+    }
+
+    while (true)
+    {
+      std::vector<size_t> batch;
+      {
+        std::unique_lock lock(mutex_);
+        cv_.wait(lock, [&] { return !pending_.empty() || in_flight_ == 0; });
+        if (pending_.empty())
+        {
+          break;
+        }
+
+        // one translation unit per worker thread keeps the batches small enough to balance
+        const auto batch_size = std::min<size_t>(hello->thread_count, pending_.size());
+        batch.assign(pending_.begin(), pending_.begin() + static_cast<ptrdiff_t>(batch_size));
+        pending_.erase(pending_.begin(), pending_.begin() + static_cast<ptrdiff_t>(batch_size));
+        in_flight_ += batch.size();
+      }
+
+      std::vector<const Compile_command*> batch_commands;
+      batch_commands.reserve(batch.size());
+      for (auto i : batch)
+      {
+        batch_commands.push_back(compile_commands_[i]);
+      }
+
+      const auto scan_time = current_file_time();
+      std::optional<std::vector<Graph_result>> results;
+      if (util::write_frame(fd, encode_batch(batch_commands)))
+      {
+        results =
+          util::read_frame(fd, timeouts_.batch, max_results_size).and_then(decode_results);
+      }
+
+      std::lock_guard lock(mutex_);
+      in_flight_ -= batch.size();
+      cv_.notify_all();
+      if (!results || results->size() != batch.size())
+      {
+        message::warning("Lost worker {}. Handing out its {} translation unit{} again.",
+                         worker_id,
+                         batch.size(),
+                         batch.size() == 1 ? "" : "s");
+        pending_.insert(pending_.begin(), batch.begin(), batch.end());
+        return;
+      }
+
+      for (size_t i = 0; i < batch.size(); ++i)
+      {
+        auto& result = (*results)[i];
+        if (!result)
+        {
+          message::debug("Worker {} failed to preprocess {}: {}",
+                         worker_id,
+                         batch_commands[i]->source.string(),
+                         result.error());
+          continue;
+        }
+        records_.push_back(
+          Include_graph_record{*batch_commands[i], scan_time, std::move(*result)});
+      }
+    }
+
+    util::write_frame(fd, encode_batch({}));
+  }
+
+  std::vector<Include_graph_record> take_records()
+  {
+    std::lock_guard lock(mutex_);
+    return std::move(records_);
+  }
+
+private:
+  std::span<const Compile_command* const> compile_commands_;
+  const Coordinator_timeouts& timeouts_;
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  std::deque<size_t> pending_;
+  size_t in_flight_{0};
+  size_t worker_count_{0};
+  size_t connected_{0};
+  std::vector<Include_graph_record> records_;
+};
+} // namespace
+
+std::expected<Scan_coordinator, std::string> Scan_coordinator::listen(
+  std::string_view address,
+  Coordinator_timeouts timeouts)
+{
+  auto listen_fd = util::listen_on(address);
+  if (!listen_fd)
+  {
+    return std::unexpected(listen_fd.error());
+  }
+  auto impl = std::make_unique<Impl>();
+  impl->address = address;
+  impl->listen_fd = std::move(*listen_fd);
+  impl->timeouts = timeouts;
+  return Scan_coordinator(std::move(impl));
+}
+
+Scan_coordinator::Scan_coordinator(std::unique_ptr<Impl> impl)
+: impl_(std::move(impl))
+{
+}
+
+Scan_coordinator::~Scan_coordinator() = default;
+Scan_coordinator::Scan_coordinator(Scan_coordinator&& other) noexcept = default;
+Scan_coordinator& Scan_coordinator::operator=(Scan_coordinator&& other) noexcept = default;
+
+const std::string& Scan_coordinator::address() const
+{
+  return impl_->address;
+}
+
+Scan_coordinator::Impl::~Impl()
+{
+  if (std::error_code error; std::filesystem::is_socket(address, error))
+  {
+    std::filesystem::remove(address, error);
+  }
+}
+
+std::vector<Include_graph_record> Scan_coordinator::Impl::record(
+  std::span<const Compile_command* const> compile_commands)
+{
+#ifndef _WIN32
+  Dispatcher dispatcher(compile_commands, timeouts);
+  std::vector<std::thread> connections;
+  auto idle_since = std::chrono::steady_clock::now();
+  while (!dispatcher.finished())
+  {
+    // a worker that is lost in the middle of a batch is disconnected by the batch timeout, so
+    // without workers nothing is in flight and the rest can be left to the local scan
+    const auto now = std::chrono::steady_clock::now();
+    if (dispatcher.connected() > 0)
+    {
+      idle_since = now;
+    }
+    else if (now - idle_since > timeouts.idle)
+    {
+      message::warning("No worker connected for {} s. Scanning the remaining {} translation "
+                       "unit{} locally.",
+                       std::chrono::duration_cast<std::chrono::seconds>(timeouts.idle).count(),
+                       dispatcher.pending(),
+                       dispatcher.pending() == 1 ? "" : "s");
+      break;
+    }
+
+    // wake up regularly to notice when the connected workers finished everything
+    pollfd listen_poll{listen_fd.get(), POLLIN, 0};
+    if (::poll(&listen_poll, 1, 100) <= 0)
+    {
+      continue;
+    }
+    util::File_descriptor worker(::accept4(listen_fd.get(), nullptr, nullptr, SOCK_CLOEXEC));
+    if (worker.get() < 0)
+    {
+      continue;
+    }
+    dispatcher.connect();
+    connections.emplace_back(
+      [&dispatcher, worker = std::move(worker)]
+      {
+        dispatcher.serve(worker.get());
+        dispatcher.disconnect();
+      });
+  }
+
+  for (auto& connection : connections)
+  {
+    connection.join();
+  }
+  return dispatcher.take_records();
+#else
+  static_cast<void>(compile_commands);
+  return {};
+#endif
+}
+} // namespace scanner
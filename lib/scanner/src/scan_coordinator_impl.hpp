@@ -0,0 +1,36 @@
+// Copyright (c) 2025 Environmental Systems Research Institute, Inc.
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+
+#include <scanner/distributed_scan.hpp>
+#include <src/include_graph_db.hpp>
+#include <src/scan_impl.hpp>
+#include <util/socket.hpp>
+
+#include <span>
+#include <string>
+#include <vector>
+
+namespace scanner
+{
+struct Scan_coordinator::Impl
+{
+  Impl() = default;
+  ~Impl();
+  Impl(const Impl&) = delete;
+  Impl(Impl&&) = delete;
+  Impl& operator=(const Impl&) = delete;
+  Impl& operator=(Impl&&) = delete;
+
+  // Wait for workers and let them record the include graphs of the translation units. Returns
+  // the graphs that were recorded, translation units that failed on a worker or were not handed
+  // out before no worker was left for the idle timeout are left out.
+  std::vector<Include_graph_record> record(
+    std::span<const Compile_command* const> compile_commands);
+
+  std::string address;
+  util::File_descriptor listen_fd;
+  Coordinator_timeouts timeouts;
+};
+} // namespace scanner
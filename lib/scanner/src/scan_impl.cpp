@@ -3,9 +3,7 @@
 
 #include <src/scan_impl.hpp>
 
-#include <message/message.hpp>
-#include <scanner/include.hpp>
-#include <target_model/target_data.hpp>
+#include <src/include_graph.hpp>
 
 #include <clang/Basic/Diagnostic.h>
 #include <clang/Basic/DiagnosticOptions.h>
@@ -15,21 +13,27 @@
 #include <clang/Basic/LLVM.h>
 #include <clang/Basic/SourceLocation.h>
 #include <clang/Basic/SourceManager.h>
+#include <clang/Basic/TokenKinds.h>
 #include <clang/Frontend/CompilerInstance.h>
 #include <clang/Frontend/FrontendActions.h>
+#include <clang/Lex/HeaderSearchOptions.h>
 #include <clang/Lex/PPCallbacks.h>
 #include <clang/Lex/Preprocessor.h>
 #include <clang/Lex/PreprocessorOptions.h>
+#include <clang/Lex/Token.h>
 #include <clang/Serialization/PCHContainerOperations.h>
 #include <clang/Tooling/DependencyScanning/DependencyScanningFilesystem.h>
 #include <clang/Tooling/Tooling.h>
 #include <llvm/ADT/ArrayRef.h>
 #include <llvm/ADT/IntrusiveRefCntPtr.h>
+#include <llvm/ADT/SmallString.h>
 #include <llvm/ADT/Twine.h>
 #include <llvm/Support/ErrorOr.h>
 #include <llvm/Support/VirtualFileSystem.h>
 
 #include <cassert>
+#include <chrono>
+#include <cstddef>
 #include <cstdint>
 #include <expected>
 #include <filesystem>
@@ -56,30 +60,16 @@ std::filesystem::path to_normal_path(const std::string& path)
 class PPRecorder : public clang::PPCallbacks
 {
   const clang::Preprocessor& preprocessor_;
-  Include_data& include_data_;
-  const target_model::Target_data& target_data_;
+  Include_graph_builder& builder_;
 
   clang::FileID initial_fid_;
-  Source_line last_include_loc_;
-  std::vector<Source_line> include_chain_;
   std::filesystem::path current_source_file_;
-  Include_set* current_include_set_{nullptr};
-
-  enum class Context : uint8_t
-  {
-    arbitrary_file,
-    source_file,
-    interface_header
-  };
-  Context context_{Context::arbitrary_file};
+  uint32_t current_file_{0U};
 
 public:
-  PPRecorder(const clang::Preprocessor& preprocessor,
-             Include_data& include_data,
-             const target_model::Target_data& target_data)
+  PPRecorder(const clang::Preprocessor& preprocessor, Include_graph_builder& builder)
   : preprocessor_(preprocessor),
-    include_data_(include_data),
-    target_data_(target_data)
+    builder_(builder)
   {
   }
 
@@ -100,7 +90,7 @@ public:
         (reason == LexedFileChangeReason::ExitFile &&
          prev_fid == preprocessor_.getPredefinesFileID()))
     {
-      context_ = Context::arbitrary_file;
+      builder_.add_event({Include_event_kind::predefines});
       return;
     }
 
@@ -113,71 +103,17 @@ public:
 
     current_source_file_ = to_normal_path(
       preprocessor_.getSourceManager().getSLocEntry(fid).getFile().getName().str());
-
-    message::debug("# {} {}",
-                   (reason == LexedFileChangeReason::ExitFile ? "Reenter" : "Enter"),
-                   current_source_file_.string());
-
-    const auto previous_context = context_;
-    const auto previous_include_set = current_include_set_;
-
-    if (fid != initial_fid_ &&
-        target_model::is_interface_header(target_data_, current_source_file_))
-    {
-      message::debug("Context interface header");
-      context_ = Context::interface_header;
-      current_include_set_ = &include_data_.interface_header_includes[current_source_file_];
-    }
-    else if (target_model::is_private_source(target_data_, current_source_file_))
-    {
-      message::debug("Context source");
-      context_ = Context::source_file;
-      current_include_set_ = &include_data_.includes;
-    }
-    else
-    {
-      message::debug("Context arbitrary file");
-      context_ = Context::arbitrary_file;
-      current_include_set_ = nullptr;
-    }
-
-    if (reason == LexedFileChangeReason::EnterFile)
-    {
-      if (!last_include_loc_.source.empty())
-      {
-        message::debug("Push include chain {}", last_include_loc_.source.string());
-        include_chain_.emplace_back(last_include_loc_);
-      }
-
-      if (previous_include_set && context_ == Context::arbitrary_file)
-      {
-        message::debug("Dependency added to previous context: {} ({})",
-                       current_source_file_.string(),
-                       static_cast<const void*>(previous_include_set));
-        previous_include_set->emplace(Include{current_source_file_, include_chain_});
-      }
-    }
-    else
-    {
-      if (!include_chain_.empty())
-      {
-        message::debug("Pop include chain {}", include_chain_.back().source.string());
-        include_chain_.pop_back();
-      }
-
-      if (previous_context == Context::interface_header && context_ != Context::arbitrary_file)
-      {
-        message::debug("Dependency propagation");
-        // propagate includes
-        for (const auto& e : *previous_include_set)
-        {
-          message::debug("Dependency added to current context: {} ({})",
-                         e.path.string(),
-                         static_cast<const void*>(current_include_set_));
-          current_include_set_->insert(e);
-        }
-      }
-    }
+    current_file_ = builder_.file_id(current_source_file_);
+    // quoted includes are looked up next to the includer first
+    builder_.add_directory(current_source_file_.parent_path());
+
+    builder_.add_event({reason == LexedFileChangeReason::ExitFile
+                          ? Include_event_kind::reenter_file
+                          : Include_event_kind::enter_file,
+                        static_cast<uint8_t>(fid == initial_fid_ ? 1U : 0U),
+                        0U,
+                        current_file_,
+                        0U});
   }
 
   void InclusionDirective(clang::SourceLocation include_loc,
@@ -194,7 +130,8 @@ public:
     auto presumed_loc = preprocessor_.getSourceManager().getPresumedLoc(include_loc);
     assert(presumed_loc.isValid());
     assert(current_source_file_ == to_normal_path(presumed_loc.getFilename()));
-    last_include_loc_ = Source_line{current_source_file_, presumed_loc.getLine()};
+    builder_.add_event(
+      {Include_event_kind::include_directive, 0U, 0U, current_file_, presumed_loc.getLine()});
   }
 
   void FileSkipped(const clang::FileEntryRef& file,
@@ -204,58 +141,34 @@ public:
     const auto& fileEntry = file.getFileEntry();
     const auto filename = to_normal_path(fileEntry.tryGetRealPathName().str());
 
-    message::debug("file skipped: {}", filename.string());
-
-    if (context_ == Context::arbitrary_file)
-    {
-      return;
-    }
-
-    if (target_model::is_interface_header(target_data_, filename) ||
-        target_model::is_private_source(target_data_, filename))
-    {
-      if (auto it = include_data_.interface_header_includes.find(filename);
-          it != include_data_.interface_header_includes.end())
-      {
-        message::debug("Dependency propagation");
-        // propagate includes
-        for (const auto& e : it->second)
-        {
-          message::debug("Dependency added: {} ({})",
-                         e.path.string(),
-                         static_cast<const void*>(current_include_set_));
-          current_include_set_->insert(e);
-        }
-      }
-    }
-    else
-    {
-      message::debug("Dependency added: {} ({})",
-                     filename.string(),
-                     static_cast<const void*>(current_include_set_));
-      auto include_chain = include_chain_;
-      if (!last_include_loc_.source.empty())
-      {
-        include_chain.emplace_back(last_include_loc_);
-      }
-      current_include_set_->emplace(Include{filename, std::move(include_chain)});
-    }
+    builder_.add_event(
+      {Include_event_kind::skip_file, 0U, 0U, builder_.file_id(filename), 0U});
   }
 };
 
+enum class Interruption
+{
+  none,
+  stopped,
+  timed_out,
+};
+
 class Action : public clang::PreprocessOnlyAction
 {
-  Include_data& include_data_;
-  const target_model::Target_data& target_data_;
+  Include_graph_builder& builder_;
+  const Scan_budget& budget_;
+  Interruption& interruption_;
 
   llvm::IntrusiveRefCntPtr<clang::tooling::dependencies::DependencyScanningWorkerFilesystem> dep_fs_;
 
 public:
-  Action(Include_data& include_data,
-         const target_model::Target_data& target_data,
+  Action(Include_graph_builder& builder,
+         const Scan_budget& budget,
+         Interruption& interruption,
          llvm::IntrusiveRefCntPtr<clang::tooling::dependencies::DependencyScanningWorkerFilesystem> dep_fs)
-  : include_data_(include_data),
-    target_data_(target_data),
+  : builder_(builder),
+    budget_(budget),
+    interruption_(interruption),
     dep_fs_(std::move(dep_fs))
   {
   }
@@ -280,23 +193,61 @@ private:
       return std::nullopt;
     };
 
+    // the directories that do not exist are recorded too since creating one can shadow a header
+    // as well
+    auto& file_manager = compiler_instance.getFileManager();
+    for (const auto& entry : compiler_instance.getHeaderSearchOpts().UserEntries)
+    {
+      llvm::SmallString<256> path(entry.Path);
+      file_manager.makeAbsolutePath(path);
+      builder_.add_directory(to_normal_path(path.str().str()));
+    }
+
     auto& preprocessor = compiler_instance.getPreprocessor();
-    preprocessor.addPPCallbacks(
-      std::make_unique<PPRecorder>(preprocessor, include_data_, target_data_));
+    preprocessor.addPPCallbacks(std::make_unique<PPRecorder>(preprocessor, builder_));
+
+    // the same as PreprocessOnlyAction::ExecuteAction, except that the loop gives up when the
+    // budget is exhausted
+    preprocessor.IgnorePragmas();
+    preprocessor.EnterMainSourceFile();
+    clang::Token token;
+    for (size_t count = 1; interruption_ == Interruption::none; ++count)
+    {
+      preprocessor.Lex(token);
+      if (token.is(clang::tok::eof))
+      {
+        break;
+      }
 
-    PreprocessOnlyAction::ExecuteAction();
+      // reading the clock for every token would be noticeable
+      constexpr size_t check_interval = 1024;
+      if (count % check_interval != 0)
+      {
+        continue;
+      }
+      if (budget_.stop_token.stop_requested())
+      {
+        interruption_ = Interruption::stopped;
+      }
+      else if (budget_.deadline && std::chrono::steady_clock::now() > *budget_.deadline)
+      {
+        interruption_ = Interruption::timed_out;
+      }
+    }
   }
 };
 
 class Action_factory : public clang::tooling::FrontendActionFactory
 {
 public:
-  Action_factory(Include_data& include_data,
-                 const target_model::Target_data& target_data,
+  Action_factory(Include_graph_builder& builder,
+                 const Scan_budget& budget,
+                 Interruption& interruption,
                  llvm::IntrusiveRefCntPtr<llvm::vfs::FileSystem> file_system,
                  clang::tooling::dependencies::DependencyScanningFilesystemSharedCache& dep_cache)
-  : include_data_(include_data),
-    target_data_(target_data),
+  : builder_(builder),
+    budget_(budget),
+    interruption_(interruption),
     file_system_(std::move(file_system)),
     dep_cache_(dep_cache)
   {
@@ -314,29 +265,31 @@ public:
       llvm::IntrusiveRefCntPtr<clang::tooling::dependencies::DependencyScanningWorkerFilesystem>{
         new clang::tooling::dependencies::DependencyScanningWorkerFilesystem(dep_cache_,
                                                                              file_system_)};
-    return std::make_unique<Action>(include_data_, target_data_, std::move(dep_fs));
+    return std::make_unique<Action>(builder_, budget_, interruption_, std::move(dep_fs));
   }
 
 private:
-  Include_data& include_data_;
-  const target_model::Target_data& target_data_;
+  Include_graph_builder& builder_;
+  const Scan_budget& budget_;
+  Interruption& interruption_;
   llvm::IntrusiveRefCntPtr<llvm::vfs::FileSystem> file_system_;
   clang::tooling::dependencies::DependencyScanningFilesystemSharedCache& dep_cache_;
 };
 
-std::expected<Include_data, std::string> scan_impl(
+std::expected<Include_graph, std::string> record_include_graph(
   const llvm::IntrusiveRefCntPtr<llvm::vfs::FileSystem>& file_system,
   clang::tooling::dependencies::DependencyScanningFilesystemSharedCache& dep_cache,
-  const target_model::Target_data& target_data,
-  const Compile_command& compile_command)
+  const Compile_command& compile_command,
+  const Scan_budget& budget)
 {
   if (file_system->setCurrentWorkingDirectory(compile_command.cwd.string()))
   {
     return std::unexpected(std::format("Cannot chdir into {}", compile_command.cwd.string()));
   }
 
-  Include_data include_data;
-  Action_factory action_factory(include_data, target_data, file_system, dep_cache);
+  Include_graph_builder builder;
+  auto interruption = Interruption::none;
+  Action_factory action_factory(builder, budget, interruption, file_system, dep_cache);
   auto file_manager = llvm::IntrusiveRefCntPtr<clang::FileManager>{
     new clang::FileManager(clang::FileSystemOptions(), file_system)};
   auto pch_container_ops = std::make_shared<clang::PCHContainerOperations>();
@@ -345,12 +298,37 @@ std::expected<Include_data, std::string> scan_impl(
                                             &action_factory,
                                             file_manager.get(),
                                             pch_container_ops);
-  if (!invocation.run())
+  const bool succeeded = invocation.run();
+  if (interruption == Interruption::stopped)
+  {
+    return std::unexpected(
+      std::format("Preprocessing {} was cancelled.\n", compile_command.source.string()));
+  }
+  if (interruption == Interruption::timed_out)
+  {
+    return std::unexpected(
+      std::format("Preprocessing {} timed out.\n", compile_command.source.string()));
+  }
+  if (!succeeded)
   {
     return std::unexpected(
       std::format("Error while processing {}.\n", compile_command.source.string()));
   }
 
-  return include_data;
+  return builder.take();
+}
+
+std::expected<Include_data, std::string> scan_impl(
+  const llvm::IntrusiveRefCntPtr<llvm::vfs::FileSystem>& file_system,
+  clang::tooling::dependencies::DependencyScanningFilesystemSharedCache& dep_cache,
+  const target_model::Target_data& target_data,
+  const Compile_command& compile_command)
+{
+  return record_include_graph(file_system, dep_cache, compile_command, {})
+    .transform(
+      [&](const Include_graph& graph)
+      {
+        return classify_includes(graph.events, graph.files, target_data);
+      });
 }
 } // namespace scanner
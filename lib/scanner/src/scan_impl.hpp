@@ -5,11 +5,15 @@
 
 #include <scanner/include.hpp>
 #include <scanner/scan.hpp>
+#include <src/include_graph.hpp>
 
+#include <chrono>
 #include <expected>
 #include <filesystem>
 #include <map>
+#include <optional>
 #include <set>
+#include <stop_token>
 #include <string>
 #include <vector>
 
@@ -61,6 +65,21 @@ struct Include_data
   std::map<std::filesystem::path, Include_set> interface_header_includes;
 };
 
+// Preprocessing gives up when a stop is requested or the deadline passes
+struct Scan_budget
+{
+  std::stop_token stop_token;
+  std::optional<std::chrono::steady_clock::time_point> deadline;
+};
+
+// Preprocess a translation unit and record its file level include graph
+std::expected<Include_graph, std::string> record_include_graph(
+  const llvm::IntrusiveRefCntPtr<llvm::vfs::FileSystem>& file_system,
+  clang::tooling::dependencies::DependencyScanningFilesystemSharedCache& dep_cache,
+  const Compile_command& compile_command,
+  const Scan_budget& budget);
+
+// Preprocess a translation unit and classify its includes with respect to the target
 std::expected<Include_data, std::string> scan_impl(
   const llvm::IntrusiveRefCntPtr<llvm::vfs::FileSystem>& file_system,
   clang::tooling::dependencies::DependencyScanningFilesystemSharedCache& dep_cache,
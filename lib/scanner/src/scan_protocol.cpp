@@ -0,0 +1,276 @@
+// Copyright (c) 2025 Environmental Systems Research Institute, Inc.
+// SPDX-License-Identifier: Apache-2.0
+
+#include <src/scan_protocol.hpp>
+
+#include <src/include_graph.hpp>
+#include <src/scan_impl.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <expected>
+#include <filesystem>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace scanner
+{
+namespace
+{
+constexpr std::string_view protocol_header = "lwyi worker 1";
+
+class Writer
+{
+public:
+  void u8(uint8_t value)
+  {
+    bytes_.push_back(static_cast<char>(value));
+  }
+
+  void u32(uint32_t value)
+  {
+    for (size_t i = 0; i < 4; ++i)
+    {
+      u8(static_cast<uint8_t>((value >> (8 * i)) & 0xFFU));
+    }
+  }
+
+  void string(std::string_view value)
+  {
+    u32(static_cast<uint32_t>(value.size()));
+    bytes_.append(value);
+  }
+
+  std::string take()
+  {
+    return std::move(bytes_);
+  }
+
+private:
+  std::string bytes_;
+};
+
+// Reads until the first error, after which every value is empty and ok() is false
+class Reader
+{
+public:
+  explicit Reader(std::string_view bytes)
+  : bytes_(bytes)
+  {
+  }
+
+  uint8_t u8()
+  {
+    if (bytes_.empty())
+    {
+      ok_ = false;
+      return 0U;
+    }
+    const auto value = static_cast<uint8_t>(bytes_.front());
+    bytes_.remove_prefix(1);
+    return value;
+  }
+
+  uint32_t u32()
+  {
+    uint32_t value = 0U;
+    for (size_t i = 0; i < 4; ++i)
+    {
+      value |= static_cast<uint32_t>(u8()) << (8 * i);
+    }
+    return value;
+  }
+
+  std::string_view string()
+  {
+    const auto size = u32();
+    if (!ok_ || bytes_.size() < size)
+    {
+      ok_ = false;
+      return {};
+    }
+    const auto value = bytes_.substr(0, size);
+    bytes_.remove_prefix(size);
+    return value;
+  }
+
+  // Counts are checked against the remaining bytes before anything is allocated for them
+  uint32_t count(size_t min_element_size)
+  {
+    const auto value = u32();
+    if (bytes_.size() / min_element_size < value)
+    {
+      ok_ = false;
+      return 0U;
+    }
+    return value;
+  }
+
+  bool ok() const
+  {
+    return ok_;
+  }
+
+  bool at_end() const
+  {
+    return ok_ && bytes_.empty();
+  }
+
+private:
+  std::string_view bytes_;
+  bool ok_{true};
+};
+} // namespace
+
+std::string encode_hello(const Worker_hello& hello)
+{
+  Writer writer;
+  writer.string(protocol_header);
+  writer.u32(hello.thread_count);
+  return writer.take();
+}
+
+std::optional<Worker_hello> decode_hello(std::string_view frame)
+{
+  Reader reader(frame);
+  if (reader.string() != protocol_header)
+  {
+    return std::nullopt;
+  }
+  Worker_hello hello{reader.u32()};
+  if (!reader.at_end() || hello.thread_count == 0U)
+  {
+    return std::nullopt;
+  }
+  return hello;
+}
+
+std::string encode_batch(std::span<const Compile_command* const> compile_commands)
+{
+  Writer writer;
+  writer.u32(static_cast<uint32_t>(compile_commands.size()));
+  for (const auto* compile_command : compile_commands)
+  {
+    writer.string(compile_command->cwd.generic_string());
+    writer.string(compile_command->source.generic_string());
+    writer.u32(static_cast<uint32_t>(compile_command->command.size()));
+    for (const auto& argument : compile_command->command)
+    {
+      writer.string(argument);
+    }
+  }
+  return writer.take();
+}
+
+std::optional<std::vector<Compile_command>> decode_batch(std::string_view frame)
+{
+  Reader reader(frame);
+  std::vector<Compile_command> compile_commands(reader.count(12));
+  for (auto& compile_command : compile_commands)
+  {
+    compile_command.cwd = reader.string();
+    compile_command.source = reader.string();
+    compile_command.command.resize(reader.count(4));
+    for (auto& argument : compile_command.command)
+    {
+      argument = reader.string();
+    }
+  }
+  if (!reader.at_end())
+  {
+    return std::nullopt;
+  }
+  return compile_commands;
+}
+
+std::string encode_results(std::span<const Graph_result> results)
+{
+  Writer writer;
+  writer.u32(static_cast<uint32_t>(results.size()));
+  for (const auto& result : results)
+  {
+    if (!result)
+    {
+      writer.u8(0U);
+      writer.string(result.error());
+      continue;
+    }
+
+    writer.u8(1U);
+    writer.u32(static_cast<uint32_t>(result->files.size()));
+    for (const auto& file : result->files)
+    {
+      writer.string(file.generic_string());
+    }
+    writer.u32(static_cast<uint32_t>(result->events.size()));
+    for (const auto& event : result->events)
+    {
+      writer.u8(static_cast<uint8_t>(event.kind));
+      writer.u8(event.main_file);
+      writer.u32(event.file);
+      writer.u32(event.line);
+    }
+    writer.u32(static_cast<uint32_t>(result->directories.size()));
+    for (const auto& directory : result->directories)
+    {
+      writer.string(directory.generic_string());
+    }
+  }
+  return writer.take();
+}
+
+std::optional<std::vector<Graph_result>> decode_results(std::string_view frame)
+{
+  Reader reader(frame);
+  const auto result_count = reader.count(1);
+  std::vector<Graph_result> results;
+  results.reserve(result_count);
+  for (uint32_t i = 0; reader.ok() && i < result_count; ++i)
+  {
+    if (reader.u8() == 0U)
+    {
+      results.emplace_back(std::unexpected(std::string(reader.string())));
+      continue;
+    }
+
+    Include_graph graph;
+    graph.files.resize(reader.count(4));
+    for (auto& file : graph.files)
+    {
+      file = reader.string();
+    }
+    graph.events.resize(reader.count(10));
+    for (auto& event : graph.events)
+    {
+      const auto kind = reader.u8();
+      if (kind > static_cast<uint8_t>(Include_event_kind::include_directive))
+      {
+        return std::nullopt;
+      }
+      event.kind = static_cast<Include_event_kind>(kind);
+      event.main_file = reader.u8();
+      event.file = reader.u32();
+      event.line = reader.u32();
+      if (event.kind != Include_event_kind::predefines && event.file >= graph.files.size())
+      {
+        return std::nullopt;
+      }
+    }
+    graph.directories.resize(reader.count(4));
+    for (auto& directory : graph.directories)
+    {
+      directory = reader.string();
+    }
+    results.emplace_back(std::move(graph));
+  }
+  if (!reader.at_end())
+  {
+    return std::nullopt;
+  }
+  return results;
+}
+} // namespace scanner
@@ -0,0 +1,37 @@
+// Copyright (c) 2025 Environmental Systems Research Institute, Inc.
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+
+#include <src/include_graph.hpp>
+#include <src/scan_impl.hpp>
+
+#include <cstdint>
+#include <expected>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace scanner
+{
+// A scan coordinator and its workers exchange frames. A worker starts with a hello and then
+// alternates between receiving a batch of translation units and sending their include graphs,
+// until it receives an empty batch. Numbers are little endian so workers can run on any host.
+struct Worker_hello
+{
+  uint32_t thread_count{1U};
+};
+
+using Graph_result = std::expected<Include_graph, std::string>;
+
+std::string encode_hello(const Worker_hello& hello);
+std::optional<Worker_hello> decode_hello(std::string_view frame);
+
+std::string encode_batch(std::span<const Compile_command* const> compile_commands);
+std::optional<std::vector<Compile_command>> decode_batch(std::string_view frame);
+
+std::string encode_results(std::span<const Graph_result> results);
+std::optional<std::vector<Graph_result>> decode_results(std::string_view frame);
+} // namespace scanner
@@ -0,0 +1,130 @@
+// Copyright (c) 2025 Environmental Systems Research Institute, Inc.
+// SPDX-License-Identifier: Apache-2.0
+
+#include <scanner/distributed_scan.hpp>
+
+#include <relative_resource_dir.hpp>
+#include <src/executable_path.hpp>
+#include <src/scan_impl.hpp>
+#include <src/scan_protocol.hpp>
+#include <util/parallel_transformer.hpp>
+#include <util/socket.hpp>
+
+#include <clang/Tooling/DependencyScanning/DependencyScanningFilesystem.h>
+#include <llvm/ADT/IntrusiveRefCntPtr.h>
+#include <llvm/Support/VirtualFileSystem.h>
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <expected>
+#include <format>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace scanner
+{
+namespace
+{
+// Workers are usually started along with the coordinator, give it some time to listen
+std::expected<util::File_descriptor, std::string> connect_to_coordinator(std::string_view address)
+{
+  constexpr int attempts = 50;
+  constexpr auto retry_interval = std::chrono::milliseconds(200);
+  auto fd = util::connect_to(address);
+  for (int attempt = 1; !fd && attempt < attempts; ++attempt)
+  {
+    std::this_thread::sleep_for(retry_interval);
+    fd = util::connect_to(address);
+  }
+  return fd;
+}
+
+// The coordinator points the commands at its own clang resource directory, which may not exist
+// where the worker is installed
+void use_own_resource_dir(std::vector<Compile_command>& compile_commands)
+{
+  const auto resource_dir = executable_path().parent_path() / relative_resource_dir();
+  const auto resource_dir_argument = std::format("-resource-dir={}", resource_dir.string());
+  for (auto& compile_command : compile_commands)
+  {
+    for (auto& argument : compile_command.command)
+    {
+      if (argument.starts_with("-resource-dir="))
+      {
+        argument = resource_dir_argument;
+      }
+    }
+  }
+}
+} // namespace
+
+std::expected<size_t, std::string> run_scan_worker(std::string_view address,
+                                                   size_t thread_count,
+                                                   std::chrono::milliseconds tu_timeout)
+{
+  auto fd = connect_to_coordinator(address);
+  if (!fd)
+  {
+    return std::unexpected(fd.error());
+  }
+
+  util::Parallel_transformer transformer(thread_count);
+  if (!util::write_frame(fd->get(),
+                         encode_hello({static_cast<uint32_t>(transformer.thread_count())})))
+  {
+    return std::unexpected(std::format("error: failed to send hello to {}", address));
+  }
+
+  // the sources do not change while the coordinator waits for the results
+  clang::tooling::dependencies::DependencyScanningFilesystemSharedCache dep_cache;
+
+  size_t scanned_count = 0;
+  for (bool first_batch = true;; first_batch = false)
+  {
+    auto frame = util::read_frame(fd->get());
+    if (!frame && first_batch)
+    {
+      // the coordinator stopped listening before it accepted this worker
+      return scanned_count;
+    }
+    auto batch = std::move(frame).and_then(decode_batch);
+    if (!batch)
+    {
+      return std::unexpected(std::format("error: lost the connection to {}", address));
+    }
+    if (batch->empty())
+    {
+      return scanned_count;
+    }
+
+    use_own_resource_dir(*batch);
+
+    std::vector<Graph_result> results(batch->size());
+    transformer.transform(batch->begin(),
+                          batch->end(),
+                          results.begin(),
+                          [&](const Compile_command& compile_command)
+                          {
+                            Scan_budget budget;
+                            if (tu_timeout.count() > 0)
+                            {
+                              budget.deadline = std::chrono::steady_clock::now() + tu_timeout;
+                            }
+                            auto file_system = llvm::IntrusiveRefCntPtr<llvm::vfs::FileSystem>{
+                              llvm::vfs::createPhysicalFileSystem()};
+                            return record_include_graph(
+                              file_system, dep_cache, compile_command, budget);
+                          });
+
+    if (!util::write_frame(fd->get(), encode_results(results)))
+    {
+      return std::unexpected(std::format("error: lost the connection to {}", address));
+    }
+    scanned_count += batch->size();
+  }
+}
+} // namespace scanner
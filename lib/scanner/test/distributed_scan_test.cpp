@@ -0,0 +1,224 @@
+// Copyright (c) 2025 Environmental Systems Research Institute, Inc.
+// SPDX-License-Identifier: Apache-2.0
+
+#include <scanner/distributed_scan.hpp>
+
+#include <scanner/scan.hpp>
+#include <src/include_graph.hpp>
+#include <src/scan_impl.hpp>
+#include <src/scan_protocol.hpp>
+#include <target_model/target_data.hpp>
+#include <util/socket.hpp>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <chrono>
+#include <cstddef>
+#include <expected>
+#include <filesystem>
+#include <format>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace
+{
+// Eight sources that include either a.hpp or b.hpp, with their compilation database
+target_model::Target_data write_sources(const std::filesystem::path& dir)
+{
+  std::filesystem::remove_all(dir);
+  std::filesystem::create_directories(dir);
+
+  std::ofstream(dir / "a.hpp") << "\n";
+  std::ofstream(dir / "b.hpp") << "\n";
+  target_model::Target_data target_data;
+  std::ofstream compile_commands(dir / "compile_commands.json");
+  compile_commands << "[";
+  for (int i = 0; i < 8; ++i)
+  {
+    const auto source = dir / std::format("source{}.cpp", i);
+    std::ofstream(source) << (i % 2 == 0 ? "#include \"a.hpp\"\n" : "#include \"b.hpp\"\n");
+    target_data.sources.insert(source);
+    compile_commands << std::format(R"({}{{"directory": "{}", "file": "{}", "command": "{}"}})",
+                                    i == 0 ? "" : ",",
+                                    dir.generic_string(),
+                                    source.generic_string(),
+                                    "clang++ -c " + source.generic_string());
+  }
+  compile_commands << "]";
+  return target_data;
+}
+} // namespace
+
+TEST_CASE("scanner: scan protocol", "[scanner]")
+{
+  SECTION("hello")
+  {
+    auto hello = scanner::decode_hello(scanner::encode_hello({4U}));
+    REQUIRE(hello.has_value());
+    CHECK(hello->thread_count == 4U);
+    CHECK(!scanner::decode_hello("lwyi worker 0").has_value());
+  }
+
+  SECTION("batch")
+  {
+    const scanner::Compile_command compile_command{"/build", "/src/a.cpp", {"clang", "a.cpp"}};
+    const std::vector<const scanner::Compile_command*> compile_commands{&compile_command};
+
+    const auto frame = scanner::encode_batch(compile_commands);
+    auto batch = scanner::decode_batch(frame);
+    REQUIRE(batch.has_value());
+    REQUIRE(batch->size() == 1U);
+    CHECK((*batch)[0].cwd == compile_command.cwd);
+    CHECK((*batch)[0].source == compile_command.source);
+    CHECK((*batch)[0].command == compile_command.command);
+
+    CHECK(!scanner::decode_batch(std::string_view(frame).substr(0, frame.size() - 1)));
+    CHECK(scanner::decode_batch(scanner::encode_batch({}))->empty());
+  }
+
+  SECTION("results")
+  {
+    using enum scanner::Include_event_kind;
+
+    scanner::Include_graph_builder builder;
+    const auto a_cpp = builder.file_id("/src/a.cpp");
+    const auto a_hpp = builder.file_id("/src/a.hpp");
+    builder.add_event({predefines});
+    builder.add_event({enter_file, 1U, 0U, a_cpp, 0U});
+    builder.add_event({include_directive, 0U, 0U, a_cpp, 2U});
+    builder.add_event({enter_file, 0U, 0U, a_hpp, 0U});
+    builder.add_directory("/src");
+    builder.add_directory("/include");
+    builder.add_directory("/src");
+
+    std::vector<scanner::Graph_result> results;
+    results.emplace_back(builder.take());
+    results.emplace_back(std::unexpected(std::string("fatal error: 'b.hpp' file not found")));
+
+    const auto frame = scanner::encode_results(results);
+    auto decoded = scanner::decode_results(frame);
+    REQUIRE(decoded.has_value());
+    REQUIRE(decoded->size() == 2U);
+    REQUIRE((*decoded)[0].has_value());
+    CHECK((*decoded)[0]->files == results[0]->files);
+    REQUIRE((*decoded)[0]->events.size() == 4U);
+    CHECK((*decoded)[0]->events[2].kind == include_directive);
+    CHECK((*decoded)[0]->events[2].line == 2U);
+    CHECK((*decoded)[0]->events[3].file == a_hpp);
+    CHECK((*decoded)[0]->directories ==
+          std::vector<std::filesystem::path>{"/src", "/include"});
+    REQUIRE(!(*decoded)[1].has_value());
+    CHECK((*decoded)[1].error() == results[1].error());
+
+    CHECK(!scanner::decode_results(std::string_view(frame).substr(0, frame.size() - 1)));
+  }
+}
+
+TEST_CASE("scanner: distributed scan", "[scanner]")
+{
+  const auto dir = std::filesystem::temp_directory_path() / "lwyi_distributed_scan_test";
+  const auto target_data = write_sources(dir);
+
+  const auto address = (dir / "coordinator.sock").string();
+  scanner::Scanner scanner(1U);
+  std::vector<std::expected<size_t, std::string>> worker_results(3);
+  std::vector<std::thread> workers;
+  std::expected<size_t, std::string> recorded;
+  {
+    auto coordinator = scanner::Scan_coordinator::listen(address);
+    REQUIRE(coordinator.has_value());
+    CHECK(coordinator->address() == address);
+
+    for (size_t i = 0; i < worker_results.size(); ++i)
+    {
+      workers.emplace_back([&, i]
+                           { worker_results[i] = scanner::run_scan_worker(address, i + 1, {}); });
+    }
+    recorded = scanner.scan_on_workers(dir, {&target_data}, *coordinator);
+  }
+  for (auto& worker : workers)
+  {
+    worker.join();
+  }
+
+  REQUIRE(recorded.has_value());
+  CHECK(*recorded == 8U);
+
+  size_t scanned_count = 0;
+  for (const auto& worker_result : worker_results)
+  {
+    // a worker that connected after everything was handed out had nothing to do
+    REQUIRE(worker_result.has_value());
+    scanned_count += *worker_result;
+  }
+  CHECK(scanned_count == 8U);
+
+  CHECK(scanner.include_index().affected_sources({dir / "b.hpp"}).size() == 4U);
+
+  auto includes = scanner.scan(dir, target_data);
+  REQUIRE(includes.has_value());
+  CHECK(includes->includes.size() == 2U);
+}
+
+TEST_CASE("scanner: distributed scan without workers", "[scanner]")
+{
+  const auto dir = std::filesystem::temp_directory_path() / "lwyi_distributed_scan_idle_test";
+  const auto target_data = write_sources(dir);
+  const auto address = (dir / "coordinator.sock").string();
+  const scanner::Coordinator_timeouts timeouts{std::chrono::milliseconds(200),
+                                               std::chrono::milliseconds(200)};
+
+  scanner::Scanner scanner(1U);
+  std::expected<size_t, std::string> recorded;
+
+  SECTION("no worker connects")
+  {
+    auto coordinator = scanner::Scan_coordinator::listen(address, timeouts);
+    REQUIRE(coordinator.has_value());
+    recorded = scanner.scan_on_workers(dir, {&target_data}, *coordinator);
+  }
+
+  SECTION("a worker does not answer its batch")
+  {
+    auto coordinator = scanner::Scan_coordinator::listen(address, timeouts);
+    REQUIRE(coordinator.has_value());
+    std::thread worker(
+      [&]
+      {
+        auto fd = util::connect_to(address);
+        REQUIRE(fd.has_value());
+        REQUIRE(util::write_frame(fd->get(), scanner::encode_hello({2U})));
+        // wait for the coordinator to give up on the batch and close the connection
+        CHECK(util::read_frame(fd->get()).has_value());
+        CHECK(!util::read_frame(fd->get()).has_value());
+      });
+    recorded = scanner.scan_on_workers(dir, {&target_data}, *coordinator);
+    worker.join();
+  }
+
+  SECTION("a worker announces a frame larger than a hello")
+  {
+    auto coordinator = scanner::Scan_coordinator::listen(address, timeouts);
+    REQUIRE(coordinator.has_value());
+    std::thread worker(
+      [&]
+      {
+        auto fd = util::connect_to(address);
+        REQUIRE(fd.has_value());
+        REQUIRE(util::write_all(fd->get(), std::string(4, '\xff')));
+        // the coordinator closes the connection instead of waiting for 4 GiB
+        CHECK(!util::read_frame(fd->get()).has_value());
+      });
+    recorded = scanner.scan_on_workers(dir, {&target_data}, *coordinator);
+    worker.join();
+  }
+
+  // everything is left to the local scan
+  REQUIRE(recorded.has_value());
+  CHECK(*recorded == 0U);
+  auto includes = scanner.scan(dir, target_data);
+  REQUIRE(includes.has_value());
+  CHECK(includes->includes.size() == 2U);
+}
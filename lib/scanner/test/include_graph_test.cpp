@@ -0,0 +1,199 @@
+// Copyright (c) 2025 Environmental Systems Research Institute, Inc.
+// SPDX-License-Identifier: Apache-2.0
+
+#include <src/include_graph.hpp>
+
+#include <scanner/include.hpp>
+#include <src/include_graph_db.hpp>
+#include <src/scan_impl.hpp>
+#include <target_model/target_data.hpp>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <set>
+#include <string>
+
+namespace
+{
+// The events recorded for private.cpp including interface.hpp, which includes a.hpp, followed
+// by b.hpp
+scanner::Include_graph make_graph(const std::filesystem::path& dir)
+{
+  using enum scanner::Include_event_kind;
+
+  scanner::Include_graph_builder builder;
+  const auto private_cpp = builder.file_id(dir / "private.cpp");
+  const auto interface_hpp = builder.file_id(dir / "interface.hpp");
+  const auto a_hpp = builder.file_id(dir / "a.hpp");
+  const auto b_hpp = builder.file_id(dir / "b.hpp");
+
+  builder.add_event({enter_file, 1U, 0U, private_cpp, 0U});
+  builder.add_event({include_directive, 0U, 0U, private_cpp, 2U});
+  builder.add_event({enter_file, 0U, 0U, interface_hpp, 0U});
+  builder.add_event({include_directive, 0U, 0U, interface_hpp, 2U});
+  builder.add_event({enter_file, 0U, 0U, a_hpp, 0U});
+  builder.add_event({reenter_file, 0U, 0U, interface_hpp, 0U});
+  builder.add_event({reenter_file, 1U, 0U, private_cpp, 0U});
+  builder.add_event({include_directive, 0U, 0U, private_cpp, 3U});
+  builder.add_event({enter_file, 0U, 0U, b_hpp, 0U});
+  builder.add_event({reenter_file, 1U, 0U, private_cpp, 0U});
+  builder.add_event({include_directive, 0U, 0U, private_cpp, 4U});
+  builder.add_event({skip_file, 0U, 0U, a_hpp, 0U});
+  return builder.take();
+}
+
+std::set<std::filesystem::path> paths(const scanner::Include_set& include_set)
+{
+  std::set<std::filesystem::path> result;
+  for (const auto& include : include_set)
+  {
+    result.insert(include.path);
+  }
+  return result;
+}
+} // namespace
+
+TEST_CASE("scanner: classify_includes", "[scanner]")
+{
+  const auto graph = make_graph("/");
+  REQUIRE(graph.files.size() == 4U);
+
+  target_model::Target_data target_data;
+  target_data.interface_headers = {"/interface.hpp"};
+  target_data.sources = {"/private.cpp"};
+
+  const auto include_data = scanner::classify_includes(graph.events, graph.files, target_data);
+
+  CHECK(paths(include_data.includes) == std::set<std::filesystem::path>{"/a.hpp", "/b.hpp"});
+  REQUIRE(include_data.interface_header_includes.contains("/interface.hpp"));
+  const auto& interface_includes = include_data.interface_header_includes.at("/interface.hpp");
+  REQUIRE(interface_includes.size() == 1U);
+  CHECK(interface_includes.begin()->path == "/a.hpp");
+  const auto& include_chain = interface_includes.begin()->include_chain;
+  REQUIRE(include_chain.size() == 2U);
+  CHECK(include_chain[0].source == "/private.cpp");
+  CHECK(include_chain[0].line == 2U);
+  CHECK(include_chain[1].source == "/interface.hpp");
+  CHECK(include_chain[1].line == 2U);
+}
+
+TEST_CASE("scanner: include_graph_db", "[scanner]")
+{
+  const auto dir = std::filesystem::temp_directory_path() / "lwyi_include_graph_db_test";
+  std::filesystem::create_directories(dir);
+
+  scanner::Include_graph_record record{
+    {dir, dir / "private.cpp", {"clang", "private.cpp"}}, 0, make_graph(dir)};
+  for (const auto& file : record.graph.files)
+  {
+    std::ofstream(file) << "\n";
+  }
+  std::filesystem::create_directories(dir / "include");
+  record.graph.directories = {dir / "include", dir / "missing"};
+  record.scan_time = scanner::current_file_time();
+  const auto& compile_command = record.compile_command;
+
+  scanner::Include_graph_db db;
+  db.update(record);
+
+  SECTION("save and load")
+  {
+    const auto path = dir / "include_graphs.db";
+    REQUIRE(db.save(path).has_value());
+    auto loaded = scanner::Include_graph_db::load(path);
+    REQUIRE(loaded.has_value());
+
+    CHECK(loaded->include_index().affected_sources({dir / "b.hpp"}) ==
+          std::set<std::filesystem::path>{dir / "private.cpp"});
+
+    scanner::File_time_cache file_times;
+    const auto* graph = loaded->find_current(compile_command, file_times);
+    REQUIRE(graph);
+    CHECK(graph->files == record.graph.files);
+    CHECK(graph->directories == record.graph.directories);
+    REQUIRE(graph->events.size() == record.graph.events.size());
+    for (size_t i = 0; i < graph->events.size(); ++i)
+    {
+      CHECK(graph->events[i].kind == record.graph.events[i].kind);
+      CHECK(graph->events[i].file == record.graph.events[i].file);
+      CHECK(graph->events[i].line == record.graph.events[i].line);
+    }
+  }
+
+  SECTION("a corrupt file is rejected")
+  {
+    const auto path = dir / "corrupt.db";
+    std::ofstream(path) << "not an include graph";
+    CHECK(!scanner::Include_graph_db::load(path).has_value());
+  }
+
+  SECTION("graphs are only current for the same command and unmodified files")
+  {
+    scanner::File_time_cache file_times;
+    CHECK(db.find_current(compile_command, file_times));
+
+    auto other_command = compile_command;
+    other_command.command.emplace_back("-DFOO");
+    CHECK(!db.find_current(other_command, file_times));
+
+    // a file modified in the same tick as the scan is considered modified
+    record.scan_time = *file_times.modification_time(dir / "b.hpp");
+    db.update(record);
+    CHECK(!db.find_current(compile_command, file_times));
+
+    record.scan_time = scanner::current_file_time();
+    record.graph.files.push_back(dir / "missing.hpp");
+    db.update(record);
+    CHECK(!db.find_current(compile_command, file_times));
+  }
+
+  SECTION("graphs are not current once a header is added to a searched directory")
+  {
+    scanner::File_time_cache file_times;
+    CHECK(db.find_current(compile_command, file_times));
+
+    // the new header may shadow b.hpp, and the directory is modified in the same tick as the
+    // scan at the latest
+    std::ofstream(dir / "include" / "b.hpp") << "\n";
+    std::filesystem::last_write_time(
+      dir / "include",
+      std::filesystem::file_time_type(std::filesystem::file_time_type::duration(record.scan_time)));
+    scanner::File_time_cache new_file_times;
+    CHECK(!db.find_current(compile_command, new_file_times));
+  }
+
+  SECTION("graphs that read a changed file are invalidated")
+  {
+    scanner::File_time_cache file_times;
+    db.invalidate({dir / "unrelated" / "a.hpp"});
+    CHECK(db.find_current(compile_command, file_times));
+    db.invalidate({dir / "include" / "a.hpp"});
+    CHECK(db.empty());
+
+    db.update(record);
+    db.invalidate({dir / "a.hpp"});
+    CHECK(!db.find_current(compile_command, file_times));
+    CHECK(db.empty());
+  }
+
+  SECTION("scan durations outlive invalidated graphs")
+  {
+    CHECK(!db.scan_duration(compile_command.source).has_value());
+    record.scan_duration = std::chrono::milliseconds(1234);
+    db.update(record);
+    db.invalidate({dir / "a.hpp"});
+    CHECK(db.empty());
+
+    const auto path = dir / "include_graphs.db";
+    REQUIRE(db.save(path).has_value());
+    auto loaded = scanner::Include_graph_db::load(path);
+    REQUIRE(loaded.has_value());
+    CHECK(loaded->scan_duration(compile_command.source) == std::chrono::milliseconds(1234));
+    CHECK(!loaded->scan_duration(dir / "other.cpp").has_value());
+  }
+
+  std::filesystem::remove_all(dir);
+}
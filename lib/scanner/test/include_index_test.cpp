@@ -0,0 +1,76 @@
+// Copyright (c) 2025 Environmental Systems Research Institute, Inc.
+// SPDX-License-Identifier: Apache-2.0
+
+#include <scanner/include_index.hpp>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <filesystem>
+#include <set>
+#include <vector>
+
+TEST_CASE("scanner: include_index", "[scanner]")
+{
+  GIVEN("an include index with a few translation units")
+  {
+    scanner::Include_index index;
+    index.update("/src/a.cpp", {"/src/a.cpp", "/include/a.hpp", "/include/common.hpp"});
+    index.update("/src/b.cpp", {"/src/b.cpp", "/include/b.hpp", "/include/common.hpp"});
+    index.update("/src/c.cpp", {"/src/c.cpp"});
+
+    WHEN("a header used by one translation unit is changed")
+    {
+      auto sources = index.affected_sources({"/include/a.hpp"});
+
+      THEN("only that translation unit is affected")
+      {
+        CHECK(sources == std::set<std::filesystem::path>{"/src/a.cpp"});
+      }
+    }
+
+    WHEN("a header used by several translation units is changed")
+    {
+      auto sources = index.affected_sources({"/include/common.hpp"});
+
+      THEN("all of them are affected")
+      {
+        CHECK(sources == std::set<std::filesystem::path>{"/src/a.cpp", "/src/b.cpp"});
+      }
+    }
+
+    WHEN("a source file is changed")
+    {
+      auto sources = index.affected_sources({"/src/c.cpp", "/unrelated.txt"});
+
+      THEN("the source file itself is affected")
+      {
+        CHECK(sources == std::set<std::filesystem::path>{"/src/c.cpp"});
+      }
+    }
+
+    WHEN("all files are requested")
+    {
+      auto files = index.files();
+
+      THEN("every file is listed once")
+      {
+        CHECK(files.size() == 6U);
+        CHECK(files.contains("/include/common.hpp"));
+      }
+    }
+
+    WHEN("a translation unit is updated")
+    {
+      index.update("/src/a.cpp", {"/src/a.cpp"});
+      auto sources = index.affected_sources({"/include/a.hpp"});
+
+      THEN("the old files are forgotten")
+      {
+        CHECK(sources.empty());
+        CHECK(index.affected_sources({"/include/common.hpp"}) ==
+              std::set<std::filesystem::path>{"/src/b.cpp"});
+        CHECK(index.files().size() == 5U);
+      }
+    }
+  }
+}
@@ -0,0 +1,117 @@
+// Copyright (c) 2025 Environmental Systems Research Institute, Inc.
+// SPDX-License-Identifier: Apache-2.0
+
+#include <src/memory_budget.hpp>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <optional>
+#include <stop_token>
+#include <thread>
+
+TEST_CASE("scanner: memory budget", "[scanner]")
+{
+  std::atomic<uint64_t> usage{100};
+  scanner::Memory_budget budget(1000,
+                                8U,
+                                [&]() -> std::optional<uint64_t>
+                                {
+                                  return usage.load();
+                                });
+  CHECK(budget.limit() == 1000U);
+
+  SECTION("a translation unit is let through even above the limit")
+  {
+    usage = 5000;
+    CHECK(budget.reserve().has_value());
+  }
+
+  SECTION("translation units are let through while they fit")
+  {
+    auto first = budget.reserve();
+    usage = 300;
+    // the first needs about 200, one more fits
+    auto second = budget.reserve();
+    usage = 800;
+    // each needs about 350, a third does not fit
+    std::atomic_bool third_started{false};
+    std::thread third(
+      [&]()
+      {
+        auto reservation = budget.reserve();
+        third_started = true;
+      });
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(200));
+    CHECK(!third_started);
+
+    {
+      auto released = std::move(second);
+    }
+    usage = 300;
+    third.join();
+    CHECK(third_started);
+  }
+
+  SECTION("without a measurement nothing is held back")
+  {
+    scanner::Memory_budget unmeasured(1,
+                                      1U,
+                                      []() -> std::optional<uint64_t>
+                                      {
+                                        return std::nullopt;
+                                      });
+    auto first = unmeasured.reserve();
+    auto second = unmeasured.reserve();
+    CHECK(second.has_value());
+  }
+
+  SECTION("a translation unit that has not grown yet needs the share of its thread")
+  {
+    scanner::Memory_budget shared(1000,
+                                  2U,
+                                  [&]() -> std::optional<uint64_t>
+                                  {
+                                    return usage.load();
+                                  });
+    usage = 600;
+    auto first = shared.reserve();
+    std::atomic_bool second_started{false};
+    std::thread second(
+      [&]()
+      {
+        auto reservation = shared.reserve();
+        second_started = true;
+      });
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(200));
+    CHECK(!second_started);
+
+    {
+      auto released = std::move(first);
+    }
+    second.join();
+    CHECK(second_started);
+  }
+
+  SECTION("a stop request ends the wait")
+  {
+    auto first = budget.reserve();
+    usage = 900;
+    std::stop_source stop_source;
+    std::atomic_bool reserved{true};
+    std::thread waiting(
+      [&]()
+      {
+        reserved = budget.reserve(stop_source.get_token()).has_value();
+      });
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    stop_source.request_stop();
+    waiting.join();
+    CHECK(!reserved);
+  }
+}
@@ -0,0 +1,69 @@
+// Copyright (c) 2025 Environmental Systems Research Institute, Inc.
+// SPDX-License-Identifier: Apache-2.0
+
+#include <src/merge_includes.hpp>
+
+#include <scanner/include.hpp>
+#include <src/scan_impl.hpp>
+#include <util/parallel_transformer.hpp>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <cstdint>
+#include <expected>
+#include <format>
+#include <string>
+#include <vector>
+
+namespace
+{
+// Every translation unit includes the same headers and a header of its own, the line tells
+// which of them recorded an include
+std::vector<std::expected<scanner::Include_data, std::string>> include_data_array(size_t count)
+{
+  std::vector<std::expected<scanner::Include_data, std::string>> array;
+  for (size_t i = 0; i < count; ++i)
+  {
+    const auto source = std::format("/src/{}.cpp", i);
+    const std::vector<scanner::Source_line> chain{{source, static_cast<uint32_t>(i)}};
+    scanner::Include_data include_data;
+    include_data.includes.insert({"/include/common.hpp", chain});
+    include_data.includes.insert({std::format("/include/{}.hpp", i), chain});
+    include_data.interface_header_includes["/include/a.hpp"].insert({"/include/b.hpp", chain});
+    array.emplace_back(std::move(include_data));
+  }
+  return array;
+}
+} // namespace
+
+TEST_CASE("scanner: merge_includes on threads", "[scanner]")
+{
+  constexpr size_t count = 100;
+  util::Parallel_transformer pool(4);
+
+  SECTION("keeps the includes of the first translation unit")
+  {
+    auto output = scanner::merge_includes(pool, include_data_array(count));
+    REQUIRE(output.has_value());
+    CHECK(output->includes.size() == count + 1);
+    CHECK(output->includes.front().path == "/include/0.hpp");
+    CHECK(output->includes.back().path == "/include/common.hpp");
+    CHECK(output->includes.back().include_chain.front().line == 0U);
+    REQUIRE(output->interface_includes.size() == 1U);
+    CHECK(output->interface_includes.front().include_chain.front().line == 0U);
+
+    auto serial_output = scanner::merge_includes(include_data_array(count));
+    REQUIRE(serial_output.has_value());
+    CHECK(serial_output->includes.size() == output->includes.size());
+  }
+
+  SECTION("reports the first error")
+  {
+    auto array = include_data_array(count);
+    array[40] = std::unexpected(std::string("error 40"));
+    array[70] = std::unexpected(std::string("error 70"));
+    auto output = scanner::merge_includes(pool, std::move(array));
+    REQUIRE(!output.has_value());
+    CHECK(output.error() == "error 40");
+  }
+}
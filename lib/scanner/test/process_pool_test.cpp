@@ -0,0 +1,112 @@
+// Copyright (c) 2025 Environmental Systems Research Institute, Inc.
+// SPDX-License-Identifier: Apache-2.0
+
+#include <src/process_pool.hpp>
+
+#include <src/scan_impl.hpp>
+#include <src/scan_protocol.hpp>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <chrono>
+#include <cstddef>
+#include <filesystem>
+#include <format>
+#include <string>
+#include <vector>
+
+#ifndef _WIN32
+#include <unistd.h>
+#endif
+
+#ifndef _WIN32
+TEST_CASE("scanner: process pool", "[scanner]")
+{
+  std::vector<scanner::Compile_command> compile_commands;
+  for (int i = 0; i < 100; ++i)
+  {
+    const auto source = i == 10 ? std::string("crash.cpp")
+                                : (i == 20 ? std::string("error.cpp") : std::format("{}.cpp", i));
+    compile_commands.push_back({"/build", "/src/" + source, {"clang", source}});
+  }
+  std::vector<const scanner::Compile_command*> compile_command_ptrs;
+  for (const auto& compile_command : compile_commands)
+  {
+    compile_command_ptrs.push_back(&compile_command);
+  }
+
+  // see scan_process_test_main.cpp
+  scanner::Process_pool pool(3U, {LWYI_TEST_SCAN_PROCESS});
+  CHECK(pool.process_count() == 3U);
+
+  SECTION("crashes")
+  {
+    const auto results = pool.record(compile_command_ptrs, {}, false);
+    REQUIRE(results.size() == compile_commands.size());
+    for (size_t i = 0; i < results.size(); ++i)
+    {
+      INFO(compile_commands[i].source.string());
+      REQUIRE(results[i].has_value());
+      const auto& result = results[i]->graph;
+      if (i == 10)
+      {
+        REQUIRE(!result.has_value());
+        CHECK(result.error().starts_with("/src/crash.cpp: the preprocessor crashed with signal"));
+        continue;
+      }
+      if (i == 20)
+      {
+        REQUIRE(!result.has_value());
+        CHECK(result.error() == "file not found");
+        continue;
+      }
+      REQUIRE(result.has_value());
+      REQUIRE(result->files.size() == 2U);
+      CHECK(result->files[0] == compile_commands[i].source);
+      CHECK(result->files[1] != std::to_string(::getpid()));
+    }
+
+    // the pool keeps working after a crash
+    const auto more_results = pool.record(std::vector{compile_command_ptrs[0]}, {}, false);
+    REQUIRE(more_results.size() == 1U);
+    REQUIRE(more_results[0].has_value());
+    CHECK(more_results[0]->graph.has_value());
+  }
+
+  SECTION("stop on failure")
+  {
+    const auto results = pool.record(compile_command_ptrs, {}, true);
+    REQUIRE(results.size() == compile_commands.size());
+    REQUIRE(results[10].has_value());
+    CHECK(!results[10]->graph.has_value());
+    CHECK(!results.back().has_value());
+  }
+
+  SECTION("time limit")
+  {
+    const scanner::Compile_command hang{"/build", "/src/hang.cpp", {"clang", "hang.cpp"}};
+    const std::vector compile_commands_with_hang{&hang, compile_command_ptrs[0]};
+    const auto results =
+      pool.record(compile_commands_with_hang, std::chrono::milliseconds(200), false);
+    REQUIRE(results.size() == 2U);
+    REQUIRE(results[0].has_value());
+    REQUIRE(!results[0]->graph.has_value());
+    CHECK(results[0]->graph.error() == "Preprocessing /src/hang.cpp timed out.\n");
+    CHECK(results[0]->duration >= std::chrono::milliseconds(200));
+    REQUIRE(results[1].has_value());
+    CHECK(results[1]->graph.has_value());
+  }
+
+  SECTION("processes that cannot be started")
+  {
+    const auto missing = std::filesystem::temp_directory_path() / "lwyi_missing_scan_process";
+    scanner::Process_pool missing_pool(1U, {missing.string()});
+    const auto results = missing_pool.record(std::vector{compile_command_ptrs[0]}, {}, false);
+    REQUIRE(results.size() == 1U);
+    REQUIRE(results[0].has_value());
+    REQUIRE(!results[0]->graph.has_value());
+    CHECK(results[0]->graph.error().starts_with("error: failed to start a scan process"));
+    CHECK(results[0]->duration < std::chrono::seconds(1));
+  }
+}
+#endif
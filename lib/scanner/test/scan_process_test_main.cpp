@@ -0,0 +1,50 @@
+// Copyright (c) 2025 Environmental Systems Research Institute, Inc.
+// SPDX-License-Identifier: Apache-2.0
+
+// The scan process started by the process pool test, with a recorder that records the id of the
+// process as the only file and crashes, hangs or fails on request
+
+#include <src/include_graph.hpp>
+#include <src/process_pool.hpp>
+#include <src/scan_impl.hpp>
+#include <src/scan_protocol.hpp>
+
+#include <chrono>
+#include <cstdlib>
+#include <expected>
+#include <string>
+#include <thread>
+
+#ifndef _WIN32
+#include <unistd.h>
+#endif
+
+int main()
+{
+#ifndef _WIN32
+  scanner::serve_process_pool(
+    scanner::pool_connection_fd,
+    [](const scanner::Compile_command& compile_command) -> scanner::Graph_result
+    {
+      if (compile_command.source.filename() == "crash.cpp")
+      {
+        std::abort();
+      }
+      if (compile_command.source.filename() == "hang.cpp")
+      {
+        std::this_thread::sleep_for(std::chrono::hours(1));
+      }
+      if (compile_command.source.filename() == "error.cpp")
+      {
+        return std::unexpected(std::string("file not found"));
+      }
+      scanner::Include_graph_builder builder;
+      const auto file = builder.file_id(compile_command.source);
+      const auto process = builder.file_id(std::to_string(::getpid()));
+      builder.add_event({scanner::Include_event_kind::enter_file, 1U, 0U, file, 0U});
+      builder.add_event({scanner::Include_event_kind::enter_file, 0U, 0U, process, 0U});
+      return builder.take();
+    });
+#endif
+  return EXIT_SUCCESS;
+}
@@ -14,6 +14,11 @@
 #include <utility>
 #include <vector>
 
+namespace util
+{
+class Parallel_transformer;
+} // namespace util
+
 namespace target_model
 {
 class Target_model
@@ -23,6 +28,10 @@ public:
 
   std::string validate() const;
 
+  // Compares the include directories on the threads of the pool, reports the same error as
+  // validate()
+  std::string validate(util::Parallel_transformer& pool) const;
+
   std::optional<std::reference_wrapper<const Target_data>> get_target_data(
     const Target& target) const;
 
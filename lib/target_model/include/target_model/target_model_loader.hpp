@@ -3,6 +3,7 @@
 
 #pragma once
 
+#include <cstddef>
 #include <expected>
 #include <filesystem>
 #include <string>
@@ -14,7 +15,8 @@ class Target_model;
 class Target_model_loader
 {
 public:
-  static std::unique_ptr<Target_model_loader> create();
+  // The targets are converted on thread_count threads, in the calling thread for zero
+  static std::unique_ptr<Target_model_loader> create(size_t thread_count = 0);
 
   virtual ~Target_model_loader() = default;
 
@@ -5,10 +5,13 @@
 
 #include <target_model/target.hpp>
 #include <target_model/target_data.hpp>
+#include <util/parallel.hpp>
+#include <util/parallel_transformer.hpp>
 #include <util/utils.hpp>
 
 #include <algorithm>
 #include <cassert>
+#include <cstddef>
 #include <filesystem>
 #include <format>
 #include <functional>
@@ -98,6 +101,12 @@ Target_model::Target_model(std::vector<std::pair<Target, Target_data>> target_to
 }
 
 std::string Target_model::validate() const
+{
+  util::Parallel_transformer pool(0);
+  return validate(pool);
+}
+
+std::string Target_model::validate(util::Parallel_transformer& pool) const
 {
   // look for duplicate targets
   if (auto it = std::ranges::adjacent_find(target_to_target_data_, Comp{});
@@ -108,9 +117,9 @@ std::string Target_model::validate() const
 
   // check directory_to_target
   // - a directory of one target, cannot be a subdirectory of another.
-
-  for (const auto& pair : directory_to_target_)
+  const auto conflict = [&](size_t i) -> std::string
   {
+    const auto& pair = directory_to_target_[i];
     const auto& directory = pair.first;
     const auto& target = pair.second->first;
 
@@ -151,9 +160,18 @@ std::string Target_model::validate() const
         }
       }
     }
-  }
-
-  return {};
+    return {};
+  };
+
+  // every directory is compared with all others, the first conflict in their order is reported
+  return util::parallel_reduce(pool,
+                               directory_to_target_.size(),
+                               std::string(),
+                               conflict,
+                               [](std::string lhs, std::string rhs)
+                               {
+                                 return lhs.empty() ? std::move(rhs) : std::move(lhs);
+                               });
 }
 
 std::optional<std::reference_wrapper<const Target_data>> Target_model::get_target_data(
@@ -9,6 +9,7 @@
 #include <target_model/target_data.hpp>
 #include <target_model/target_model.hpp>
 #include <target_model/target_model_loader.hpp>
+#include <util/parallel.hpp>
 
 #include <simdjson.h>
 
@@ -140,6 +141,44 @@ std::expected<std::vector<std::pair<Target, Raw_data>>, std::string> parse_(
   return target_to_raw_data;
 }
 
+Target_data to_target_data_(const Raw_data& raw_data)
+{
+  Target_data target_data;
+
+  auto& interface_include_directories = raw_data[lookup("interface_include_directories")];
+  auto& interface_include_prefixes = raw_data[lookup("interface_include_prefixes")];
+  auto& interface_headers = raw_data[lookup("interface_headers")];
+  auto& interface_dependencies = raw_data[lookup("interface_dependencies")];
+  auto& dependencies = raw_data[lookup("dependencies")];
+  auto& sources = raw_data[lookup("sources")];
+  auto& headers = raw_data[lookup("headers")];
+  auto& verify_interface_header_sets_sources =
+    raw_data[lookup("verify_interface_header_sets_sources")];
+
+  target_data.interface_include_directories.insert(interface_include_directories.begin(),
+                                                   interface_include_directories.end());
+  for (const auto& interface_include_prefix : interface_include_prefixes)
+  {
+    target_data.interface_include_prefixes.insert(std::string(interface_include_prefix));
+  }
+  target_data.interface_headers.insert(interface_headers.begin(), interface_headers.end());
+  for (const auto& interface_dependency : interface_dependencies)
+  {
+    target_data.interface_dependencies.insert(Target{std::string(interface_dependency)});
+  }
+  for (const auto& dependency : dependencies)
+  {
+    target_data.dependencies.insert(Target{std::string(dependency)});
+  }
+
+  target_data.sources.insert(sources.begin(), sources.end());
+  target_data.headers.insert(headers.begin(), headers.end());
+  target_data.verify_interface_header_sets_sources.insert(
+    verify_interface_header_sets_sources.begin(),
+    verify_interface_header_sets_sources.end());
+  return target_data;
+}
+
 std::string location_(const simdjson::ondemand::document& doc, const char* data, size_t data_size)
 {
   const char* location = nullptr;
@@ -159,13 +198,16 @@ std::string location_(const simdjson::ondemand::document& doc, const char* data,
 
 } // namespace
 
-std::unique_ptr<Target_model_loader> Target_model_loader::create()
+std::unique_ptr<Target_model_loader> Target_model_loader::create(size_t thread_count)
 {
-  return std::make_unique<Target_model_loader_impl>(std::make_unique<Real_file_loader>());
+  return std::make_unique<Target_model_loader_impl>(std::make_unique<Real_file_loader>(),
+                                                    thread_count);
 }
 
-Target_model_loader_impl::Target_model_loader_impl(std::unique_ptr<File_loader> file_loader)
-: file_loader_(std::move(file_loader))
+Target_model_loader_impl::Target_model_loader_impl(std::unique_ptr<File_loader> file_loader,
+                                                   size_t thread_count)
+: file_loader_(std::move(file_loader)),
+  pool_(thread_count)
 {
 }
 
@@ -193,43 +235,18 @@ std::expected<void, std::string> Target_model_loader_impl::load_json(
                   target_to_raw_data.error()));
   }
 
-  for (const auto& [target, raw_data] : target_to_raw_data.value())
-  {
-    Target_data target_data;
-
-    auto& interface_include_directories = raw_data[lookup("interface_include_directories")];
-    auto& interface_include_prefixes = raw_data[lookup("interface_include_prefixes")];
-    auto& interface_headers = raw_data[lookup("interface_headers")];
-    auto& interface_dependencies = raw_data[lookup("interface_dependencies")];
-    auto& dependencies = raw_data[lookup("dependencies")];
-    auto& sources = raw_data[lookup("sources")];
-    auto& headers = raw_data[lookup("headers")];
-    auto& verify_interface_header_sets_sources =
-      raw_data[lookup("verify_interface_header_sets_sources")];
-
-    target_data.interface_include_directories.insert(interface_include_directories.begin(),
-                                                     interface_include_directories.end());
-    for (const auto& interface_include_prefix : interface_include_prefixes)
-    {
-      target_data.interface_include_prefixes.insert(std::string(interface_include_prefix));
-    }
-    target_data.interface_headers.insert(interface_headers.begin(), interface_headers.end());
-    for (const auto& interface_dependency : interface_dependencies)
-    {
-      target_data.interface_dependencies.insert(Target{std::string(interface_dependency)});
-    }
-    for (const auto& dependency : dependencies)
-    {
-      target_data.dependencies.insert(Target{std::string(dependency)});
-    }
-
-    target_data.sources.insert(sources.begin(), sources.end());
-    target_data.headers.insert(headers.begin(), headers.end());
-    target_data.verify_interface_header_sets_sources.insert(
-      verify_interface_header_sets_sources.begin(),
-      verify_interface_header_sets_sources.end());
-    target_to_target_data_.emplace_back(target, target_data);
-  }
+  // the on-demand parser walks the document in order, the targets it found are independent
+  auto& raw_targets = target_to_raw_data.value();
+  const auto first = target_to_target_data_.size();
+  target_to_target_data_.resize(first + raw_targets.size());
+  util::parallel_for(pool_,
+                     raw_targets.size(),
+                     [&](size_t i)
+                     {
+                       auto& [target, raw_data] = raw_targets[i];
+                       target_to_target_data_[first + i] = {std::move(target),
+                                                            to_target_data_(raw_data)};
+                     });
 
   return {};
 }
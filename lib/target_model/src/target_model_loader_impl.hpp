@@ -7,9 +7,11 @@
 #include <target_model/target.hpp>
 #include <target_model/target_data.hpp>
 #include <target_model/target_model_loader.hpp>
+#include <util/parallel_transformer.hpp>
 
 #include <simdjson.h>
 
+#include <cstddef>
 #include <expected>
 #include <filesystem>
 #include <memory>
@@ -25,7 +27,8 @@ class Target_model;
 class Target_model_loader_impl : public Target_model_loader
 {
 public:
-  explicit Target_model_loader_impl(std::unique_ptr<File_loader> file_loader);
+  explicit Target_model_loader_impl(std::unique_ptr<File_loader> file_loader,
+                                    size_t thread_count = 0);
 
   std::expected<void, std::string> load_json(const std::filesystem::path& path) override;
 
@@ -34,6 +37,7 @@ public:
 private:
   std::unique_ptr<File_loader> file_loader_;
   simdjson::ondemand::parser parser_;
+  util::Parallel_transformer pool_;
   std::vector<std::pair<Target, Target_data>> target_to_target_data_;
 };
 
@@ -8,12 +8,15 @@
 #include <target_model/target_data.hpp>
 #include <target_model/target_model.hpp>
 
+#include <catch2/catch_message.hpp>
 #include <catch2/catch_test_macros.hpp>
 #include <simdjson.h>
 
+#include <cstddef>
 #include <cstring>
 #include <expected>
 #include <filesystem>
+#include <format>
 #include <functional>
 #include <memory>
 #include <optional>
@@ -192,3 +195,36 @@ TEST_CASE("target_model: target_model_loader_impl will fail to load an invalid j
   std::regex message_regex("error.*: line \\d+, column \\d+: ");
   CHECK(std::regex_search(result.error(), message_regex));
 }
+
+TEST_CASE("target_model: target_model_loader_impl converts the targets on threads",
+          "[target_model]")
+{
+  constexpr size_t count = 200;
+  std::string json = "{";
+  for (size_t i = 0; i < count; ++i)
+  {
+    json += std::format(R"({}"lib{}": {{"interface_headers": ["/src/lib{}/a.h"], )"
+                        R"("dependencies": [{}]}})",
+                        i == 0 ? "" : ",",
+                        i,
+                        i,
+                        i == 0 ? "" : std::format(R"("lib{}")", i - 1));
+  }
+  json += "}";
+
+  auto file_loader = std::make_unique<Test_file_loader>(json.c_str());
+  target_model::Target_model_loader_impl target_model_loader(std::move(file_loader), 4);
+  REQUIRE(target_model_loader.load_json("/some/file.json").has_value());
+  auto target_model = target_model_loader.make_target_model();
+
+  for (size_t i = 1; i < count; ++i)
+  {
+    INFO(i);
+    const target_model::Target target{std::format("lib{}", i)};
+    auto data = target_model.get_target_data(target);
+    REQUIRE(data.has_value());
+    CHECK(data->get().dependencies ==
+          std::unordered_set<target_model::Target>{{std::format("lib{}", i - 1)}});
+    CHECK(target_model.map_header_to_target(std::format("/src/lib{}/a.h", i)) == target);
+  }
+}
@@ -0,0 +1,64 @@
+// Copyright (c) 2025 Environmental Systems Research Institute, Inc.
+// SPDX-License-Identifier: Apache-2.0
+
+#include <target_model/target_model.hpp>
+
+#include <target_model/target.hpp>
+#include <target_model/target_data.hpp>
+#include <util/parallel_transformer.hpp>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <cstddef>
+#include <format>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace
+{
+// Targets with include directories of their own, apart from the conflicts added by the tests
+std::vector<std::pair<target_model::Target, target_model::Target_data>> targets(size_t count)
+{
+  std::vector<std::pair<target_model::Target, target_model::Target_data>> targets;
+  for (size_t i = 0; i < count; ++i)
+  {
+    target_model::Target_data target_data;
+    target_data.interface_include_directories.insert(std::format("/src/lib{}/include", i));
+    targets.emplace_back(target_model::Target{std::format("lib{:03}", i)}, target_data);
+  }
+  return targets;
+}
+} // namespace
+
+TEST_CASE("target_model: validate on threads", "[target_model]")
+{
+  constexpr size_t count = 300;
+  util::Parallel_transformer pool(4);
+
+  SECTION("no conflict")
+  {
+    const target_model::Target_model target_model(targets(count));
+    CHECK(target_model.validate(pool).empty());
+  }
+
+  SECTION("the first conflicting directory is reported")
+  {
+    auto target_to_target_data = targets(count);
+    target_to_target_data[100].second.interface_include_directories.insert("/src");
+    target_to_target_data[200].second.interface_include_directories.insert("/src/lib7");
+    const target_model::Target_model target_model(std::move(target_to_target_data));
+
+    const auto error = target_model.validate(pool);
+    CHECK(error.starts_with("lib100 and lib000 have a conflicting include directory (/src)"));
+    CHECK(error == target_model.validate());
+  }
+
+  SECTION("repeated targets")
+  {
+    auto target_to_target_data = targets(count);
+    target_to_target_data.push_back(target_to_target_data.front());
+    const target_model::Target_model target_model(std::move(target_to_target_data));
+    CHECK(target_model.validate(pool) == "Target lib000 is repeated.\n");
+  }
+}
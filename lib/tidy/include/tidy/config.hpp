@@ -7,13 +7,28 @@
 
 #include <map>
 #include <set>
+#include <string>
 #include <vector>
 
 namespace tidy
 {
+// The targets matching the pattern from must not depend on the targets matching the pattern to.
+// In patterns, '*' matches any number of characters and '?' any single character.
+struct Layer_rule
+{
+  std::string from;
+  std::string to;
+
+  auto operator<=>(const Layer_rule&) const = default;
+};
+
 struct Config
 {
   std::map<target_model::Target, std::set<target_model::Target>> forbidden_dependencies;
+  // forbid reaching the forbidden dependencies through other targets as well
+  bool transitive{false};
+  // checked against the direct dependencies only
+  std::vector<Layer_rule> forbidden_layer_dependencies;
   std::vector<std::set<target_model::Target>> allowed_clusters;
 };
 } // namespace tidy
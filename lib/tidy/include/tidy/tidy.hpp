@@ -6,6 +6,9 @@
 #include <target_model/target.hpp>
 
 #include <cstdint>
+#include <expected>
+#include <string>
+#include <string_view>
 #include <vector>
 
 namespace target_model
@@ -25,12 +28,41 @@ enum class Dag_diagnostic_type : uint8_t
   forbidden_dependency
 };
 
+// A forbidden_dependency lists the target and the forbidden dependency, with the targets of the
+// shortest path between them in between when the dependency is transitive
 struct Dag_diagnostic
 {
   Dag_diagnostic_type type;
   std::vector<target_model::Target> targets;
 };
 
+// A dependency added to or removed from a target, to see what tidy would report
+struct Dependency_edit
+{
+  enum class Kind : uint8_t
+  {
+    add,
+    remove,
+  };
+
+  Kind kind{Kind::add};
+  target_model::Target from;
+  target_model::Target to;
+
+  auto operator<=>(const Dependency_edit&) const = default;
+};
+
 std::vector<Dag_diagnostic> tidy(const Config& config,
                                  const target_model::Target_model& target_model);
+
+// Parse a comma separated list of add:A->B and remove:A->B
+std::expected<std::vector<Dependency_edit>, std::string> parse_dependency_edits(
+  std::string_view text);
+
+// The diagnostics of tidy for the model with the dependencies edited. The strongly connected
+// components of the model are updated for the edits instead of searched again.
+std::expected<std::vector<Dag_diagnostic>, std::string> tidy_what_if(
+  const Config& config,
+  const target_model::Target_model& target_model,
+  const std::vector<Dependency_edit>& edits);
 } // namespace tidy
@@ -10,52 +10,94 @@
 #include <cstdint>
 #include <iterator>
 #include <limits>
-#include <numeric>
 #include <set>
+#include <unordered_map>
 #include <vector>
 
 namespace tidy
 {
 namespace
 {
-size_t intersection_size(const std::set<target_model::Target>* lhs,
-                         const std::set<target_model::Target>* rhs)
+// The column assigned to each row of the square matrix of weights so that the sum of their
+// weights is the largest. This is the Hungarian algorithm with potentials, it takes O(n^3).
+std::vector<size_t> max_weight_assignment(const std::vector<int32_t>& weights, size_t size)
 {
-  if (lhs && !rhs)
-  {
-    return lhs->size();
-  }
-  if (!lhs && rhs)
+  // minimize the negated weights. Rows and columns are 1-based, row 0 is the one being added.
+  constexpr int64_t infinity = std::numeric_limits<int64_t>::max();
+  const auto cost = [&](size_t row, size_t column) -> int64_t
   {
-    return rhs->size();
-  }
-  if (!lhs && !rhs)
-  {
-    return 0;
-  }
+    return -int64_t{weights[(row - 1) * size + column - 1]};
+  };
 
-  auto first1 = lhs->begin();
-  auto first2 = rhs->begin();
-  auto last1 = lhs->end();
-  auto last2 = rhs->end();
-  size_t count = 0;
-  while (first1 != last1 && first2 != last2)
+  std::vector<int64_t> row_potential(size + 1);
+  std::vector<int64_t> column_potential(size + 1);
+  std::vector<size_t> row_of_column(size + 1);
+  std::vector<size_t> previous_column(size + 1);
+  std::vector<int64_t> min_slack(size + 1);
+  std::vector<char> visited(size + 1);
+  for (size_t row = 1; row <= size; ++row)
   {
-    if (*first1 < *first2)
+    // find an augmenting path from the new row to a free column
+    row_of_column[0] = row;
+    size_t column = 0;
+    std::ranges::fill(min_slack, infinity);
+    std::ranges::fill(visited, 0);
+    do // NOLINT(cppcoreguidelines-avoid-do-while)
     {
-      ++first1;
-    }
-    else
-    {
-      if (!(*first2 < *first1))
+      visited[column] = 1;
+      const size_t current_row = row_of_column[column];
+      int64_t delta = infinity;
+      size_t next_column = 0;
+      for (size_t j = 1; j <= size; ++j)
+      {
+        if (visited[j])
+        {
+          continue;
+        }
+        const int64_t slack = cost(current_row, j) - row_potential[current_row] -
+                              column_potential[j];
+        if (slack < min_slack[j])
+        {
+          min_slack[j] = slack;
+          previous_column[j] = column;
+        }
+        if (min_slack[j] < delta)
+        {
+          delta = min_slack[j];
+          next_column = j;
+        }
+      }
+      for (size_t j = 0; j <= size; ++j)
       {
-        first1++;
-        ++count;
+        if (visited[j])
+        {
+          row_potential[row_of_column[j]] += delta;
+          column_potential[j] -= delta;
+        }
+        else
+        {
+          min_slack[j] -= delta;
+        }
       }
-      ++first2;
+      column = next_column;
+    }
+    while (row_of_column[column] != 0);
+
+    // flip the path
+    while (column != 0)
+    {
+      const size_t previous = previous_column[column];
+      row_of_column[column] = row_of_column[previous];
+      column = previous;
     }
   }
-  return count;
+
+  std::vector<size_t> column_of_row(size);
+  for (size_t column = 1; column <= size; ++column)
+  {
+    column_of_row[row_of_column[column] - 1] = column - 1;
+  }
+  return column_of_row;
 }
 
 Cluster_diff single_diff(const std::set<target_model::Target>* lhs,
@@ -103,42 +145,55 @@ std::vector<Cluster_diff> cluster_diff(const std::vector<std::set<target_model::
     return nullptr;
   };
 
-  std::vector<int16_t> intersection_matrix(result_size * result_size);
-  for (size_t i = 0; i < result_size; ++i)
+  // a cluster matched with a missing one weighs as much as its size
+  std::vector<int32_t> weights(result_size * result_size);
+  for (size_t i = lhs.size(); i < result_size; ++i)
   {
-    for (size_t j = 0; j < result_size; ++j)
+    for (size_t j = 0; j < rhs.size(); ++j)
     {
-      const size_t size = intersection_size(view_lhs(i), view_rhs(j));
-      intersection_matrix[i * result_size + j] = static_cast<int16_t>(
-        std::min(size, static_cast<size_t>(std::numeric_limits<int16_t>::max())));
+      weights[i * result_size + j] = static_cast<int32_t>(rhs[j].size());
+    }
+  }
+  for (size_t i = 0; i < lhs.size(); ++i)
+  {
+    for (size_t j = rhs.size(); j < result_size; ++j)
+    {
+      weights[i * result_size + j] = static_cast<int32_t>(lhs[i].size());
     }
   }
 
-  std::vector<size_t> permutation(result_size);
-  std::ranges::iota(permutation, 0);
-
-  int32_t max_score = -1;
-  std::vector<size_t> max_permutation;
-  do // NOLINT(cppcoreguidelines-avoid-do-while)
+  // count the intersections through the clusters of each target instead of intersecting every
+  // pair of clusters
+  std::unordered_map<target_model::Target, std::vector<size_t>> rhs_clusters;
+  for (size_t j = 0; j < rhs.size(); ++j)
   {
-    int32_t score = 0;
-    for (size_t i = 0; i < permutation.size(); ++i)
+    for (const auto& target : rhs[j])
     {
-      const size_t j = permutation[i];
-      score += intersection_matrix[i * result_size + j];
+      rhs_clusters[target].push_back(j);
     }
-    if (max_score < score)
+  }
+  for (size_t i = 0; i < lhs.size(); ++i)
+  {
+    for (const auto& target : lhs[i])
     {
-      max_score = score;
-      max_permutation = permutation;
+      const auto it = rhs_clusters.find(target);
+      if (it == rhs_clusters.end())
+      {
+        continue;
+      }
+      for (const size_t j : it->second)
+      {
+        ++weights[i * result_size + j];
+      }
     }
   }
-  while (std::ranges::next_permutation(permutation).found);
+
+  const auto assignment = max_weight_assignment(weights, result_size);
 
   std::vector<Cluster_diff> result(result_size);
   for (size_t i = 0; i < result_size; ++i)
   {
-    result[i] = single_diff(view_lhs(i), view_rhs(max_permutation[i]));
+    result[i] = single_diff(view_lhs(i), view_rhs(assignment[i]));
   }
 
   return result;
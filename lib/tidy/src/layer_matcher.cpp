@@ -0,0 +1,123 @@
+// Copyright (c) 2025 Environmental Systems Research Institute, Inc.
+// SPDX-License-Identifier: Apache-2.0
+
+#include <src/layer_matcher.hpp>
+
+#include <lwyi/target_graph.hpp>
+#include <tidy/config.hpp>
+#include <util/utils.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace tidy
+{
+Layer_matcher::Layer_matcher(const std::vector<Layer_rule>& rules,
+                             const lwyi::Target_graph& graph)
+{
+  std::unordered_map<std::string_view, uint32_t> pattern_ids;
+  const auto pattern_id = [&](std::string_view pattern)
+  {
+    return pattern_ids.try_emplace(pattern, static_cast<uint32_t>(pattern_ids.size()))
+      .first->second;
+  };
+  std::vector<std::pair<uint32_t, uint32_t>> rule_ids;
+  for (const auto& rule : rules)
+  {
+    const auto from = pattern_id(rule.from);
+    rule_ids.emplace_back(from, pattern_id(rule.to));
+  }
+
+  // patterns without wildcards are looked up by target name instead of matched
+  std::unordered_map<std::string_view, uint32_t> names;
+  std::vector<std::pair<std::string_view, uint32_t>> globs;
+  for (const auto& [pattern, id] : pattern_ids)
+  {
+    if (pattern.find_first_of("*?") == std::string_view::npos)
+    {
+      names.emplace(pattern, id);
+    }
+    else
+    {
+      globs.emplace_back(pattern, id);
+    }
+  }
+
+  std::map<std::vector<uint32_t>, uint32_t> layers;
+  layer_of_.reserve(graph.size());
+  for (uint32_t id = 0; id < graph.size(); ++id)
+  {
+    const auto& name = graph.target(id).name;
+    std::vector<uint32_t> matched;
+    if (const auto it = names.find(name); it != names.end())
+    {
+      matched.push_back(it->second);
+    }
+    for (const auto& [pattern, pattern_id] : globs)
+    {
+      if (util::glob_match(pattern, name))
+      {
+        matched.push_back(pattern_id);
+      }
+    }
+    std::ranges::sort(matched);
+
+    const auto [it, inserted] =
+      layers.try_emplace(std::move(matched), static_cast<uint32_t>(patterns_.size()));
+    if (inserted)
+    {
+      patterns_.push_back(it->first);
+    }
+    layer_of_.push_back(it->second);
+  }
+
+  std::vector<std::vector<uint32_t>> forbidden_by_pattern(pattern_ids.size());
+  for (const auto& [from, to] : rule_ids)
+  {
+    forbidden_by_pattern[from].push_back(to);
+  }
+  forbidden_patterns_.resize(patterns_.size());
+  for (size_t layer = 0; layer < patterns_.size(); ++layer)
+  {
+    auto& forbidden = forbidden_patterns_[layer];
+    for (const auto pattern : patterns_[layer])
+    {
+      forbidden.insert(forbidden.end(),
+                       forbidden_by_pattern[pattern].begin(),
+                       forbidden_by_pattern[pattern].end());
+    }
+    std::ranges::sort(forbidden);
+    forbidden.erase(std::ranges::unique(forbidden).begin(), forbidden.end());
+  }
+}
+
+bool Layer_matcher::forbidden(uint32_t from, uint32_t to) const
+{
+  const auto& forbidden = forbidden_patterns_[layer_of_[from]];
+  const auto& matched = patterns_[layer_of_[to]];
+  auto f = forbidden.begin();
+  auto m = matched.begin();
+  while (f != forbidden.end() && m != matched.end())
+  {
+    if (*f == *m)
+    {
+      return true;
+    }
+    if (*f < *m)
+    {
+      ++f;
+    }
+    else
+    {
+      ++m;
+    }
+  }
+  return false;
+}
+} // namespace tidy
@@ -0,0 +1,35 @@
+// Copyright (c) 2025 Environmental Systems Research Institute, Inc.
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+
+#include <tidy/config.hpp>
+
+#include <cstdint>
+#include <vector>
+
+namespace lwyi
+{
+class Target_graph;
+} // namespace lwyi
+
+namespace tidy
+{
+// The layer rules compiled for the targets of a graph. The targets that match the same patterns
+// form a layer, so the patterns are matched once per target and checking a dependency only
+// compares the layers of its ends.
+class Layer_matcher
+{
+public:
+  Layer_matcher(const std::vector<Layer_rule>& rules, const lwyi::Target_graph& graph);
+
+  bool forbidden(uint32_t from, uint32_t to) const;
+
+private:
+  std::vector<uint32_t> layer_of_;
+  // the sorted patterns matched by every layer
+  std::vector<std::vector<uint32_t>> patterns_;
+  // the sorted patterns every layer must not depend on
+  std::vector<std::vector<uint32_t>> forbidden_patterns_;
+};
+} // namespace tidy
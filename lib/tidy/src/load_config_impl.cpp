@@ -88,6 +88,52 @@ std::expected<Config, std::string> load_config_impl(const simdjson::padded_strin
     config.allowed_clusters.push_back(std::move(cluster));
   }
 
+  bool transitive = false;
+  if (auto error = doc["transitive"].get_bool().get(transitive))
+  {
+    if (error != simdjson::NO_SUCH_FIELD)
+    {
+      return std::unexpected(
+        std::format("Error parsing transitive: {}\n", simdjson::error_message(error)));
+    }
+  }
+  config.transitive = transitive;
+
+  simdjson::ondemand::array layer_rules_array;
+  if (auto error = doc["forbidden_layer_dependencies"].get_array().get(layer_rules_array))
+  {
+    if (error != simdjson::NO_SUCH_FIELD)
+    {
+      return std::unexpected(std::format("Error parsing forbidden_layer_dependencies: {}\n",
+                                         simdjson::error_message(error)));
+    }
+  }
+  else
+  {
+    for (auto rule_value : layer_rules_array)
+    {
+      simdjson::ondemand::object rule_object;
+      std::string_view from;
+      std::string_view to;
+      if (auto error = rule_value.get_object().get(rule_object))
+      {
+        return std::unexpected(std::format("Error parsing forbidden_layer_dependencies: {}\n",
+                                           simdjson::error_message(error)));
+      }
+      if (auto error = rule_object["from"].get_string().get(from))
+      {
+        return std::unexpected(std::format("Error parsing forbidden_layer_dependencies: {}\n",
+                                           simdjson::error_message(error)));
+      }
+      if (auto error = rule_object["to"].get_string().get(to))
+      {
+        return std::unexpected(std::format("Error parsing forbidden_layer_dependencies: {}\n",
+                                           simdjson::error_message(error)));
+      }
+      config.forbidden_layer_dependencies.push_back({std::string(from), std::string(to)});
+    }
+  }
+
   return config;
 }
 } // namespace tidy
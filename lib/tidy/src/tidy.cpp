@@ -3,31 +3,189 @@
 
 #include <tidy/tidy.hpp>
 
-#include <lwyi/strongly_connected_dependencies.hpp>
+#include <lwyi/incremental_components.hpp>
+#include <lwyi/reachability.hpp>
+#include <lwyi/target_graph.hpp>
 #include <src/cluster_diff.hpp>
+#include <src/layer_matcher.hpp>
 #include <target_model/target_data.hpp>
 #include <target_model/target_model.hpp>
 #include <tidy/config.hpp>
 
+#include <algorithm>
 #include <cassert>
 #include <cstddef>
+#include <cstdint>
+#include <expected>
+#include <format>
 #include <functional>
 #include <optional>
+#include <ranges>
+#include <set>
+#include <string>
+#include <string_view>
 #include <unordered_set>
+#include <utility>
 #include <vector>
 
 namespace tidy
 {
-std::vector<Dag_diagnostic> tidy(const Config& config,
-                                 const target_model::Target_model& target_model)
+namespace
+{
+// The dependencies that are checked and their strongly connected components. The graph has the
+// ids of the targets, its dependencies may be edited.
+struct Checked_graph
+{
+  const target_model::Target_model& target_model;
+  const lwyi::Target_graph& graph;
+  const lwyi::Digraph& dependencies;
+  // numbered so that the dependencies between components lead to a lower number
+  std::vector<uint32_t> component_of;
+  size_t component_count{0};
+};
+
+void check_direct_dependencies(const Config& config,
+                               const Checked_graph& checked,
+                               std::vector<Dag_diagnostic>& diagnostics)
+{
+  for (const auto& [target, forbidden_dependencies] : config.forbidden_dependencies)
+  {
+    const auto from = checked.graph.find(target);
+    if (!from || !checked.target_model.get_target_data(target).has_value())
+    {
+      continue;
+    }
+
+    const auto dependencies = checked.dependencies.successors(*from);
+    for (const auto& forbidden_dependency : forbidden_dependencies)
+    {
+      const auto to = checked.graph.find(forbidden_dependency);
+      if (to && std::ranges::find(dependencies, *to) != dependencies.end())
+      {
+        diagnostics.push_back(
+          {Dag_diagnostic_type::forbidden_dependency, {target, forbidden_dependency}});
+      }
+    }
+  }
+}
+
+void check_transitive_dependencies(const Config& config,
+                                   const Checked_graph& checked,
+                                   std::vector<Dag_diagnostic>& diagnostics)
+{
+  if (config.forbidden_dependencies.empty())
+  {
+    return;
+  }
+
+  // Whether a target reaches another is looked up in the closure of the condensation. Targets
+  // of the same component reach each other, unless the component is a single target.
+  const auto& dependencies = checked.dependencies;
+  const auto& component_of = checked.component_of;
+  std::vector<std::pair<uint32_t, uint32_t>> component_edges;
+  for (uint32_t from = 0; from < dependencies.vertex_count(); ++from)
+  {
+    for (const auto to : dependencies.successors(from))
+    {
+      if (component_of[from] != component_of[to])
+      {
+        component_edges.emplace_back(component_of[from], component_of[to]);
+      }
+    }
+  }
+  std::ranges::sort(component_edges);
+  const auto duplicates = std::ranges::unique(component_edges);
+  component_edges.erase(duplicates.begin(), duplicates.end());
+  const lwyi::Digraph condensation(checked.component_count, component_edges);
+  const lwyi::Reachability reachability(condensation);
+  const auto reaches = [&](uint32_t from, uint32_t to)
+  {
+    if (component_of[from] == component_of[to])
+    {
+      return from != to || std::ranges::contains(dependencies.successors(from), to);
+    }
+    return reachability.reaches(component_of[from], component_of[to]);
+  };
+
+  for (const auto& [target, forbidden_dependencies] : config.forbidden_dependencies)
+  {
+    const auto from = checked.graph.find(target);
+    if (!from || !checked.target_model.get_target_data(target).has_value())
+    {
+      continue;
+    }
+
+    for (const auto& forbidden_dependency : forbidden_dependencies)
+    {
+      const auto to = checked.graph.find(forbidden_dependency);
+      if (!to || !reaches(*from, *to))
+      {
+        continue;
+      }
+      Dag_diagnostic diagnostic{Dag_diagnostic_type::forbidden_dependency, {}};
+      for (const auto id : lwyi::shortest_path(dependencies, *from, *to))
+      {
+        diagnostic.targets.push_back(checked.graph.target(id));
+      }
+      diagnostics.push_back(std::move(diagnostic));
+    }
+  }
+}
+
+void check_layer_dependencies(const Config& config,
+                              const Checked_graph& checked,
+                              std::vector<Dag_diagnostic>& diagnostics)
+{
+  const auto& graph = checked.graph;
+  const Layer_matcher matcher(config.forbidden_layer_dependencies, graph);
+
+  // sorted, as the dependencies of a target are not
+  std::set<std::pair<target_model::Target, target_model::Target>> violations;
+  for (uint32_t from = 0; from < graph.size(); ++from)
+  {
+    for (const auto to : checked.dependencies.successors(from))
+    {
+      if (!matcher.forbidden(from, to))
+      {
+        continue;
+      }
+      // already reported as an explicitly forbidden dependency
+      const auto& target = graph.target(from);
+      const auto& dependency = graph.target(to);
+      const auto explicit_rule = config.forbidden_dependencies.find(target);
+      if (explicit_rule != config.forbidden_dependencies.end() &&
+          explicit_rule->second.contains(dependency))
+      {
+        continue;
+      }
+      violations.emplace(target, dependency);
+    }
+  }
+
+  for (const auto& [target, dependency] : violations)
+  {
+    diagnostics.push_back({Dag_diagnostic_type::forbidden_dependency, {target, dependency}});
+  }
+}
+
+std::vector<Dag_diagnostic> check(const Config& config, const Checked_graph& checked)
 {
   std::vector<Dag_diagnostic> diagnostics;
 
+  // The clusters are the components of more than one target. They are sorted, so the order of
+  // the diagnostics does not depend on how the components were found.
+  std::vector<std::set<target_model::Target>> clusters(checked.component_count);
+  for (uint32_t id = 0; id < checked.graph.size(); ++id)
+  {
+    clusters[checked.component_of[id]].insert(checked.graph.target(id));
+  }
+  std::erase_if(clusters,
+                [](const std::set<target_model::Target>& cluster) { return cluster.size() < 2; });
+  std::ranges::sort(clusters);
+
   // Check allowed_clusters
   const auto& allowed_clusters = config.allowed_clusters;
-  const auto components = lwyi::compute_strongly_connected_dependencies(target_model);
-
-  const auto result = cluster_diff(allowed_clusters, components);
+  const auto result = cluster_diff(allowed_clusters, clusters);
 
   assert(allowed_clusters.size() <= result.size());
 
@@ -52,24 +210,142 @@ std::vector<Dag_diagnostic> tidy(const Config& config,
   }
 
   // Check forbidden_dependencies
-  for (const auto& [target, forbidden_dependencies] : config.forbidden_dependencies)
+  if (config.transitive)
+  {
+    check_transitive_dependencies(config, checked, diagnostics);
+  }
+  else
+  {
+    check_direct_dependencies(config, checked, diagnostics);
+  }
+
+  // Check forbidden_layer_dependencies
+  if (!config.forbidden_layer_dependencies.empty())
+  {
+    check_layer_dependencies(config, checked, diagnostics);
+  }
+
+  return diagnostics;
+}
+} // namespace
+
+std::vector<Dag_diagnostic> tidy(const Config& config,
+                                 const target_model::Target_model& target_model)
+{
+  const lwyi::Target_graph graph(target_model);
+  const lwyi::Strongly_connected_components components(graph.dependencies());
+  Checked_graph checked{target_model, graph, graph.dependencies(), {}, components.size()};
+  checked.component_of.reserve(graph.size());
+  for (uint32_t id = 0; id < graph.size(); ++id)
+  {
+    checked.component_of.push_back(components.component(id));
+  }
+  return check(config, checked);
+}
+
+std::expected<std::vector<Dependency_edit>, std::string> parse_dependency_edits(
+  std::string_view text)
+{
+  std::vector<Dependency_edit> edits;
+  for (const auto item : std::views::split(text, ','))
   {
-    auto target_data = target_model.get_target_data(target);
-    if (!target_data.has_value())
+    const std::string_view edit_text(item.begin(), item.end());
+    const auto colon = edit_text.find(':');
+    const auto arrow = edit_text.find("->");
+    if (colon == std::string_view::npos || arrow == std::string_view::npos || arrow < colon)
     {
-      continue;
+      return std::unexpected(
+        std::format("invalid dependency edit \"{}\", expected add:A->B or remove:A->B",
+                    edit_text));
     }
 
-    for (const auto& forbidden_dependency : forbidden_dependencies)
+    Dependency_edit edit;
+    const auto kind = edit_text.substr(0, colon);
+    if (kind == "add")
     {
-      if (0 < target_data->get().dependencies.count(forbidden_dependency))
-      {
-        diagnostics.push_back(
-          {Dag_diagnostic_type::forbidden_dependency, {target, forbidden_dependency}});
-      }
+      edit.kind = Dependency_edit::Kind::add;
+    }
+    else if (kind == "remove")
+    {
+      edit.kind = Dependency_edit::Kind::remove;
+    }
+    else
+    {
+      return std::unexpected(std::format("unknown dependency edit \"{}\"", kind));
+    }
+    edit.from.name = edit_text.substr(colon + 1, arrow - colon - 1);
+    edit.to.name = edit_text.substr(arrow + 2);
+    if (edit.from.name.empty() || edit.to.name.empty())
+    {
+      return std::unexpected(std::format("missing target in dependency edit \"{}\"", edit_text));
     }
+    edits.push_back(std::move(edit));
+  }
+  return edits;
+}
+
+std::expected<std::vector<Dag_diagnostic>, std::string> tidy_what_if(
+  const Config& config,
+  const target_model::Target_model& target_model,
+  const std::vector<Dependency_edit>& edits)
+{
+  // The components are only updated around the edited edges
+  const lwyi::Target_graph graph(target_model);
+  lwyi::Incremental_components components(graph.dependencies());
+  std::vector<std::vector<uint32_t>> edited(graph.size());
+  for (uint32_t id = 0; id < graph.size(); ++id)
+  {
+    const auto dependencies = graph.dependencies().successors(id);
+    edited[id].assign(dependencies.begin(), dependencies.end());
   }
 
-  return diagnostics;
+  for (const auto& edit : edits)
+  {
+    const auto from = graph.find(edit.from);
+    if (!from || !target_model.get_target_data(edit.from).has_value())
+    {
+      return std::unexpected(std::format("{} is not a target of the model", edit.from.name));
+    }
+    const auto to = graph.find(edit.to);
+    if (!to)
+    {
+      return std::unexpected(std::format("{} is not a known target", edit.to.name));
+    }
+
+    auto& dependencies = edited[*from];
+    const auto dependency = std::ranges::find(dependencies, *to);
+    if (edit.kind == Dependency_edit::Kind::add && dependency == dependencies.end())
+    {
+      dependencies.push_back(*to);
+      components.add_edge(*from, *to);
+    }
+    else if (edit.kind == Dependency_edit::Kind::remove && dependency != dependencies.end())
+    {
+      dependencies.erase(dependency);
+      components.remove_edge(*from, *to);
+    }
+  }
+
+  std::vector<uint32_t> offsets{0};
+  std::vector<uint32_t> successors;
+  for (const auto& dependencies : edited)
+  {
+    successors.insert(successors.end(), dependencies.begin(), dependencies.end());
+    offsets.push_back(static_cast<uint32_t>(successors.size()));
+  }
+  const lwyi::Digraph dependencies(std::move(offsets), std::move(successors));
+
+  // the components are numbered by their position in the reverse topological order
+  Checked_graph checked{target_model, graph, dependencies, {}, components.size()};
+  checked.component_of.resize(graph.size());
+  const auto order = components.order();
+  for (uint32_t position = 0; position < order.size(); ++position)
+  {
+    for (const auto member : components.members(order[position]))
+    {
+      checked.component_of[member] = position;
+    }
+  }
+  return check(config, checked);
 }
 } // namespace tidy
@@ -5,12 +5,35 @@
 
 #include <target_model/target.hpp>
 
+#include <catch2/benchmark/catch_benchmark.hpp>
 #include <catch2/catch_test_macros.hpp>
 
+#include <algorithm>
+#include <cstddef>
+#include <format>
+#include <random>
 #include <set>
+#include <string>
 #include <utility>
 #include <vector>
 
+namespace
+{
+// clusters of three targets each, named after their cluster
+std::vector<std::set<target_model::Target>> make_clusters(size_t count)
+{
+  std::vector<std::set<target_model::Target>> clusters(count);
+  for (size_t i = 0; i < count; ++i)
+  {
+    for (size_t j = 0; j < 3; ++j)
+    {
+      clusters[i].insert({std::format("t{}_{}", i, j)});
+    }
+  }
+  return clusters;
+}
+} // namespace
+
 TEST_CASE("tidy: cluster_diff", "[tidy]")
 {
   GIVEN("two lists of clusters that match")
@@ -142,4 +165,71 @@ TEST_CASE("tidy: cluster_diff", "[tidy]")
       }
     }
   }
+
+  GIVEN("two lists of clusters that overlap in different ways")
+  {
+    // matching the largest overlap first pairs the first clusters and keeps 3 common targets,
+    // the best matching keeps 4
+    std::vector<std::set<target_model::Target>> lhs{{{"a"}, {"b"}, {"c"}, {"d"}, {"e"}},
+                                                    {{"a"}, {"b"}}};
+    std::vector<std::set<target_model::Target>> rhs{{{"a"}, {"b"}, {"c"}}, {{"d"}, {"e"}}};
+
+    WHEN("cluster_diff is called")
+    {
+      auto result = tidy::cluster_diff(lhs, rhs);
+
+      THEN("the clusters are matched so that they have the most targets in common")
+      {
+        REQUIRE(result.size() == 2);
+
+        CHECK(result[0].left_only == std::vector<target_model::Target>{{"a"}, {"b"}, {"c"}});
+        CHECK(result[0].right_only.empty());
+        CHECK(result[1].left_only.empty());
+        CHECK(result[1].right_only == std::vector<target_model::Target>{{"c"}});
+      }
+    }
+  }
+
+  GIVEN("hundreds of clusters in a different order")
+  {
+    const auto lhs = make_clusters(300);
+    auto rhs = lhs;
+    std::ranges::shuffle(rhs, std::mt19937{42});
+
+    WHEN("cluster_diff is called")
+    {
+      auto result = tidy::cluster_diff(lhs, rhs);
+
+      THEN("there should be no differences")
+      {
+        REQUIRE(result.size() == 300);
+        CHECK(std::ranges::all_of(result,
+                                  [](const tidy::Cluster_diff& diff)
+                                  {
+                                    return diff.left_only.empty() && diff.right_only.empty();
+                                  }));
+      }
+    }
+  }
+}
+
+TEST_CASE("tidy: cluster_diff scaling", "[!benchmark][.]")
+{
+  for (size_t count = 10; count <= 1000; count *= 10)
+  {
+    const auto lhs = make_clusters(count);
+    auto rhs = lhs;
+    std::ranges::shuffle(rhs, std::mt19937{42});
+    // move a target between every pair of neighbouring clusters
+    for (size_t i = 0; i + 1 < count; i += 2)
+    {
+      auto moved = rhs[i].extract(rhs[i].begin());
+      rhs[i + 1].insert(std::move(moved));
+    }
+
+    BENCHMARK(std::format("{} clusters", count))
+    {
+      return tidy::cluster_diff(lhs, rhs);
+    };
+  }
 }
@@ -0,0 +1,45 @@
+// Copyright (c) 2025 Environmental Systems Research Institute, Inc.
+// SPDX-License-Identifier: Apache-2.0
+
+#include <src/layer_matcher.hpp>
+
+#include <lwyi/target_graph.hpp>
+#include <target_model/target.hpp>
+#include <target_model/target_data.hpp>
+#include <target_model/target_model.hpp>
+#include <tidy/config.hpp>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <cstdint>
+#include <vector>
+
+TEST_CASE("tidy: Layer_matcher", "[tidy]")
+{
+  target_model::Target_model target_model{{
+    {{"core_io"}, {}},
+    {{"core_io_test"}, {}},
+    {{"ui_widgets"}, {}},
+    {{"app"}, {}},
+  }};
+  const lwyi::Target_graph graph(target_model);
+  const auto id = [&](const char* name) -> uint32_t
+  {
+    return *graph.find({name});
+  };
+
+  const std::vector<tidy::Layer_rule> rules{
+    {"core_*", "ui_*"},
+    {"*", "*_test"},
+    {"app", "core_io"},
+  };
+  const tidy::Layer_matcher matcher(rules, graph);
+
+  CHECK(matcher.forbidden(id("core_io"), id("ui_widgets")));
+  CHECK(matcher.forbidden(id("core_io_test"), id("ui_widgets")));
+  CHECK(matcher.forbidden(id("ui_widgets"), id("core_io_test")));
+  CHECK(matcher.forbidden(id("app"), id("core_io")));
+  CHECK_FALSE(matcher.forbidden(id("ui_widgets"), id("core_io")));
+  CHECK_FALSE(matcher.forbidden(id("app"), id("ui_widgets")));
+  CHECK_FALSE(matcher.forbidden(id("core_io_test"), id("core_io")));
+}
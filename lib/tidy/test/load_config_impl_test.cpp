@@ -58,6 +58,82 @@ TEST_CASE("tidy: load a valid config", "[tidy]")
               std::set<target_model::Target>{target_model::Target{"libs"},
                                              target_model::Target{"libt"},
                                              target_model::Target{"libu"}});
+        CHECK_FALSE(config.transitive);
+        CHECK(config.forbidden_layer_dependencies.empty());
+      }
+    }
+  }
+}
+
+TEST_CASE("tidy: load a config with transitive forbidden dependencies", "[tidy]")
+{
+  GIVEN("a config file that makes the forbidden dependencies transitive")
+  {
+    const char* json = R"===({
+      "transitive": true,
+      "forbidden_dependencies": {
+        "liba": ["libx"]
+      },
+      "allowed_clusters": []
+      })===";
+    simdjson::padded_string raw_config(json, std::strlen(json));
+
+    WHEN("load_config_impl is called")
+    {
+      auto result = tidy::load_config_impl(raw_config);
+
+      THEN("the forbidden dependencies are transitive")
+      {
+        REQUIRE(result.has_value());
+        CHECK(result->transitive);
+      }
+    }
+  }
+}
+
+TEST_CASE("tidy: load a config with layer rules", "[tidy]")
+{
+  GIVEN("a config file with forbidden layer dependencies")
+  {
+    const char* json = R"===({
+      "forbidden_dependencies": {},
+      "forbidden_layer_dependencies": [
+        {"from": "core_*", "to": "ui_*"},
+        {"from": "*", "to": "*_test"}
+      ],
+      "allowed_clusters": []
+      })===";
+    simdjson::padded_string raw_config(json, std::strlen(json));
+
+    WHEN("load_config_impl is called")
+    {
+      auto result = tidy::load_config_impl(raw_config);
+
+      THEN("the layer rules are loaded in order")
+      {
+        REQUIRE(result.has_value());
+        CHECK(result->forbidden_layer_dependencies ==
+              std::vector<tidy::Layer_rule>{{"core_*", "ui_*"}, {"*", "*_test"}});
+      }
+    }
+  }
+
+  GIVEN("a config file with a layer rule without a target pattern")
+  {
+    const char* json = R"===({
+      "forbidden_dependencies": {},
+      "forbidden_layer_dependencies": [{"from": "core_*"}],
+      "allowed_clusters": []
+      })===";
+    simdjson::padded_string raw_config(json, std::strlen(json));
+
+    WHEN("load_config_impl is called")
+    {
+      auto result = tidy::load_config_impl(raw_config);
+
+      THEN("an error is returned")
+      {
+        CHECK_FALSE(result.has_value());
       }
     }
   }
@@ -10,6 +10,8 @@
 
 #include <catch2/catch_test_macros.hpp>
 
+#include <algorithm>
+#include <cstddef>
 #include <map>
 #include <unordered_set>
 #include <utility>
@@ -125,5 +127,161 @@ TEST_CASE("tidy: tidy", "[tidy]")
               std::vector<target_model::Target>{{"libd"}, {"libc"}});
       }
     }
+
+    WHEN("tidy is run in transitive mode after a forbidden dependency is added indirectly")
+    {
+      // libc -> libd -> libe -> libf -> libg
+      config.forbidden_dependencies[{"libc"}] = {{"libg"}};
+      config.transitive = true;
+      auto target_model = make_target_model();
+
+      auto diagnostics = tidy::tidy(config, target_model);
+
+      THEN("the shortest path to the forbidden dependency is reported")
+      {
+        REQUIRE(diagnostics.size() == 2);
+        CHECK(diagnostics[0].type == tidy::Dag_diagnostic_type::forbidden_dependency);
+        CHECK(diagnostics[0].targets ==
+              std::vector<target_model::Target>{{"libc"}, {"libd"}, {"libe"}, {"libf"}, {"libg"}});
+        // libd reaches libc through the cluster
+        CHECK(diagnostics[1].type == tidy::Dag_diagnostic_type::forbidden_dependency);
+        CHECK(diagnostics[1].targets ==
+              std::vector<target_model::Target>{{"libd"}, {"libe"}, {"libc"}});
+      }
+    }
+
+    WHEN("tidy is run without transitive mode on an indirect forbidden dependency")
+    {
+      config.forbidden_dependencies[{"libc"}] = {{"libg"}};
+      auto target_model = make_target_model();
+
+      auto diagnostics = tidy::tidy(config, target_model);
+
+      THEN("No diagnostics are reported")
+      {
+        CHECK(diagnostics.empty());
+      }
+    }
+
+    WHEN("tidy is run with layer rules that match some dependencies")
+    {
+      config.forbidden_layer_dependencies = {{"libe", "lib?"}, {"*", "libg"}};
+      // also forbidden explicitly, which is reported once
+      config.forbidden_dependencies[{"libe"}] = {{"libf"}};
+      auto target_model = make_target_model();
+
+      auto diagnostics = tidy::tidy(config, target_model);
+
+      THEN("the dependencies are reported in order")
+      {
+        REQUIRE(diagnostics.size() == 3);
+        CHECK(diagnostics[0].targets == std::vector<target_model::Target>{{"libe"}, {"libf"}});
+        CHECK(diagnostics[1].targets == std::vector<target_model::Target>{{"libe"}, {"libc"}});
+        CHECK(diagnostics[2].targets == std::vector<target_model::Target>{{"libf"}, {"libg"}});
+        CHECK(std::ranges::all_of(diagnostics,
+                                  [](const tidy::Dag_diagnostic& diagnostic)
+                                  {
+                                    return diagnostic.type ==
+                                           tidy::Dag_diagnostic_type::forbidden_dependency;
+                                  }));
+      }
+    }
+
+    WHEN("tidy_what_if is run with an edit that increases the size of a cluster")
+    {
+      auto target_model = make_target_model();
+
+      auto diagnostics = tidy::tidy_what_if(
+        config, target_model, {{tidy::Dependency_edit::Kind::add, {"libf"}, {"libc"}}});
+
+      THEN("the same diagnostic is reported as for the edited model")
+      {
+        REQUIRE(diagnostics.has_value());
+        REQUIRE(diagnostics->size() == 1);
+        CHECK((*diagnostics)[0].type == tidy::Dag_diagnostic_type::added_to_cluster);
+        CHECK((*diagnostics)[0].targets == std::vector<target_model::Target>{{"libf"}});
+      }
+    }
+
+    WHEN("tidy_what_if is run with edits that split a cluster and add a forbidden dependency")
+    {
+      auto target_model = make_target_model();
+      std::vector<tidy::Dependency_edit> edits{
+        {tidy::Dependency_edit::Kind::remove, {"libc"}, {"libd"}},
+        {tidy::Dependency_edit::Kind::add, {"libc"}, {"libe"}},
+        {tidy::Dependency_edit::Kind::add, {"libd"}, {"libc"}},
+      };
+
+      auto diagnostics = tidy::tidy_what_if(config, target_model, edits);
+
+      THEN("libd leaves the cluster and depends on libc")
+      {
+        REQUIRE(diagnostics.has_value());
+        REQUIRE(diagnostics->size() == 2);
+        CHECK((*diagnostics)[0].type == tidy::Dag_diagnostic_type::removed_from_cluster);
+        CHECK((*diagnostics)[0].targets == std::vector<target_model::Target>{{"libd"}});
+        CHECK((*diagnostics)[1].type == tidy::Dag_diagnostic_type::forbidden_dependency);
+        CHECK((*diagnostics)[1].targets ==
+              std::vector<target_model::Target>{{"libd"}, {"libc"}});
+      }
+    }
+
+    WHEN("tidy_what_if is run with edits that form several new clusters")
+    {
+      config.allowed_clusters.clear();
+      auto target_model = make_target_model();
+      std::vector<tidy::Dependency_edit> edits{
+        {tidy::Dependency_edit::Kind::add, {"libg"}, {"libf"}},
+        {tidy::Dependency_edit::Kind::remove, {"libc"}, {"libd"}},
+        {tidy::Dependency_edit::Kind::add, {"libc"}, {"libe"}},
+      };
+
+      auto diagnostics = tidy::tidy_what_if(config, target_model, edits);
+
+      THEN("the new clusters are reported in the same order as for the edited model")
+      {
+        libg_target_data.dependencies.insert({"libf"});
+        libc_target_data.dependencies = {{"libe"}};
+        const auto expected = tidy::tidy(config, make_target_model());
+
+        REQUIRE(diagnostics.has_value());
+        REQUIRE(diagnostics->size() == 3);
+        REQUIRE(expected.size() == diagnostics->size());
+        for (size_t i = 0; i < expected.size(); ++i)
+        {
+          CHECK((*diagnostics)[i].type == tidy::Dag_diagnostic_type::new_cluster);
+          CHECK((*diagnostics)[i].type == expected[i].type);
+          CHECK((*diagnostics)[i].targets == expected[i].targets);
+        }
+      }
+    }
+
+    WHEN("tidy_what_if is run with an edit of an unknown target")
+    {
+      auto target_model = make_target_model();
+
+      auto diagnostics = tidy::tidy_what_if(
+        config, target_model, {{tidy::Dependency_edit::Kind::add, {"libx"}, {"liba"}}});
+
+      THEN("an error is returned")
+      {
+        CHECK_FALSE(diagnostics.has_value());
+      }
+    }
   }
 }
+
+TEST_CASE("tidy: parse_dependency_edits", "[tidy]")
+{
+  auto edits = tidy::parse_dependency_edits("add:liba->libb,remove:libc->libd");
+  REQUIRE(edits.has_value());
+  CHECK(*edits == std::vector<tidy::Dependency_edit>{
+                    {tidy::Dependency_edit::Kind::add, {"liba"}, {"libb"}},
+                    {tidy::Dependency_edit::Kind::remove, {"libc"}, {"libd"}},
+                  });
+
+  CHECK_FALSE(tidy::parse_dependency_edits("liba->libb").has_value());
+  CHECK_FALSE(tidy::parse_dependency_edits("move:liba->libb").has_value());
+  CHECK_FALSE(tidy::parse_dependency_edits("add:liba-libb").has_value());
+  CHECK_FALSE(tidy::parse_dependency_edits("add:->libb").has_value());
+}
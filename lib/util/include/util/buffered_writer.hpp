@@ -0,0 +1,91 @@
+// Copyright (c) 2025 Environmental Systems Research Institute, Inc.
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+
+#include <cstddef>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <format>
+#include <iterator>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+
+namespace util
+{
+// Formats into a large buffer that is written to the file whenever it fills up
+class Buffered_writer
+{
+public:
+  explicit Buffered_writer(const std::filesystem::path& path, const char* mode = "w")
+  : file_(fopen(path.string().c_str(), mode), fclose)
+  {
+    buffer_.reserve(buffer_size);
+  }
+
+  bool is_open() const
+  {
+    return file_ != nullptr;
+  }
+
+  template <typename... TArgs>
+  void print(std::format_string<TArgs...> format, TArgs&&... args)
+  {
+    std::format_to(std::back_inserter(buffer_), format, std::forward<TArgs>(args)...);
+    flush_if_full();
+  }
+
+  void write(std::string_view bytes)
+  {
+    buffer_.append(bytes);
+    flush_if_full();
+  }
+
+  // Write the bytes of the value as they are in memory
+  template <typename T>
+    requires std::is_trivially_copyable_v<T>
+  void write_value(const T& value)
+  {
+    const auto size = buffer_.size();
+    buffer_.resize(size + sizeof(T));
+    std::memcpy(buffer_.data() + size, &value, sizeof(T));
+    flush_if_full();
+  }
+
+  // Write the rest of the buffer and close the file, false when any write failed
+  bool close()
+  {
+    flush();
+    const bool closed = fclose(file_.release()) == 0;
+    return closed && !failed_;
+  }
+
+private:
+  static constexpr size_t buffer_size = size_t{1} << 20;
+
+  void flush_if_full()
+  {
+    if (buffer_size <= buffer_.size())
+    {
+      flush();
+    }
+  }
+
+  void flush()
+  {
+    if (fwrite(buffer_.data(), 1, buffer_.size(), file_.get()) != buffer_.size())
+    {
+      failed_ = true;
+    }
+    buffer_.clear();
+  }
+
+  std::unique_ptr<FILE, int (*)(FILE*)> file_;
+  std::string buffer_;
+  bool failed_{false};
+};
+} // namespace util
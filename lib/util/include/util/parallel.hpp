@@ -0,0 +1,159 @@
+// Copyright (c) 2025 Environmental Systems Research Institute, Inc.
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+
+#include <util/parallel_transformer.hpp>
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstddef>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace util
+{
+// Calls fun(i) for every index up to count on the threads of the pool
+template <class TFun>
+void parallel_for(Parallel_transformer& pool, size_t count, TFun&& fun, size_t chunk_size = 0)
+{
+  pool.for_each_chunk(count,
+                      chunk_size,
+                      [&](size_t begin, size_t end)
+                      {
+                        for (auto i = begin; i < end; ++i)
+                        {
+                          fun(i);
+                        }
+                      });
+}
+
+// Folds map(i) for every index up to count into init with reduce. Every chunk is folded on its
+// own and the chunks are then folded in index order, so reduce has to be associative but not
+// commutative and the result does not depend on the timing.
+template <class T, class TMap, class TReduce>
+T parallel_reduce(Parallel_transformer& pool,
+                  size_t count,
+                  T init,
+                  TMap&& map,
+                  TReduce&& reduce,
+                  size_t chunk_size = 0)
+{
+  if (chunk_size == 0)
+  {
+    chunk_size = pool.chunk_size(count);
+  }
+  std::vector<std::optional<T>> partials((count + chunk_size - 1) / chunk_size);
+  pool.for_each_chunk(count,
+                      chunk_size,
+                      [&](size_t begin, size_t end)
+                      {
+                        T partial = map(begin);
+                        for (auto i = begin + 1; i < end; ++i)
+                        {
+                          partial = reduce(std::move(partial), map(i));
+                        }
+                        partials[begin / chunk_size] = std::move(partial);
+                      });
+
+  for (auto& partial : partials)
+  {
+    if (partial)
+    {
+      init = reduce(std::move(init), std::move(*partial));
+    }
+  }
+  return init;
+}
+
+namespace detail
+{
+template <size_t I, size_t End, class TInput, class TStages>
+auto apply_stages(TInput&& input, TStages& stages)
+{
+  if constexpr (I == End)
+  {
+    return std::forward<TInput>(input);
+  }
+  else
+  {
+    return apply_stages<I + 1, End>(std::get<I>(stages)(std::forward<TInput>(input)), stages);
+  }
+}
+} // namespace detail
+
+// Passes the indices up to count through the stages. The first stage receives the index and
+// every other stage the result of the previous one. All but the last stage run on the threads
+// of the pool, so different items overlap. The last stage runs in the calling thread and sees
+// the items in index order. At most max_in_flight items are between the first and the last
+// stage at any time, which bounds the memory held by finished items that wait for their turn.
+template <class... TStages>
+void ordered_pipeline(Parallel_transformer& pool,
+                      size_t count,
+                      size_t max_in_flight,
+                      TStages&&... stages)
+{
+  static_assert(sizeof...(TStages) >= 2, "a pipeline needs a parallel and an ordered stage");
+  constexpr size_t last_stage = sizeof...(TStages) - 1;
+
+  auto stage_tuple = std::forward_as_tuple(stages...);
+  using Result = decltype(detail::apply_stages<0, last_stage>(size_t{0}, stage_tuple));
+
+  max_in_flight = std::max(max_in_flight, size_t{1});
+  // the item i goes into the slot i % max_in_flight, which the item i - max_in_flight left
+  std::vector<std::optional<Result>> slots(max_in_flight);
+  size_t consumed_count = 0;
+  std::mutex mutex;
+  std::condition_variable cv;
+
+  std::jthread producer(
+    [&]()
+    {
+      // one item per chunk, so an item waiting for its slot holds up no other item
+      pool.for_each_chunk(
+        count,
+        1,
+        [&](size_t begin, size_t end)
+        {
+          for (auto index = begin; index < end; ++index)
+          {
+            {
+              std::unique_lock lock(mutex);
+              cv.wait(lock,
+                      [&]
+                      {
+                        return index < consumed_count + max_in_flight;
+                      });
+            }
+            auto result = detail::apply_stages<0, last_stage>(index, stage_tuple);
+            std::scoped_lock lock(mutex);
+            slots[index % max_in_flight] = std::move(result);
+            cv.notify_all();
+          }
+        });
+    });
+
+  for (size_t index = 0; index < count; ++index)
+  {
+    std::unique_lock lock(mutex);
+    auto& slot = slots[index % max_in_flight];
+    cv.wait(lock,
+            [&]
+            {
+              return slot.has_value();
+            });
+    auto result = std::move(*slot);
+    slot.reset();
+    ++consumed_count;
+    lock.unlock();
+    cv.notify_all();
+
+    std::get<last_stage>(stage_tuple)(std::move(result));
+  }
+}
+} // namespace util
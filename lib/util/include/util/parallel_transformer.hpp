@@ -4,17 +4,23 @@
 #pragma once
 
 #include <atomic>
-#include <condition_variable>
 #include <cstddef>
-#include <cstdint>
-#include <functional>
-#include <mutex>
-#include <queue>
+#include <iterator>
+#include <memory>
+#include <semaphore>
+#include <stop_token>
 #include <thread>
+#include <type_traits>
 #include <vector>
 
 namespace util
 {
+// A pool of threads that applies a callable to every element of a range. A transform is split
+// into chunks of consecutive elements that the threads claim with an atomic counter, so handing
+// out an element neither allocates nor takes a lock. The chunks are claimed in order, so the
+// elements start roughly in the order of the range. Every thread has its own queue of
+// transforms to help with and takes them from the others when it runs out. Several transforms
+// may run at the same time.
 class Parallel_transformer
 {
 public:
@@ -25,34 +31,102 @@ public:
   Parallel_transformer& operator=(const Parallel_transformer&) = delete;
   Parallel_transformer& operator=(Parallel_transformer&&) = delete;
 
-  template <class TInputIt, class TOutputIt, class TCallable>
-  TOutputIt transform(TInputIt first1, TInputIt last1, TOutputIt d_first, TCallable unary_op)
+  size_t thread_count() const
   {
-    for (; first1 != last1; ++d_first, ++first1)
-    {
-      push_work_(
-        [=]()
-        {
-          *d_first = unary_op(*first1);
-        });
-    }
-    flush_();
-    return d_first;
+    return threads_.size();
+  }
+
+  // The chunk size that balances the load of count elements over the threads
+  size_t chunk_size(size_t count) const;
+
+  // Calls chunk_op(begin, end) for consecutive chunks of the indices up to count and returns
+  // when all of them are done. A chunk size of zero picks chunk_size(count).
+  template <class TChunkOp>
+  void for_each_chunk(size_t count, size_t chunk_size, TChunkOp&& chunk_op)
+  {
+    run_(count,
+         chunk_size,
+         [](void* context, size_t begin, size_t end)
+         {
+           (*static_cast<std::remove_reference_t<TChunkOp>*>(context))(begin, end);
+         },
+         const_cast<void*>(static_cast<const void*>(std::addressof(chunk_op))));
+  }
+
+  // A chunk size of zero picks one that balances the load. Elements that take long, or are
+  // sorted longest first, need a chunk size of one so that no thread claims several of them.
+  template <std::random_access_iterator TInputIt,
+            std::random_access_iterator TOutputIt,
+            class TCallable>
+  TOutputIt transform(TInputIt first1,
+                      TInputIt last1,
+                      TOutputIt d_first,
+                      TCallable unary_op,
+                      size_t chunk_size = 0)
+  {
+    const auto count = static_cast<size_t>(std::distance(first1, last1));
+    for_each_chunk(count,
+                   chunk_size,
+                   [&](size_t begin, size_t end)
+                   {
+                     auto input = std::next(first1, static_cast<std::ptrdiff_t>(begin));
+                     auto output = std::next(d_first, static_cast<std::ptrdiff_t>(begin));
+                     for (auto i = begin; i < end; ++i, ++input, ++output)
+                     {
+                       *output = unary_op(*input);
+                     }
+                   });
+    return std::next(d_first, static_cast<std::ptrdiff_t>(count));
+  }
+
+  // The callable also receives the stop token, to skip or abort its work once a stop is
+  // requested. Work that has not started yet is still handed to the callable, which decides
+  // what to return for it.
+  template <std::random_access_iterator TInputIt,
+            std::random_access_iterator TOutputIt,
+            class TCallable>
+  TOutputIt transform(TInputIt first1,
+                      TInputIt last1,
+                      TOutputIt d_first,
+                      TCallable unary_op,
+                      std::stop_token stop_token,
+                      size_t chunk_size = 0)
+  {
+    const auto count = static_cast<size_t>(std::distance(first1, last1));
+    for_each_chunk(count,
+                   chunk_size,
+                   [&](size_t begin, size_t end)
+                   {
+                     auto input = std::next(first1, static_cast<std::ptrdiff_t>(begin));
+                     auto output = std::next(d_first, static_cast<std::ptrdiff_t>(begin));
+                     for (auto i = begin; i < end; ++i, ++input, ++output)
+                     {
+                       *output = unary_op(*input, stop_token);
+                     }
+                   });
+    return std::next(d_first, static_cast<std::ptrdiff_t>(count));
   }
 
 private:
-  void push_work_(std::function<void()> fun);
-  std::function<void()> pop_work_();
-  void flush_();
-  void thread_fun_();
+  using Chunk_function = void (*)(void* context, size_t begin, size_t end);
+
+  class Batch;
+  struct Worker;
+
+  // Hands out the chunks and waits until all of them are done
+  void run_(size_t count, size_t chunk_size, Chunk_function chunk_function, void* context);
+  // A batch from the thread's own queue, else from the next queue that has one
+  std::shared_ptr<Batch> take_(size_t index);
+  void thread_fun_(size_t index);
 
+  std::vector<std::unique_ptr<Worker>> workers_;
   std::vector<std::thread> threads_;
-  std::queue<std::function<void()>> queue_;
-  std::mutex mutex_;
-  std::condition_variable cv_;
-  uint32_t compleated_count_{0U};
-  uint32_t queued_count_{0U};
-  uint32_t sync_{0U};
+  // released once for every thread that should look for work
+  std::counting_semaphore<> wakeups_{0};
+  std::atomic_size_t queued_count_{0U};
+  std::atomic_size_t sleeping_count_{0U};
+  // spreads concurrent transforms over the queues
+  std::atomic_size_t next_worker_{0U};
   std::atomic_bool shutdown_{false};
 };
 } // namespace util
@@ -0,0 +1,73 @@
+// Copyright (c) 2025 Environmental Systems Research Institute, Inc.
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <expected>
+#include <limits>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <utility>
+
+namespace util
+{
+class File_descriptor
+{
+public:
+  File_descriptor() = default;
+  explicit File_descriptor(int fd)
+  : fd_(fd)
+  {
+  }
+  ~File_descriptor();
+  File_descriptor(const File_descriptor&) = delete;
+  File_descriptor(File_descriptor&& other) noexcept
+  : fd_(std::exchange(other.fd_, -1))
+  {
+  }
+  File_descriptor& operator=(const File_descriptor&) = delete;
+  File_descriptor& operator=(File_descriptor&& other) noexcept
+  {
+    std::swap(fd_, other.fd_);
+    return *this;
+  }
+
+  int get() const
+  {
+    return fd_;
+  }
+
+private:
+  int fd_{-1};
+};
+
+// Sockets are addressed by HOST:PORT for TCP or by the path of a Unix domain socket. Neither is
+// supported on Windows.
+std::expected<File_descriptor, std::string> connect_to(std::string_view address);
+
+// A Unix domain socket left behind by a process that did not shut down cleanly is replaced
+std::expected<File_descriptor, std::string> listen_on(std::string_view address);
+
+// Two connected sockets, to talk to a child process. Both are closed on exec, so a child
+// process only inherits the one it is given explicitly.
+std::expected<std::pair<File_descriptor, File_descriptor>, std::string> socket_pair();
+
+bool write_all(int fd, std::string_view data);
+
+// Read until the other side shuts down the connection
+std::optional<std::string> read_all(int fd);
+
+// Frames carry a message prefixed with its size, so several messages can be exchanged over one
+// connection
+bool write_frame(int fd, std::string_view message);
+
+// Nothing is returned when the connection ends early, when the frame is larger than max_size or
+// when the whole frame does not arrive within the timeout
+std::optional<std::string> read_frame(
+  int fd,
+  std::optional<std::chrono::milliseconds> timeout = std::nullopt,
+  uint32_t max_size = std::numeric_limits<uint32_t>::max());
+} // namespace util
@@ -0,0 +1,38 @@
+// Copyright (c) 2025 Environmental Systems Research Institute, Inc.
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <optional>
+#include <string_view>
+
+namespace util
+{
+// The number of CPUs allowed by the contents of a cgroup v2 cpu.max file, rounded up, or
+// nothing when there is no quota
+std::optional<size_t> parse_cgroup_cpu_max(std::string_view cpu_max);
+
+// The bytes allowed by the contents of a cgroup v2 memory.max file, or nothing when there is no
+// limit
+std::optional<uint64_t> parse_cgroup_memory_max(std::string_view memory_max);
+
+// The directory of the cgroup v2 of this process as listed in /proc/self/cgroup, or nothing
+// when the process is not in a cgroup v2 hierarchy
+std::optional<std::filesystem::path> parse_proc_self_cgroup(std::string_view proc_self_cgroup);
+
+// The CPU quota of the cgroup of this process and of its parents, which is usually lower than
+// the number of CPUs of the machine in a container
+std::optional<size_t> cgroup_cpu_limit();
+
+// The memory limit of the cgroup of this process and of its parents
+std::optional<uint64_t> cgroup_memory_limit();
+
+// The resident memory of this process in bytes
+std::optional<uint64_t> resident_memory();
+
+// The hardware concurrency limited by the CPU quota of the cgroup, at least one
+size_t default_thread_count();
+} // namespace util
@@ -3,9 +3,31 @@
 
 #pragma once
 
+#include <expected>
 #include <filesystem>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
 
 namespace util
 {
 bool is_in_directory(const std::filesystem::path& dir, const std::filesystem::path& file);
-}
+
+// The nearest of the directory and its parents that contains a .git entry, which is the root of
+// the git repository the directory is part of
+std::optional<std::filesystem::path> repository_root(const std::filesystem::path& dir);
+
+// Read a list of paths from a file, one per line, skipping blank lines and surrounding
+// whitespace. Relative paths are resolved against base_dir and all of them are normalized.
+std::expected<std::vector<std::filesystem::path>, std::string> read_path_list(
+  const std::filesystem::path& list_path,
+  const std::filesystem::path& base_dir);
+
+// Quote the text as a JSON string
+std::string json_quote(std::string_view text);
+
+// Whether the text matches the pattern, where '*' matches any number of characters and '?' any
+// single character
+bool glob_match(std::string_view pattern, std::string_view text);
+} // namespace util
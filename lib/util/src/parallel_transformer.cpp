@@ -3,22 +3,93 @@
 
 #include <util/parallel_transformer.hpp>
 
-#include <cstdlib>
-#include <functional>
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <memory>
 #include <mutex>
-#include <utility>
+#include <vector>
 
 namespace util
 {
+// The chunks of one transform. The threads keep the batch alive while it is in their queues,
+// they may take it from there after the transform returned and find no chunks left.
+class Parallel_transformer::Batch
+{
+public:
+  Batch(size_t count, size_t chunk_size, Chunk_function chunk_function, void* context)
+  : count_(count),
+    chunk_size_(chunk_size),
+    chunk_function_(chunk_function),
+    context_(context)
+  {
+  }
+
+  // Runs chunks until all of them are claimed
+  void work()
+  {
+    for (;;)
+    {
+      const auto begin = next_.fetch_add(chunk_size_, std::memory_order_relaxed);
+      if (begin >= count_)
+      {
+        return;
+      }
+      const auto end = std::min(begin + chunk_size_, count_);
+      chunk_function_(context_, begin, end);
+      if (done_count_.fetch_add(end - begin, std::memory_order_acq_rel) + (end - begin) == count_)
+      {
+        std::scoped_lock lock(mutex_);
+        done_ = true;
+        cv_.notify_all();
+      }
+    }
+  }
+
+  void wait()
+  {
+    std::unique_lock lock(mutex_);
+    cv_.wait(lock,
+             [this]
+             {
+               return done_;
+             });
+  }
+
+private:
+  const size_t count_;
+  const size_t chunk_size_;
+  const Chunk_function chunk_function_;
+  void* const context_;
+  std::atomic_size_t next_{0U};
+  std::atomic_size_t done_count_{0U};
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  bool done_{false};
+};
+
+struct Parallel_transformer::Worker
+{
+  std::mutex mutex;
+  std::deque<std::shared_ptr<Batch>> batches;
+};
+
 Parallel_transformer::Parallel_transformer(size_t thread_count)
 {
+  workers_.reserve(thread_count);
+  for (size_t i = 0; i < thread_count; ++i)
+  {
+    workers_.push_back(std::make_unique<Worker>());
+  }
   threads_.reserve(thread_count);
   for (size_t i = 0; i < thread_count; ++i)
   {
     threads_.emplace_back(
-      [this]()
+      [this, i]()
       {
-        thread_fun_();
+        thread_fun_(i);
       });
   }
 }
@@ -26,81 +97,105 @@ Parallel_transformer::Parallel_transformer(size_t thread_count)
 Parallel_transformer::~Parallel_transformer()
 {
   shutdown_ = true;
-  cv_.notify_all();
+  wakeups_.release(static_cast<std::ptrdiff_t>(threads_.size()));
   for (auto& thread : threads_)
   {
     thread.join();
   }
 }
 
-void Parallel_transformer::push_work_(std::function<void()> fun)
+size_t Parallel_transformer::chunk_size(size_t count) const
 {
-  std::unique_lock lock(mutex_);
-  cv_.wait(lock,
-           [this]
-           {
-             return sync_ == 0 && queue_.size() < 2 * threads_.size();
-           });
-  queue_.push(std::move(fun));
-  ++queued_count_;
-  lock.unlock();
-  cv_.notify_all();
+  // small enough that the threads finish at about the same time, large enough that cheap
+  // elements do not all meet at the counter
+  constexpr size_t chunks_per_thread = 8;
+  return std::max(count / (std::max(workers_.size(), size_t{1}) * chunks_per_thread), size_t{1});
 }
 
-std::function<void()> Parallel_transformer::pop_work_()
+void Parallel_transformer::run_(size_t count,
+                                size_t chunk_size,
+                                Chunk_function chunk_function,
+                                void* context)
 {
-  std::unique_lock lock(mutex_);
-  cv_.wait(lock,
-           [this]
-           {
-             return shutdown_ || !queue_.empty();
-           });
-
-  if (shutdown_ && queue_.empty())
+  if (count == 0)
   {
-    return nullptr;
+    return;
+  }
+  if (workers_.empty())
+  {
+    chunk_function(context, 0, count);
+    return;
+  }
+
+  const auto worker_count = workers_.size();
+  if (chunk_size == 0)
+  {
+    chunk_size = this->chunk_size(count);
   }
+  const auto chunk_count = (count + chunk_size - 1) / chunk_size;
+  const auto helper_count = std::min(chunk_count, worker_count);
 
-  auto work = queue_.front();
-  queue_.pop();
-  lock.unlock();
-  cv_.notify_all();
+  auto batch = std::make_shared<Batch>(count, chunk_size, chunk_function, context);
+  queued_count_ += helper_count;
+  const auto first_worker = next_worker_.fetch_add(helper_count, std::memory_order_relaxed);
+  for (size_t i = 0; i < helper_count; ++i)
+  {
+    auto& worker = *workers_[(first_worker + i) % worker_count];
+    std::scoped_lock lock(worker.mutex);
+    worker.batches.push_back(batch);
+  }
+  wakeups_.release(static_cast<std::ptrdiff_t>(helper_count));
 
-  return work;
+  batch->wait();
 }
 
-void Parallel_transformer::flush_()
+std::shared_ptr<Parallel_transformer::Batch> Parallel_transformer::take_(size_t index)
 {
-  std::unique_lock lock(mutex_);
-  ++sync_;
-  cv_.wait(lock,
-           [this]
-           {
-             return compleated_count_ == queued_count_;
-           });
-  --sync_;
-  lock.unlock();
-  cv_.notify_all();
+  // saves an idle thread from locking every queue
+  if (queued_count_ == 0)
+  {
+    return nullptr;
+  }
+
+  const auto worker_count = workers_.size();
+  for (size_t offset = 0; offset < worker_count; ++offset)
+  {
+    auto& worker = *workers_[(index + offset) % worker_count];
+    std::scoped_lock lock(worker.mutex);
+    if (!worker.batches.empty())
+    {
+      auto batch = std::move(worker.batches.front());
+      worker.batches.pop_front();
+      --queued_count_;
+      return batch;
+    }
+  }
+  return nullptr;
 }
 
-void Parallel_transformer::thread_fun_()
+void Parallel_transformer::thread_fun_(size_t index)
 {
   for (;;)
   {
-    auto work = pop_work_();
-    if (!work)
+    if (auto batch = take_(index))
     {
-      break;
+      // the thread that found work wakes the next one, rather than the producer waking all
+      if (queued_count_ > 0 && sleeping_count_ > 0)
+      {
+        wakeups_.release();
+      }
+      batch->work();
+      continue;
     }
 
-    work();
-
+    if (shutdown_)
     {
-      std::scoped_lock lock(mutex_);
-      ++compleated_count_;
+      break;
     }
 
-    cv_.notify_all();
+    ++sleeping_count_;
+    wakeups_.acquire();
+    --sleeping_count_;
   }
 }
 
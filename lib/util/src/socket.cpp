@@ -0,0 +1,426 @@
+// Copyright (c) 2025 Environmental Systems Research Institute, Inc.
+// SPDX-License-Identifier: Apache-2.0
+
+#include <util/socket.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cerrno>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <expected>
+#include <filesystem>
+#include <format>
+#include <iterator>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <utility>
+
+#ifndef _WIN32
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+
+namespace util
+{
+#ifndef _WIN32
+namespace
+{
+struct Tcp_address
+{
+  std::string host;
+  std::string port;
+};
+
+// HOST:PORT with a numeric port and no path separator, everything else is a socket path
+std::optional<Tcp_address> parse_tcp_address(std::string_view address)
+{
+  const auto colon = address.rfind(':');
+  if (colon == std::string_view::npos || colon + 1 == address.size() ||
+      address.find('/') != std::string_view::npos)
+  {
+    return std::nullopt;
+  }
+  const auto port = address.substr(colon + 1);
+  if (!std::ranges::all_of(port, [](char c) { return '0' <= c && c <= '9'; }))
+  {
+    return std::nullopt;
+  }
+  return Tcp_address{std::string(address.substr(0, colon)), std::string(port)};
+}
+
+std::expected<sockaddr_un, std::string> make_unix_address(std::string_view socket_path)
+{
+  sockaddr_un address{};
+  address.sun_family = AF_UNIX;
+  if (socket_path.size() >= sizeof(address.sun_path))
+  {
+    return std::unexpected(std::format("error: socket path {} is too long", socket_path));
+  }
+  std::ranges::copy(socket_path, std::begin(address.sun_path));
+  return address;
+}
+
+using Address_info = std::unique_ptr<addrinfo, void (*)(addrinfo*)>;
+
+std::expected<Address_info, std::string> resolve(const Tcp_address& tcp_address, bool passive)
+{
+  addrinfo hints{};
+  hints.ai_family = AF_UNSPEC;
+  hints.ai_socktype = SOCK_STREAM;
+  hints.ai_flags = passive ? AI_PASSIVE : 0;
+  addrinfo* result = nullptr;
+  const char* host = tcp_address.host.empty() ? nullptr : tcp_address.host.c_str();
+  if (const int error = ::getaddrinfo(host, tcp_address.port.c_str(), &hints, &result); error != 0)
+  {
+    return std::unexpected(std::format("error: failed to resolve {}:{}: {}",
+                                       tcp_address.host,
+                                       tcp_address.port,
+                                       ::gai_strerror(error)));
+  }
+  return Address_info(result, ::freeaddrinfo);
+}
+
+std::expected<File_descriptor, std::string> connect_tcp(std::string_view address,
+                                                        const Tcp_address& tcp_address)
+{
+  auto address_info = resolve(tcp_address, false);
+  if (!address_info)
+  {
+    return std::unexpected(address_info.error());
+  }
+
+  int error = 0;
+  for (const auto* info = address_info->get(); info; info = info->ai_next)
+  {
+    File_descriptor fd(
+      ::socket(info->ai_family, info->ai_socktype | SOCK_CLOEXEC, info->ai_protocol));
+    if (fd.get() >= 0 && ::connect(fd.get(), info->ai_addr, info->ai_addrlen) == 0)
+    {
+      // frames are small and answered right away
+      const int no_delay = 1;
+      ::setsockopt(fd.get(), IPPROTO_TCP, TCP_NODELAY, &no_delay, sizeof(no_delay));
+      return fd;
+    }
+    error = errno;
+  }
+  return std::unexpected(
+    std::format("error: failed to connect to {}: {}", address, std::strerror(error)));
+}
+
+std::expected<File_descriptor, std::string> listen_tcp(std::string_view address,
+                                                       const Tcp_address& tcp_address)
+{
+  auto address_info = resolve(tcp_address, true);
+  if (!address_info)
+  {
+    return std::unexpected(address_info.error());
+  }
+
+  int error = 0;
+  for (const auto* info = address_info->get(); info; info = info->ai_next)
+  {
+    File_descriptor fd(
+      ::socket(info->ai_family, info->ai_socktype | SOCK_CLOEXEC, info->ai_protocol));
+    if (fd.get() < 0)
+    {
+      error = errno;
+      continue;
+    }
+    const int reuse = 1;
+    ::setsockopt(fd.get(), SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+    if (::bind(fd.get(), info->ai_addr, info->ai_addrlen) == 0 &&
+        ::listen(fd.get(), SOMAXCONN) == 0)
+    {
+      return fd;
+    }
+    error = errno;
+  }
+  return std::unexpected(
+    std::format("error: failed to listen on {}: {}", address, std::strerror(error)));
+}
+
+std::expected<File_descriptor, std::string> connect_unix(std::string_view socket_path)
+{
+  auto address = make_unix_address(socket_path);
+  if (!address)
+  {
+    return std::unexpected(address.error());
+  }
+
+  File_descriptor fd(::socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0));
+  if (fd.get() < 0)
+  {
+    return std::unexpected(std::format("error: failed to create socket: {}", std::strerror(errno)));
+  }
+  // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+  if (::connect(fd.get(), reinterpret_cast<const sockaddr*>(&*address), sizeof(*address)) != 0)
+  {
+    return std::unexpected(
+      std::format("error: failed to connect to {}: {}", socket_path, std::strerror(errno)));
+  }
+  return fd;
+}
+
+std::expected<File_descriptor, std::string> listen_unix(std::string_view socket_path)
+{
+  auto address = make_unix_address(socket_path);
+  if (!address)
+  {
+    return std::unexpected(address.error());
+  }
+
+  if (std::filesystem::is_socket(socket_path))
+  {
+    if (connect_unix(socket_path).has_value())
+    {
+      return std::unexpected(
+        std::format("error: another process is already listening on {}", socket_path));
+    }
+    // left behind by a process that did not shut down cleanly
+    std::filesystem::remove(socket_path);
+  }
+
+  File_descriptor fd(::socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0));
+  if (fd.get() < 0)
+  {
+    return std::unexpected(std::format("error: failed to create socket: {}", std::strerror(errno)));
+  }
+  // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+  if (::bind(fd.get(), reinterpret_cast<const sockaddr*>(&*address), sizeof(*address)) != 0 ||
+      ::listen(fd.get(), SOMAXCONN) != 0)
+  {
+    return std::unexpected(
+      std::format("error: failed to listen on {}: {}", socket_path, std::strerror(errno)));
+  }
+  return fd;
+}
+
+// Wait until the descriptor is readable, or until the deadline has passed
+bool wait_readable(int fd, std::chrono::steady_clock::time_point deadline)
+{
+  while (true)
+  {
+    const auto remaining = std::chrono::ceil<std::chrono::milliseconds>(
+      deadline - std::chrono::steady_clock::now());
+    if (remaining.count() <= 0)
+    {
+      return false;
+    }
+    pollfd poll_fd{fd, POLLIN, 0};
+    const auto ready = ::poll(&poll_fd, 1, static_cast<int>(remaining.count()));
+    if (ready < 0 && errno == EINTR)
+    {
+      continue;
+    }
+    return ready > 0;
+  }
+}
+
+bool read_exactly(int fd,
+                  char* data,
+                  size_t size,
+                  std::optional<std::chrono::steady_clock::time_point> deadline)
+{
+  while (size > 0)
+  {
+    if (deadline && !wait_readable(fd, *deadline))
+    {
+      return false;
+    }
+    const auto count = ::read(fd, data, size);
+    if (count < 0 && errno == EINTR)
+    {
+      continue;
+    }
+    if (count <= 0)
+    {
+      return false;
+    }
+    data += count; // NOLINT(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+    size -= static_cast<size_t>(count);
+  }
+  return true;
+}
+} // namespace
+
+File_descriptor::~File_descriptor()
+{
+  if (fd_ >= 0)
+  {
+    ::close(fd_);
+  }
+}
+
+std::expected<File_descriptor, std::string> connect_to(std::string_view address)
+{
+  if (auto tcp_address = parse_tcp_address(address))
+  {
+    return connect_tcp(address, *tcp_address);
+  }
+  return connect_unix(address);
+}
+
+std::expected<File_descriptor, std::string> listen_on(std::string_view address)
+{
+  if (auto tcp_address = parse_tcp_address(address))
+  {
+    return listen_tcp(address, *tcp_address);
+  }
+  return listen_unix(address);
+}
+
+std::expected<std::pair<File_descriptor, File_descriptor>, std::string> socket_pair()
+{
+  // a child process started meanwhile must not hold on to the sockets of another one, so they
+  // are closed on exec from the start
+  std::array<int, 2> fds{};
+  if (::socketpair(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0, fds.data()) != 0)
+  {
+    return std::unexpected(
+      std::format("error: failed to create a socket pair: {}", std::strerror(errno)));
+  }
+  return std::pair{File_descriptor(fds[0]), File_descriptor(fds[1])};
+}
+
+bool write_all(int fd, std::string_view data)
+{
+  // a peer that went away must not kill the process with SIGPIPE
+#ifdef MSG_NOSIGNAL
+  constexpr int flags = MSG_NOSIGNAL;
+#else
+  constexpr int flags = 0;
+#endif
+  while (!data.empty())
+  {
+    const auto written = ::send(fd, data.data(), data.size(), flags);
+    if (written < 0 && errno == EINTR)
+    {
+      continue;
+    }
+    if (written <= 0)
+    {
+      return false;
+    }
+    data.remove_prefix(static_cast<size_t>(written));
+  }
+  return true;
+}
+
+std::optional<std::string> read_all(int fd)
+{
+  std::string data;
+  std::array<char, 4096> buffer{};
+  while (true)
+  {
+    const auto count = ::read(fd, buffer.data(), buffer.size());
+    if (count < 0 && errno == EINTR)
+    {
+      continue;
+    }
+    if (count < 0)
+    {
+      return std::nullopt;
+    }
+    if (count == 0)
+    {
+      return data;
+    }
+    data.append(buffer.data(), static_cast<size_t>(count));
+  }
+}
+
+bool write_frame(int fd, std::string_view message)
+{
+  // the size is sent little endian
+  std::array<char, 4> header{};
+  const auto size = static_cast<uint32_t>(message.size());
+  for (size_t i = 0; i < header.size(); ++i)
+  {
+    header[i] = static_cast<char>((size >> (8 * i)) & 0xFFU);
+  }
+  return write_all(fd, std::string_view(header.data(), header.size())) && write_all(fd, message);
+}
+
+std::optional<std::string> read_frame(int fd,
+                                      std::optional<std::chrono::milliseconds> timeout,
+                                      uint32_t max_size)
+{
+  std::optional<std::chrono::steady_clock::time_point> deadline;
+  if (timeout)
+  {
+    deadline = std::chrono::steady_clock::now() + *timeout;
+  }
+
+  std::array<char, 4> header{};
+  if (!read_exactly(fd, header.data(), header.size(), deadline))
+  {
+    return std::nullopt;
+  }
+  uint32_t size = 0;
+  for (size_t i = 0; i < header.size(); ++i)
+  {
+    size |= static_cast<uint32_t>(static_cast<unsigned char>(header[i])) << (8 * i);
+  }
+  if (size > max_size)
+  {
+    return std::nullopt;
+  }
+
+  std::string message(size, '\0');
+  if (!read_exactly(fd, message.data(), message.size(), deadline))
+  {
+    return std::nullopt;
+  }
+  return message;
+}
+#else
+File_descriptor::~File_descriptor() = default;
+
+std::expected<File_descriptor, std::string> connect_to(std::string_view address)
+{
+  return std::unexpected(std::format("error: cannot connect to {} on Windows", address));
+}
+
+std::expected<File_descriptor, std::string> listen_on(std::string_view address)
+{
+  return std::unexpected(std::format("error: cannot listen on {} on Windows", address));
+}
+
+std::expected<std::pair<File_descriptor, File_descriptor>, std::string> socket_pair()
+{
+  return std::unexpected(std::string("error: cannot create a socket pair on Windows"));
+}
+
+bool write_all(int /*fd*/, std::string_view /*data*/)
+{
+  return false;
+}
+
+std::optional<std::string> read_all(int /*fd*/)
+{
+  return std::nullopt;
+}
+
+bool write_frame(int /*fd*/, std::string_view /*message*/)
+{
+  return false;
+}
+
+std::optional<std::string> read_frame(int /*fd*/,
+                                      std::optional<std::chrono::milliseconds> /*timeout*/,
+                                      uint32_t /*max_size*/)
+{
+  return std::nullopt;
+}
+#endif
+} // namespace util
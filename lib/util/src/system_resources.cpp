@@ -0,0 +1,184 @@
+// Copyright (c) 2025 Environmental Systems Research Institute, Inc.
+// SPDX-License-Identifier: Apache-2.0
+
+#include <util/system_resources.hpp>
+
+#include <algorithm>
+#include <charconv>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <ios>
+#include <iterator>
+#include <optional>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <thread>
+
+#ifndef _WIN32
+#include <unistd.h>
+#endif
+
+namespace util
+{
+namespace
+{
+constexpr std::string_view whitespace = " \t\r\n";
+
+std::string_view trim(std::string_view text)
+{
+  const auto first = text.find_first_not_of(whitespace);
+  if (first == std::string_view::npos)
+  {
+    return {};
+  }
+  const auto last = text.find_last_not_of(whitespace);
+  return text.substr(first, last - first + 1);
+}
+
+std::optional<uint64_t> parse_number(std::string_view text)
+{
+  uint64_t value = 0;
+  const auto* end = text.data() + text.size();
+  const auto [ptr, ec] = std::from_chars(text.data(), end, value);
+  if (ec != std::errc() || ptr != end)
+  {
+    return std::nullopt;
+  }
+  return value;
+}
+
+std::optional<std::string> read_file(const std::filesystem::path& path)
+{
+  std::ifstream ifs(path, std::ios::in);
+  if (ifs.fail())
+  {
+    return std::nullopt;
+  }
+  return std::string(std::istreambuf_iterator<char>(ifs), std::istreambuf_iterator<char>());
+}
+
+// Limits are inherited, the effective one is the lowest on the way up to the root
+template <class T>
+std::optional<T> lowest_cgroup_limit(
+  const char* filename,
+  const std::function<std::optional<T>(std::string_view)>& parse)
+{
+  const auto proc_self_cgroup = read_file("/proc/self/cgroup");
+  if (!proc_self_cgroup)
+  {
+    return std::nullopt;
+  }
+  const auto cgroup = parse_proc_self_cgroup(*proc_self_cgroup);
+  if (!cgroup)
+  {
+    return std::nullopt;
+  }
+
+  std::optional<T> lowest;
+  const std::filesystem::path root = "/sys/fs/cgroup";
+  for (auto dir = *cgroup;; dir = dir.parent_path())
+  {
+    if (const auto contents = read_file(root / dir.relative_path() / filename))
+    {
+      if (const auto limit = parse(*contents))
+      {
+        lowest = lowest ? std::min(*lowest, *limit) : *limit;
+      }
+    }
+    if (dir == dir.parent_path())
+    {
+      break;
+    }
+  }
+  return lowest;
+}
+} // namespace
+
+std::optional<size_t> parse_cgroup_cpu_max(std::string_view cpu_max)
+{
+  cpu_max = trim(cpu_max);
+  const auto separator = cpu_max.find(' ');
+  const auto quota = parse_number(cpu_max.substr(0, separator));
+  const auto period =
+    separator == std::string_view::npos ? 100000U : parse_number(cpu_max.substr(separator + 1));
+  if (!quota || !period || *period == 0)
+  {
+    // includes "max", which means no quota
+    return std::nullopt;
+  }
+  return std::max<size_t>((*quota + *period - 1) / *period, 1U);
+}
+
+std::optional<uint64_t> parse_cgroup_memory_max(std::string_view memory_max)
+{
+  return parse_number(trim(memory_max));
+}
+
+std::optional<std::filesystem::path> parse_proc_self_cgroup(std::string_view proc_self_cgroup)
+{
+  // the unified hierarchy is listed as "0::/path", the v1 controllers have other numbers
+  std::istringstream lines{std::string(proc_self_cgroup)};
+  std::string line;
+  while (std::getline(lines, line))
+  {
+    if (line.starts_with("0::"))
+    {
+      return std::filesystem::path(trim(std::string_view(line).substr(3)));
+    }
+  }
+  return std::nullopt;
+}
+
+std::optional<size_t> cgroup_cpu_limit()
+{
+  return lowest_cgroup_limit<size_t>("cpu.max", parse_cgroup_cpu_max);
+}
+
+std::optional<uint64_t> cgroup_memory_limit()
+{
+  return lowest_cgroup_limit<uint64_t>("memory.max", parse_cgroup_memory_max);
+}
+
+std::optional<uint64_t> resident_memory()
+{
+#ifndef _WIN32
+  // the size of the program and the resident set, in pages
+  const auto statm = read_file("/proc/self/statm");
+  if (!statm)
+  {
+    return std::nullopt;
+  }
+  const auto fields = trim(*statm);
+  const auto first = fields.find(' ');
+  if (first == std::string_view::npos)
+  {
+    return std::nullopt;
+  }
+  const auto rest = fields.substr(first + 1);
+  const auto resident_pages = parse_number(rest.substr(0, rest.find(' ')));
+  const auto page_size = ::sysconf(_SC_PAGESIZE);
+  if (!resident_pages || page_size <= 0)
+  {
+    return std::nullopt;
+  }
+  return *resident_pages * static_cast<uint64_t>(page_size);
+#else
+  return std::nullopt;
+#endif
+}
+
+size_t default_thread_count()
+{
+  size_t thread_count = std::max(std::thread::hardware_concurrency(), 1U);
+  if (const auto cpu_limit = cgroup_cpu_limit())
+  {
+    thread_count = std::min(thread_count, *cpu_limit);
+  }
+  return thread_count;
+}
+} // namespace util
@@ -3,7 +3,17 @@
 
 #include <util/utils.hpp>
 
+#include <cstddef>
+#include <expected>
 #include <filesystem>
+#include <format>
+#include <fstream>
+#include <ios>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <vector>
 
 namespace util
 {
@@ -12,4 +22,124 @@ bool is_in_directory(const std::filesystem::path& dir, const std::filesystem::pa
   auto relative_path = file.lexically_relative(dir);
   return !relative_path.empty() && *relative_path.begin() != "..";
 }
+
+std::optional<std::filesystem::path> repository_root(const std::filesystem::path& dir)
+{
+  for (auto current = std::filesystem::absolute(dir).lexically_normal(); !current.empty();
+       current = current.parent_path())
+  {
+    std::error_code error;
+    if (std::filesystem::exists(current / ".git", error))
+    {
+      return current;
+    }
+    if (current == current.root_path())
+    {
+      break;
+    }
+  }
+  return std::nullopt;
+}
+
+std::expected<std::vector<std::filesystem::path>, std::string> read_path_list(
+  const std::filesystem::path& list_path,
+  const std::filesystem::path& base_dir)
+{
+  std::ifstream ifs(list_path, std::ios::in);
+  if (ifs.fail())
+  {
+    return std::unexpected(std::format("failed to open {}", list_path.string()));
+  }
+
+  std::vector<std::filesystem::path> paths;
+  std::string line;
+  while (std::getline(ifs, line))
+  {
+    const auto first = line.find_first_not_of(" \t\r");
+    if (first == std::string::npos)
+    {
+      continue;
+    }
+    const auto last = line.find_last_not_of(" \t\r");
+    paths.emplace_back(
+      (base_dir / line.substr(first, last - first + 1)).lexically_normal().generic_string());
+  }
+  return paths;
+}
+
+std::string json_quote(std::string_view text)
+{
+  std::string quoted;
+  quoted.reserve(text.size() + 2);
+  quoted += '"';
+  for (const char c : text)
+  {
+    switch (c)
+    {
+      case '"':
+        quoted += "\\\"";
+        break;
+      case '\\':
+        quoted += "\\\\";
+        break;
+      case '\n':
+        quoted += "\\n";
+        break;
+      case '\r':
+        quoted += "\\r";
+        break;
+      case '\t':
+        quoted += "\\t";
+        break;
+      default:
+        if (static_cast<unsigned char>(c) < 0x20)
+        {
+          quoted += std::format("\\u{:04x}", static_cast<unsigned int>(c));
+        }
+        else
+        {
+          quoted += c;
+        }
+        break;
+    }
+  }
+  quoted += '"';
+  return quoted;
+}
+
+bool glob_match(std::string_view pattern, std::string_view text)
+{
+  // after a mismatch, let the last '*' match one more character and try again
+  size_t p = 0;
+  size_t t = 0;
+  size_t star = std::string_view::npos;
+  size_t star_text = 0;
+  while (t < text.size())
+  {
+    if (p < pattern.size() && (pattern[p] == '?' || pattern[p] == text[t]))
+    {
+      ++p;
+      ++t;
+    }
+    else if (p < pattern.size() && pattern[p] == '*')
+    {
+      star = p++;
+      star_text = t;
+    }
+    else if (star != std::string_view::npos)
+    {
+      p = star + 1;
+      t = ++star_text;
+    }
+    else
+    {
+      return false;
+    }
+  }
+  while (p < pattern.size() && pattern[p] == '*')
+  {
+    ++p;
+  }
+  return p == pattern.size();
+}
 } // namespace util
@@ -0,0 +1,134 @@
+// Copyright (c) 2025 Environmental Systems Research Institute, Inc.
+// SPDX-License-Identifier: Apache-2.0
+
+#include <util/parallel.hpp>
+
+#include <util/parallel_transformer.hpp>
+
+#include <catch2/catch_message.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <string>
+#include <thread>
+#include <vector>
+
+TEST_CASE("util: parallel_for visits every index", "[util]")
+{
+  constexpr size_t count = 500;
+  util::Parallel_transformer pool(4);
+  std::vector<std::atomic_int> visits(count);
+  util::parallel_for(pool,
+                     count,
+                     [&](size_t i)
+                     {
+                       ++visits[i];
+                     });
+
+  size_t visited_once = 0;
+  for (const auto& visit : visits)
+  {
+    visited_once += visit == 1 ? 1U : 0U;
+  }
+  CHECK(visited_once == count);
+}
+
+TEST_CASE("util: parallel_reduce keeps the order of the chunks", "[util]")
+{
+  util::Parallel_transformer pool(3);
+  for (const size_t chunk_size : {size_t{0}, size_t{1}, size_t{6}})
+  {
+    INFO(chunk_size);
+    const auto digits = util::parallel_reduce(
+      pool,
+      size_t{30},
+      std::string("<"),
+      [](size_t i)
+      {
+        return std::to_string(i % 10);
+      },
+      [](std::string lhs, const std::string& rhs)
+      {
+        return lhs + rhs;
+      },
+      chunk_size);
+    CHECK(digits == "<012345678901234567890123456789");
+  }
+
+  const auto empty = util::parallel_reduce(
+    pool,
+    size_t{0},
+    7,
+    [](size_t)
+    {
+      return 1;
+    },
+    [](int lhs, int rhs)
+    {
+      return lhs + rhs;
+    });
+  CHECK(empty == 7);
+}
+
+TEST_CASE("util: ordered_pipeline delivers the items in order", "[util]")
+{
+  constexpr size_t count = 50;
+  util::Parallel_transformer pool(4);
+  std::vector<int> delivered;
+  std::atomic_size_t in_flight{0};
+  std::atomic_size_t max_seen_in_flight{0};
+  util::ordered_pipeline(
+    pool,
+    count,
+    3,
+    [&](size_t index)
+    {
+      const auto now_in_flight = ++in_flight;
+      auto seen = max_seen_in_flight.load();
+      while (seen < now_in_flight && !max_seen_in_flight.compare_exchange_weak(seen, now_in_flight))
+      {
+      }
+      // the later items finish first
+      std::this_thread::sleep_for(std::chrono::microseconds((count - index) * 20));
+      return static_cast<int>(index);
+    },
+    [](int value)
+    {
+      return value * 2;
+    },
+    [&](int value)
+    {
+      --in_flight;
+      delivered.push_back(value);
+    });
+
+  REQUIRE(delivered.size() == count);
+  for (size_t i = 0; i < count; ++i)
+  {
+    INFO(i);
+    CHECK(delivered[i] == static_cast<int>(i * 2));
+  }
+  // the item being delivered may already have given its slot to the next one
+  CHECK(max_seen_in_flight <= 4);
+}
+
+TEST_CASE("util: ordered_pipeline without threads", "[util]")
+{
+  util::Parallel_transformer pool(0);
+  std::vector<size_t> delivered;
+  util::ordered_pipeline(
+    pool,
+    5,
+    2,
+    [](size_t index)
+    {
+      return index;
+    },
+    [&](size_t index)
+    {
+      delivered.push_back(index);
+    });
+  CHECK(delivered == std::vector<size_t>{0, 1, 2, 3, 4});
+}
@@ -3,14 +3,20 @@
 
 #include <util/parallel_transformer.hpp>
 
+#include <catch2/benchmark/catch_benchmark.hpp>
 #include <catch2/catch_message.hpp>
 #include <catch2/catch_test_macros.hpp>
 
 #include <algorithm>
+#include <atomic>
 #include <chrono>
+#include <cstddef>
+#include <cstdint>
 #include <cstdlib>
+#include <format>
 #include <numeric>
 #include <sstream>
+#include <stop_token>
 #include <thread>
 #include <vector>
 
@@ -83,3 +89,181 @@ TEST_CASE("util: parallel_transformer uses threads", "[util]")
   INFO(os.str());
   REQUIRE(out.size() == thread_count);
 }
+
+TEST_CASE("util: parallel_transformer with a chunk size of one", "[util]")
+{
+  // the first elements take long, like translation units sorted longest first
+  constexpr size_t thread_count = 4;
+  constexpr size_t count = thread_count * 32;
+  std::vector<size_t> v(count);
+  std::ranges::iota(v, size_t{0});
+
+  std::vector<std::thread::id> out(v.size());
+  util::Parallel_transformer transformer(thread_count);
+  transformer.transform(
+    v.begin(),
+    v.end(),
+    out.begin(),
+    [](size_t x)
+    {
+      if (x < thread_count)
+      {
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+      }
+      return std::this_thread::get_id();
+    },
+    1);
+
+  // every thread claims one of them
+  std::vector<std::thread::id> first(out.begin(), out.begin() + thread_count);
+  std::ranges::sort(first);
+  first.erase(std::ranges::unique(first).begin(), first.end());
+  CHECK(first.size() == thread_count);
+}
+
+TEST_CASE("util: parallel_transformer passes a stop token", "[util]")
+{
+  constexpr size_t count = 100;
+  std::vector<int> v(count);
+  std::ranges::iota(v, 0);
+
+  std::vector<int> out(v.size(), 0);
+
+  std::stop_source stop_source;
+  util::Parallel_transformer transformer(3);
+  transformer.transform(v.begin(),
+                        v.end(),
+                        out.begin(),
+                        [&](int x, std::stop_token stop_token)
+                        {
+                          if (stop_token.stop_requested())
+                          {
+                            return -1;
+                          }
+                          if (x == 10)
+                          {
+                            stop_source.request_stop();
+                          }
+                          std::this_thread::sleep_for(std::chrono::milliseconds(1));
+                          return x;
+                        },
+                        stop_source.get_token());
+
+  CHECK(out[10] == 10);
+  CHECK(out.back() == -1);
+  CHECK(std::ranges::count(out, -1) > 50);
+}
+
+TEST_CASE("util: parallel_transformer runs concurrent transforms", "[util]")
+{
+  constexpr size_t count = 1000;
+  std::vector<int> v(count);
+  std::ranges::iota(v, 0);
+
+  util::Parallel_transformer transformer(4);
+  std::vector<std::vector<int>> outs(3, std::vector<int>(v.size(), 0));
+  std::vector<std::thread> callers;
+  for (size_t i = 0; i < outs.size(); ++i)
+  {
+    callers.emplace_back(
+      [&, i]()
+      {
+        transformer.transform(v.begin(),
+                              v.end(),
+                              outs[i].begin(),
+                              [i](int x)
+                              {
+                                return x + static_cast<int>(i);
+                              });
+      });
+  }
+  for (auto& caller : callers)
+  {
+    caller.join();
+  }
+
+  for (size_t i = 0; i < outs.size(); ++i)
+  {
+    INFO(i);
+    CHECK(outs[i].front() == static_cast<int>(i));
+    CHECK(outs[i].back() == static_cast<int>(count - 1 + i));
+  }
+}
+
+TEST_CASE("util: parallel_transformer without threads runs in the caller", "[util]")
+{
+  std::vector<int> v{1, 2, 3};
+  std::vector<std::thread::id> out(v.size());
+
+  util::Parallel_transformer transformer(0);
+  transformer.transform(v.begin(),
+                        v.end(),
+                        out.begin(),
+                        [](int)
+                        {
+                          return std::this_thread::get_id();
+                        });
+
+  CHECK(std::ranges::count(out, std::this_thread::get_id()) == 3);
+}
+
+TEST_CASE("util: parallel_transformer covers every index once", "[util]")
+{
+  constexpr size_t count = 1001;
+  util::Parallel_transformer transformer(5);
+  for (const size_t chunk_size : {size_t{0}, size_t{1}, size_t{7}, count + 1})
+  {
+    INFO(chunk_size);
+    std::vector<std::atomic_int> visits(count);
+    std::atomic_int empty_chunks{0};
+    transformer.for_each_chunk(count,
+                               chunk_size,
+                               [&](size_t begin, size_t end)
+                               {
+                                 if (begin >= end)
+                                 {
+                                   ++empty_chunks;
+                                 }
+                                 for (auto i = begin; i < end; ++i)
+                                 {
+                                   ++visits[i];
+                                 }
+                               });
+    CHECK(std::ranges::all_of(visits,
+                              [](const std::atomic_int& visit)
+                              {
+                                return visit == 1;
+                              }));
+    CHECK(empty_chunks == 0);
+  }
+}
+
+TEST_CASE("util: parallel_transformer scaling", "[!benchmark][.]")
+{
+  // about the cost of classifying the includes of a small translation unit
+  constexpr size_t count = 4096;
+  constexpr uint64_t iterations = 5000;
+  std::vector<uint64_t> v(count);
+  std::ranges::iota(v, uint64_t{0});
+  std::vector<uint64_t> out(v.size());
+
+  for (size_t thread_count = 1; thread_count <= 128; thread_count *= 2)
+  {
+    util::Parallel_transformer transformer(thread_count);
+    BENCHMARK(std::format("{} threads", thread_count))
+    {
+      transformer.transform(v.begin(),
+                            v.end(),
+                            out.begin(),
+                            [](uint64_t x)
+                            {
+                              for (uint64_t i = 0; i < iterations; ++i)
+                              {
+                                x = x * 6364136223846793005U + 1442695040888963407U;
+                              }
+                              return x;
+                            });
+      return out.back();
+    };
+  }
+}
@@ -0,0 +1,52 @@
+// Copyright (c) 2025 Environmental Systems Research Institute, Inc.
+// SPDX-License-Identifier: Apache-2.0
+
+#include <util/socket.hpp>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <chrono>
+#include <string>
+#include <string_view>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#endif
+
+#ifndef _WIN32
+TEST_CASE("util: frames", "[util]")
+{
+  auto sockets = util::socket_pair();
+  REQUIRE(sockets.has_value());
+  const auto& [writer, reader] = *sockets;
+
+  SECTION("the sockets are not inherited by executed programs")
+  {
+    CHECK((::fcntl(writer.get(), F_GETFD) & FD_CLOEXEC) != 0);
+    CHECK((::fcntl(reader.get(), F_GETFD) & FD_CLOEXEC) != 0);
+  }
+
+  SECTION("a frame is read as written")
+  {
+    REQUIRE(util::write_frame(writer.get(), "first"));
+    REQUIRE(util::write_frame(writer.get(), ""));
+    CHECK(util::read_frame(reader.get()) == std::string("first"));
+    CHECK(util::read_frame(reader.get(), std::chrono::milliseconds(1000)) == std::string());
+  }
+
+  SECTION("a frame that does not arrive in time is not read")
+  {
+    CHECK(!util::read_frame(reader.get(), std::chrono::milliseconds(10)));
+
+    // the size without the message
+    REQUIRE(util::write_all(writer.get(), std::string_view("\x05\x00\x00\x00", 4)));
+    CHECK(!util::read_frame(reader.get(), std::chrono::milliseconds(10)));
+  }
+
+  SECTION("a frame larger than the limit is not read")
+  {
+    REQUIRE(util::write_frame(writer.get(), "too large"));
+    CHECK(!util::read_frame(reader.get(), std::nullopt, 4U));
+  }
+}
+#endif
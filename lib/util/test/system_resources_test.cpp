@@ -0,0 +1,52 @@
+// Copyright (c) 2025 Environmental Systems Research Institute, Inc.
+// SPDX-License-Identifier: Apache-2.0
+
+#include <util/system_resources.hpp>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <optional>
+
+TEST_CASE("util: cgroup limits", "[util]")
+{
+  SECTION("cpu.max")
+  {
+    CHECK(util::parse_cgroup_cpu_max("max 100000\n") == std::nullopt);
+    CHECK(util::parse_cgroup_cpu_max("800000 100000\n") == size_t{8});
+    CHECK(util::parse_cgroup_cpu_max("150000 100000") == size_t{2});
+    CHECK(util::parse_cgroup_cpu_max("10000 100000") == size_t{1});
+    CHECK(util::parse_cgroup_cpu_max("200000") == size_t{2});
+    CHECK(util::parse_cgroup_cpu_max("") == std::nullopt);
+  }
+
+  SECTION("memory.max")
+  {
+    CHECK(util::parse_cgroup_memory_max("max\n") == std::nullopt);
+    CHECK(util::parse_cgroup_memory_max("8589934592\n") == uint64_t{8589934592});
+    CHECK(util::parse_cgroup_memory_max("") == std::nullopt);
+  }
+
+  SECTION("/proc/self/cgroup")
+  {
+    CHECK(util::parse_proc_self_cgroup("0::/kubepods/pod1/container\n") ==
+          std::filesystem::path("/kubepods/pod1/container"));
+    CHECK(util::parse_proc_self_cgroup("12:cpu,cpuacct:/docker/1\n0::/\n") ==
+          std::filesystem::path("/"));
+    CHECK(util::parse_proc_self_cgroup("12:cpu,cpuacct:/docker/1\n") == std::nullopt);
+  }
+
+#ifdef __linux__
+  SECTION("the resident memory of this process")
+  {
+    CHECK(util::resident_memory().value_or(0) > 0U);
+  }
+#endif
+
+  SECTION("the default thread count is at least one")
+  {
+    CHECK(util::default_thread_count() >= 1U);
+  }
+}
@@ -5,6 +5,10 @@
 
 #include <catch2/catch_test_macros.hpp>
 
+#include <filesystem>
+#include <fstream>
+#include <vector>
+
 TEST_CASE("util: is_in_directory", "[util]")
 {
   // absolute vs absolute
@@ -62,3 +66,55 @@ TEST_CASE("util: is_in_directory", "[util]")
   CHECK(!util::is_in_directory("a/b/c", "/a/b/q/d/e/file.h"));
 #endif
 }
+
+TEST_CASE("util: json_quote", "[util]")
+{
+  CHECK(util::json_quote("") == R"("")");
+  CHECK(util::json_quote("/a/b.hpp") == R"("/a/b.hpp")");
+  CHECK(util::json_quote(R"(C:\a "b")") == R"("C:\\a \"b\"")");
+  CHECK(util::json_quote("a\nb\tc\x01") == R"("a\nb\tc\u0001")");
+}
+
+TEST_CASE("util: glob_match", "[util]")
+{
+  CHECK(util::glob_match("core", "core"));
+  CHECK_FALSE(util::glob_match("core", "core_io"));
+  CHECK(util::glob_match("core_*", "core_io"));
+  CHECK(util::glob_match("core_*", "core_"));
+  CHECK_FALSE(util::glob_match("core_*", "ui_core_io"));
+  CHECK(util::glob_match("*_test", "core_io_test"));
+  CHECK_FALSE(util::glob_match("*_test", "core_io_tests"));
+  CHECK(util::glob_match("*_*_test", "a_b_test"));
+  CHECK(util::glob_match("lib?", "liba"));
+  CHECK_FALSE(util::glob_match("lib?", "lib"));
+  CHECK(util::glob_match("*", ""));
+  CHECK(util::glob_match("**a*", "bab"));
+  CHECK_FALSE(util::glob_match("", "a"));
+}
+
+TEST_CASE("util: repository_root and read_path_list", "[util]")
+{
+  const auto root = std::filesystem::temp_directory_path() / "lwyi_utils_test_repository";
+  std::filesystem::remove_all(root);
+  std::filesystem::create_directories(root / ".git");
+  std::filesystem::create_directories(root / "src" / "build");
+
+  CHECK(util::repository_root(root / "src" / "build") == root);
+  CHECK(util::repository_root(root) == root);
+
+  const auto list_path = root / "src" / "build" / "changes.txt";
+  {
+    std::ofstream ofs(list_path);
+    ofs << "src/a.cpp\n\n  include/b.hpp \r\n/abs/c.cpp\n";
+  }
+  const auto paths = util::read_path_list(list_path, root);
+  REQUIRE(paths.has_value());
+  CHECK(*paths == std::vector<std::filesystem::path>{
+                    (root / "src/a.cpp").generic_string(),
+                    (root / "include/b.hpp").generic_string(),
+                    "/abs/c.cpp",
+                  });
+
+  CHECK_FALSE(util::read_path_list(root / "missing.txt", root).has_value());
+  std::filesystem::remove_all(root);
+}